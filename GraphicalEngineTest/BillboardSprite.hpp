@@ -0,0 +1,148 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Sprite.hpp"
+#include "Colour.hpp"
+
+
+/// <summary>
+/// A sprite prepared for column renderers, drawn as a camera facing billboard.
+/// Texels are stored column-major, and every column keeps a run-length list of it's opaque texels,
+/// so drawing a column skips the transparent parts without looking at them
+/// </summary>
+class BillboardSprite
+{
+
+public:
+
+    /// <summary>
+    /// A vertical run of opaque texels in a column
+    /// </summary>
+    struct Run
+    {
+        std::uint16_t Start;
+        std::uint16_t Length;
+    };
+
+private:
+
+    int _width = 0;
+    int _height = 0;
+
+    /// <summary>
+    /// Column-major texels, column 'x' starts at x * _height
+    /// </summary>
+    std::vector<Colour> _texels;
+
+    /// <summary>
+    /// The opaque runs of every column, one after the other
+    /// </summary>
+    std::vector<Run> _runs;
+
+    /// <summary>
+    /// Index of the first run of every column in _runs, plus one past the last run
+    /// </summary>
+    std::vector<std::uint32_t> _columnRuns;
+
+
+public:
+
+    /// <summary>
+    /// Create a billboard from a rectangle of a sprite (an atlas)
+    /// </summary>
+    /// <param name="sprite"></param>
+    /// <param name="sourceX"></param>
+    /// <param name="sourceY"></param>
+    /// <param name="sourceWidth"></param>
+    /// <param name="sourceHeight"></param>
+    /// <param name="transparentColour"> Pixels of this colour (ignoring alpha) are not drawn </param>
+    BillboardSprite(const Sprite& sprite,
+                    int sourceX, int sourceY,
+                    int sourceWidth, int sourceHeight,
+                    const Colour& transparentColour) :
+        _width(sourceWidth),
+        _height(sourceHeight)
+    {
+        if ((sourceX < 0) || (sourceY < 0) ||
+            (sourceWidth <= 0) || (sourceHeight <= 0) ||
+            (sourceHeight > UINT16_MAX) ||
+            (sourceX + sourceWidth > sprite.Width) ||
+            (sourceY + sourceHeight > sprite.Height))
+        {
+            throw std::exception("Billboard rectangle is outside the sprite");
+        };
+
+        _texels.resize(static_cast<std::size_t>(_width) * _height);
+        _columnRuns.reserve(static_cast<std::size_t>(_width) + 1);
+
+        for (int x = 0; x < _width; x++)
+        {
+            _columnRuns.push_back(static_cast<std::uint32_t>(_runs.size()));
+
+            Colour* column = _texels.data() + static_cast<std::size_t>(x) * _height;
+
+            int runStart = -1;
+
+            for (int y = 0; y < _height; y++)
+            {
+                Colour texel = sprite.GetPixel(sourceX + x, sourceY + y);
+                column[y] = texel;
+
+                const bool opaque = (texel.CompareNonAlpha(transparentColour) == false);
+
+                if ((opaque == true) && (runStart == -1))
+                    runStart = y;
+                else if ((opaque == false) && (runStart != -1))
+                {
+                    _runs.push_back({ static_cast<std::uint16_t>(runStart), static_cast<std::uint16_t>(y - runStart) });
+                    runStart = -1;
+                };
+            };
+
+            if (runStart != -1)
+                _runs.push_back({ static_cast<std::uint16_t>(runStart), static_cast<std::uint16_t>(_height - runStart) });
+        };
+
+        _columnRuns.push_back(static_cast<std::uint32_t>(_runs.size()));
+    };
+
+
+public:
+
+    int GetWidth() const
+    {
+        return _width;
+    };
+
+    int GetHeight() const
+    {
+        return _height;
+    };
+
+    /// <summary>
+    /// Get the texels of a column, GetHeight() texels long
+    /// </summary>
+    /// <param name="column"></param>
+    /// <returns></returns>
+    const Colour* GetColumn(int column) const
+    {
+        return _texels.data() + static_cast<std::size_t>(column) * _height;
+    };
+
+    /// <summary>
+    /// Get the first opaque run of a column, the column's runs end at GetColumnRunsEnd
+    /// </summary>
+    /// <param name="column"></param>
+    /// <returns></returns>
+    const Run* GetColumnRunsBegin(int column) const
+    {
+        return _runs.data() + _columnRuns[column];
+    };
+
+    const Run* GetColumnRunsEnd(int column) const
+    {
+        return _runs.data() + _columnRuns[static_cast<std::size_t>(column) + 1];
+    };
+
+};
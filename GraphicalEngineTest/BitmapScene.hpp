@@ -61,7 +61,7 @@ public:
 
     virtual void UpdateScene(float deltaTime) override
     {
-        Mouse mouse = _window.GetMouse();
+        const Mouse& mouse = _window.GetMouse();
         const Keyboard& keyboard = _window.GetKeyboard();
 
         if (mouse.LeftMouseButton == KeyState::Held)
@@ -3,6 +3,7 @@
 #include <Graphics.hpp>
 #include "Mouse.hpp"
 #include "Colour.hpp"
+#include "ImageBuffer.hpp"
 
 
 /// <summary>
@@ -47,9 +48,9 @@ private:
 
 
     /// <summary>
-    /// A pixel array that will be used to draw the button
+    /// A pixel buffer that will be used to draw the button
     /// </summary>
-    Colour* _buttonPixels;
+    ImageBuffer _buttonPixels;
 
 
     /// <summary>
@@ -80,31 +81,24 @@ public:
         _buttonHeight(height),
 
         _buttonX(x),
-        _buttonY(y)
-    {
-
-        _buttonPixels = new Colour[_buttonWidth * _buttonHeight] { 0 };
+        _buttonY(y),
 
+        _buttonPixels(static_cast<int>(width), static_cast<int>(height))
+    {
         // Draw a white background
-        memset(_buttonPixels, 255, sizeof(Colour) * (_buttonWidth * _buttonHeight));
+        _buttonPixels.Fill(Colours::White);
 
         // Draw the black borders around the button
-        for (int x = 0; x < _buttonWidth; x++)
+        for (int x = 0; x < _buttonPixels.GetWidth(); x++)
         {
-            const std::size_t index = Maths::Convert2DTo1D(x, 0, _buttonWidth);
-            const std::size_t indexLast = Maths::Convert2DTo1D(x, _buttonHeight - 1, _buttonWidth);
-
-            _buttonPixels[index] = Colours::Black;
-            _buttonPixels[indexLast] = Colours::Black;
+            _buttonPixels.GetPixel(x, 0) = Colours::Black;
+            _buttonPixels.GetPixel(x, _buttonPixels.GetHeight() - 1) = Colours::Black;
         };
 
-        for (int y = 0; y < _buttonHeight; y++)
+        for (int y = 0; y < _buttonPixels.GetHeight(); y++)
         {
-            const std::uint64_t index = Maths::Convert2DTo1D(0, y, _buttonWidth);
-            const std::uint64_t indexLast = Maths::Convert2DTo1D(_buttonWidth - 1, y, _buttonWidth);
-
-            _buttonPixels[index] = Colours::Black;
-            _buttonPixels[indexLast] = Colours::Black;
+            _buttonPixels.GetPixel(0, y) = Colours::Black;
+            _buttonPixels.GetPixel(_buttonPixels.GetWidth() - 1, y) = Colours::Black;
         };
 
     };
@@ -182,13 +176,11 @@ public:
     void Draw(Graphics& graphics)
     {
         // Copy button pixels onto the screen buffer
-        for (int x = 0; x < _buttonWidth; x++)
+        for (int x = 0; x < _buttonPixels.GetWidth(); x++)
         {
-            for (int y = 0; y < _buttonHeight; y++)
+            for (int y = 0; y < _buttonPixels.GetHeight(); y++)
             {
-                const std::size_t index = Maths::Convert2DTo1D(x, y, _buttonWidth);
-
-                graphics.DrawPixel(x + _buttonX, y + _buttonY, _buttonPixels[index]);
+                graphics.DrawPixel(x + _buttonX, y + _buttonY, _buttonPixels.GetPixel(x, y));
             };
         };
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <string_view>
 
 #include "Sprite.hpp"
 #include "Vector2D.hpp"
@@ -70,7 +71,7 @@ public:
     };
 
 
-    void DrawString(const Vector2D& position, const std::string& text, float scale = 1.0f)
+    void DrawString(const Vector2D& position, std::string_view text, float scale = 1.0f)
     {
         DrawString(position.X, position.Y, text, scale, scale);
     };
@@ -81,7 +82,7 @@ public:
     /// <param name="x"></param>
     /// <param name="y"></param>
     /// <param name="text"> The text to draw </param>
-    void DrawString(int x, int y, const std::string& text)
+    void DrawString(int x, int y, std::string_view text)
     {
         // Starting X position used when going down a line to restore original position
         int startingX = x;
@@ -126,7 +127,7 @@ public:
     /// <param name="y"></param>
     /// <param name="text"> The text to draw </param>
     void DrawString(int x, int y,
-                    const std::string& text,
+                    std::string_view text,
                     float horizontalScale, float verticalScale)
     {
         // Don't bother scaling if bitmap is too smol to see
@@ -0,0 +1,351 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <new>
+
+
+/// <summary>
+/// Debug counters for global heap allocations.
+/// The counters are incremented by the global operator new replacement (see main.cpp, debug builds only)
+/// </summary>
+namespace HeapAllocationCounter
+{
+    /// <summary>
+    /// Total number of global heap allocations since startup
+    /// </summary>
+    inline std::atomic<std::size_t> Allocations = 0;
+
+    /// <summary>
+    /// Allocation count captured at the beggining of the current frame
+    /// </summary>
+    inline std::size_t FrameBeginAllocations = 0;
+
+
+    /// <summary>
+    /// Mark the beggining of a frame
+    /// </summary>
+    inline void BeginFrame()
+    {
+        FrameBeginAllocations = Allocations.load(std::memory_order_relaxed);
+    };
+
+    /// <summary>
+    /// Get the number of global heap allocations made since BeginFrame was called
+    /// </summary>
+    /// <returns></returns>
+    inline std::size_t GetFrameAllocations()
+    {
+        return Allocations.load(std::memory_order_relaxed) - FrameBeginAllocations;
+    };
+};
+
+
+
+/// <summary>
+/// A linear (bump) allocator.
+/// Allocations are a pointer increment, individual frees are ignored and everything is released at once by Reset()
+/// </summary>
+class LinearArena
+{
+
+private:
+
+    /// <summary>
+    /// The arena's backing memory
+    /// </summary>
+    std::unique_ptr<std::byte[]> _memory;
+
+    /// <summary>
+    /// Size of the backing memory in bytes
+    /// </summary>
+    std::size_t _capacity = 0;
+
+    /// <summary>
+    /// Offset to the next free byte
+    /// </summary>
+    std::size_t _offset = 0;
+
+    /// <summary>
+    /// The largest offset reached since the arena was created, useful for sizing the arena
+    /// </summary>
+    std::size_t _highWaterMark = 0;
+
+
+public:
+
+    LinearArena(std::size_t capacity = 0) :
+        _memory(capacity > 0 ? std::make_unique<std::byte[]>(capacity) : nullptr),
+        _capacity(capacity)
+    {
+    };
+
+    LinearArena(LinearArena&&) = default;
+    LinearArena& operator = (LinearArena&&) = default;
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator = (const LinearArena&) = delete;
+
+
+public:
+
+    /// <summary>
+    /// Allocate a block of memory from the arena
+    /// </summary>
+    /// <param name="size"> Size in bytes </param>
+    /// <param name="alignment"> Required alignment, must be a power of 2 </param>
+    /// <returns></returns>
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        void* memory = TryAllocate(size, alignment);
+
+        if (memory == nullptr)
+        {
+            throw std::bad_alloc();
+        };
+
+        return memory;
+    };
+
+    /// <summary>
+    /// Allocate a block of memory from the arena, without throwing if it doesn't fit.
+    /// Used by worker threads, which must not throw
+    /// </summary>
+    /// <param name="size"> Size in bytes </param>
+    /// <param name="alignment"> Required alignment, must be a power of 2 </param>
+    /// <returns> Null if the arena is full </returns>
+    void* TryAllocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(_memory.get());
+
+        // Round the current position up to the requested alignment
+        const std::uintptr_t alignedAddress = (base + _offset + (alignment - 1)) & ~static_cast<std::uintptr_t>(alignment - 1);
+        const std::size_t alignedOffset = static_cast<std::size_t>(alignedAddress - base);
+
+        if ((alignedOffset > _capacity) || (size > _capacity - alignedOffset))
+            return nullptr;
+
+        _offset = alignedOffset + size;
+
+        if (_offset > _highWaterMark)
+            _highWaterMark = _offset;
+
+        return reinterpret_cast<void*>(alignedAddress);
+    };
+
+    /// <summary>
+    /// Allocate an uninitialized array of T
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    /// <param name="count"></param>
+    /// <returns></returns>
+    template<class T>
+    T* AllocateArray(std::size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    };
+
+    /// <summary>
+    /// Allocate an uninitialized array of T, without throwing if it doesn't fit
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    /// <param name="count"></param>
+    /// <returns> Null if the arena is full </returns>
+    template<class T>
+    T* TryAllocateArray(std::size_t count) noexcept
+    {
+        return static_cast<T*>(TryAllocate(sizeof(T) * count, alignof(T)));
+    };
+
+
+    /// <summary>
+    /// Release every allocation made from this arena
+    /// </summary>
+    void Reset()
+    {
+        _offset = 0;
+    };
+
+
+    std::size_t GetUsedBytes() const
+    {
+        return _offset;
+    };
+
+    std::size_t GetCapacity() const
+    {
+        return _capacity;
+    };
+
+    std::size_t GetHighWaterMark() const
+    {
+        return _highWaterMark;
+    };
+
+};
+
+
+
+/// <summary>
+/// An STL compatible allocator that allocates from a LinearArena.
+/// Deallocation does nothing, the memory is reclaimed when the arena is reset
+/// </summary>
+/// <typeparam name="T"></typeparam>
+template<class T>
+class ArenaAllocator
+{
+    template<class U>
+    friend class ArenaAllocator;
+
+public:
+
+    using value_type = T;
+
+private:
+
+    LinearArena* _arena;
+
+public:
+
+    ArenaAllocator(LinearArena& arena) noexcept :
+        _arena(&arena)
+    {
+    };
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept :
+        _arena(other._arena)
+    {
+    };
+
+public:
+
+    T* allocate(std::size_t count)
+    {
+        return _arena->AllocateArray<T>(count);
+    };
+
+    void deallocate(T*, std::size_t) noexcept
+    {
+    };
+
+
+    template<class U>
+    bool operator == (const ArenaAllocator<U>& other) const noexcept
+    {
+        return _arena == other._arena;
+    };
+
+    template<class U>
+    bool operator != (const ArenaAllocator<U>& other) const noexcept
+    {
+        return _arena != other._arena;
+    };
+
+};
+
+
+/// <summary>
+/// A vector whose storage lives in a LinearArena
+/// </summary>
+template<class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/// <summary>
+/// A string whose storage lives in a LinearArena
+/// </summary>
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+
+
+/// <summary>
+/// Memory for transient data that only lives for a single frame.
+/// Owns a main arena for the render thread and a sub-arena per worker thread, all of them are reset together at the start of every frame
+/// </summary>
+class FrameArena
+{
+
+private:
+
+    /// <summary>
+    /// The arena used by the main (render) thread
+    /// </summary>
+    LinearArena _mainArena;
+
+    /// <summary>
+    /// One arena per worker thread, so workers never contend on the same bump pointer
+    /// </summary>
+    std::vector<LinearArena> _threadArenas;
+
+
+public:
+
+    /// <summary>
+    /// </summary>
+    /// <param name="mainCapacity"> Size in bytes of the main thread's arena </param>
+    /// <param name="threadCount"> Number of worker sub-arenas </param>
+    /// <param name="threadCapacity"> Size in bytes of every worker sub-arena </param>
+    FrameArena(std::size_t mainCapacity, std::size_t threadCount, std::size_t threadCapacity) :
+        _mainArena(mainCapacity)
+    {
+        _threadArenas.reserve(threadCount);
+
+        for (std::size_t a = 0; a < threadCount; a++)
+            _threadArenas.emplace_back(threadCapacity);
+    };
+
+
+public:
+
+    /// <summary>
+    /// Release every frame allocation. Must not be called while workers are still using their arenas
+    /// </summary>
+    void Reset()
+    {
+        _mainArena.Reset();
+
+        for (LinearArena& threadArena : _threadArenas)
+            threadArena.Reset();
+    };
+
+
+    /// <summary>
+    /// Get the main thread's arena
+    /// </summary>
+    /// <returns></returns>
+    LinearArena& GetArena()
+    {
+        return _mainArena;
+    };
+
+    /// <summary>
+    /// Get a worker's private arena
+    /// </summary>
+    /// <param name="threadIndex"> Index of the worker, in the range [0, GetThreadCount()) </param>
+    /// <returns></returns>
+    LinearArena& GetThreadArena(std::size_t threadIndex)
+    {
+        return _threadArenas[threadIndex];
+    };
+
+    std::size_t GetThreadCount() const
+    {
+        return _threadArenas.size();
+    };
+
+
+    /// <summary>
+    /// Shorthand for creating an STL allocator on the main arena
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    /// <returns></returns>
+    template<class T>
+    ArenaAllocator<T> GetAllocator()
+    {
+        return ArenaAllocator<T>(_mainArena);
+    };
+
+};
@@ -48,6 +48,11 @@ private:
 
     FontSheet _font;
 
+    /// <summary>
+    /// Converts mouse positions to graph positions, kept as a member so it isn't re-created every update
+    /// </summary>
+    VectorTransformer _vectorTransformer;
+
     Vector2D _graphPosition = { 20, (_window.GetWindowHeight() - 20) };
 
     int _pointWidth = 4;
@@ -66,7 +71,9 @@ public:
         _graphics(graphics),
         _window(window),
 
-        _font(graphics, 16, 28)
+        _font(graphics, 16, 28),
+
+        _vectorTransformer(window)
     {
         // Generate random number of points
         std::srand(static_cast<int>(std::time(0)));
@@ -99,7 +106,7 @@ public:
 
 
         if (_window.GetMouse().LeftMouseButton == KeyState::Held)
-            _graphPosition = VectorTransformer(_window).MouseToVector(_window.GetMouse());
+            _graphPosition = _vectorTransformer.MouseToVector(_window.GetMouse());
     };
 
 
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Graphics.hpp"
+#include "ImageBuffer.hpp"
+
+
+/// <summary>
+/// An offscreen image for content that rarely changes.
+/// The layer is only redrawn after it was invalidated, every other frame it is just copied onto the frame a row at a time,
+/// and the parts that do change are drawn over it
+/// </summary>
+class CachedLayer
+{
+
+private:
+
+    ImageBuffer _image;
+
+    /// <summary>
+    /// False if the image has to be redrawn before it's used
+    /// </summary>
+    bool _valid = false;
+
+
+public:
+
+    CachedLayer() = default;
+
+    CachedLayer(int width, int height) :
+        _image(width, height)
+    {
+    };
+
+
+public:
+
+    /// <summary>
+    /// Change the layer's size, the layer is invalidated if the size is different
+    /// </summary>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    void Resize(int width, int height)
+    {
+        if ((_image.GetWidth() == width) && (_image.GetHeight() == height))
+            return;
+
+        _image = ImageBuffer(width, height);
+        _valid = false;
+    };
+
+
+    /// <summary>
+    /// Mark the layer's content as outdated, it will be redrawn by the next Update
+    /// </summary>
+    void Invalidate()
+    {
+        _valid = false;
+    };
+
+    bool IsValid() const
+    {
+        return _valid;
+    };
+
+
+    /// <summary>
+    /// Redraw the layer if it's invalid
+    /// </summary>
+    /// <typeparam name="TRender"> Callable with the signature void(ImageBuffer& image), must draw the entire image </typeparam>
+    /// <param name="render"></param>
+    template<class TRender>
+    void Update(TRender&& render)
+    {
+        if (_valid == true)
+            return;
+
+        render(_image);
+        _valid = true;
+    };
+
+
+    /// <summary>
+    /// Copy the layer onto the frame
+    /// </summary>
+    /// <param name="graphics"></param>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    void Draw(Graphics& graphics, int x, int y) const
+    {
+        graphics.DrawImage(_image, x, y);
+    };
+
+
+    const ImageBuffer& GetImage() const
+    {
+        return _image;
+    };
+
+};
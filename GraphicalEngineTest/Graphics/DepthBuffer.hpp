@@ -0,0 +1,171 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+
+/// <summary>
+/// A 32 bit float depth buffer the size of the frame.
+/// Every pixel stores the 1/W of the nearest triangle drawn over it, larger values are closer and 0 is infinitely far.
+/// 1/W changes linearly across the screen, so it's interpolated exactly and has the most precision close to the camera.
+/// The buffer is split into 8x8 blocks that also keep their nearest and farthest depth,
+/// so a triangle can be rejected from a whole block, or skip the per-pixel test, by comparing against 2 values
+/// </summary>
+class DepthBuffer
+{
+
+public:
+
+    static constexpr int BLOCK_SIZE = 8;
+
+
+private:
+
+    /// <summary>
+    /// The pixels' depths, rows are padded to whole blocks
+    /// </summary>
+    std::vector<float> _depths;
+
+    /// <summary>
+    /// The largest and smallest depth of every block's pixels that are inside the frame
+    /// </summary>
+    std::vector<float> _blockNearest;
+    std::vector<float> _blockFarthest;
+
+    int _width = 0;
+    int _height = 0;
+
+    int _blockColumns = 0;
+    int _blockRows = 0;
+
+
+public:
+
+    DepthBuffer() = default;
+
+    /// <summary>
+    /// Create a cleared buffer
+    /// </summary>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    DepthBuffer(int width, int height) :
+        _width(width),
+        _height(height),
+        _blockColumns((width + BLOCK_SIZE - 1) / BLOCK_SIZE),
+        _blockRows((height + BLOCK_SIZE - 1) / BLOCK_SIZE)
+    {
+        const std::size_t blockCount = static_cast<std::size_t>(_blockColumns) * _blockRows;
+
+        _depths.resize(blockCount * BLOCK_SIZE * BLOCK_SIZE);
+        _blockNearest.resize(blockCount);
+        _blockFarthest.resize(blockCount);
+
+        Clear();
+    };
+
+
+public:
+
+    /// <summary>
+    /// Set every pixel to infinitely far
+    /// </summary>
+    void Clear()
+    {
+        if (_depths.empty() == true)
+            return;
+
+        // 0.0f is all zero bits
+        std::memset(_depths.data(), 0, _depths.size() * sizeof(float));
+        std::memset(_blockNearest.data(), 0, _blockNearest.size() * sizeof(float));
+        std::memset(_blockFarthest.data(), 0, _blockFarthest.size() * sizeof(float));
+    };
+
+
+    /// <summary>
+    /// Recalculate a block's nearest and farthest depth after some of it's pixels were written
+    /// </summary>
+    /// <param name="blockColumn"></param>
+    /// <param name="blockRow"></param>
+    void UpdateBlock(int blockColumn, int blockRow)
+    {
+        const int firstX = blockColumn * BLOCK_SIZE;
+        const int firstY = blockRow * BLOCK_SIZE;
+
+        // Padding pixels are never drawn, they would keep the farthest depth at 0
+        const int columns = (std::min)(BLOCK_SIZE, _width - firstX);
+        const int rows = (std::min)(BLOCK_SIZE, _height - firstY);
+
+        float nearest = GetRow(firstY)[firstX];
+        float farthest = nearest;
+
+        for (int y = 0; y < rows; y++)
+        {
+            const float* row = GetRow(firstY + y) + firstX;
+
+            for (int x = 0; x < columns; x++)
+            {
+                nearest = (std::max)(nearest, row[x]);
+                farthest = (std::min)(farthest, row[x]);
+            };
+        };
+
+        const std::size_t index = static_cast<std::size_t>(blockRow) * _blockColumns + blockColumn;
+
+        _blockNearest[index] = nearest;
+        _blockFarthest[index] = farthest;
+    };
+
+
+public:
+
+    float* GetRow(int y)
+    {
+        return _depths.data() + static_cast<std::size_t>(y) * GetPitch();
+    };
+
+    const float* GetRow(int y) const
+    {
+        return _depths.data() + static_cast<std::size_t>(y) * GetPitch();
+    };
+
+    float GetDepth(int x, int y) const
+    {
+        return GetRow(y)[x];
+    };
+
+    float GetBlockNearest(int blockColumn, int blockRow) const
+    {
+        return _blockNearest[static_cast<std::size_t>(blockRow) * _blockColumns + blockColumn];
+    };
+
+    float GetBlockFarthest(int blockColumn, int blockRow) const
+    {
+        return _blockFarthest[static_cast<std::size_t>(blockRow) * _blockColumns + blockColumn];
+    };
+
+    /// <summary>
+    /// Get the distance between 2 rows, in pixels
+    /// </summary>
+    /// <returns></returns>
+    std::size_t GetPitch() const
+    {
+        return static_cast<std::size_t>(_blockColumns) * BLOCK_SIZE;
+    };
+
+    int GetWidth() const
+    {
+        return _width;
+    };
+
+    int GetHeight() const
+    {
+        return _height;
+    };
+
+    bool IsEmpty() const
+    {
+        return _depths.empty();
+    };
+
+};
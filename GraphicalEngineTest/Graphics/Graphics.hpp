@@ -2,10 +2,22 @@
 #include <d3d11.h>
 #include <wrl/client.h>
 #include <d3dcompiler.h>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <emmintrin.h>
 
 #include "WindowsUtilities.hpp"
 #include "Colour.hpp"
 #include "Vertex.hpp"
+#include "FrameArena.hpp"
+#include "WorkerPool.hpp"
+#include "ImageBuffer.hpp"
+#include "DepthBuffer.hpp"
+#include "Mesh.hpp"
+#include "Matrix3x2.hpp"
 
 #pragma comment(lib, "DXGI.lib")
 #pragma comment(lib, "d3d11.lib")
@@ -49,19 +61,295 @@ private:
 
     D3D11_MAPPED_SUBRESOURCE _d3dMappedSubResource = { 0 };
 
+    /// <summary>
+    /// A vertex snapped to 28.4 fixed point, 4 bits of the coordinates are below the pixel
+    /// </summary>
+    struct FixedPointVertex
+    {
+        std::int32_t X;
+        std::int32_t Y;
+    };
+
+    /// <summary>
+    /// The number of fraction bits of a snapped vertex coordinate
+    /// </summary>
+    static constexpr int SUBPIXEL_BITS = 4;
+    static constexpr int SUBPIXEL_SCALE = 1 << SUBPIXEL_BITS;
+
+    /// <summary>
+    /// The guard band, triangles with a vertex further than this many pixels from the frame's origin are clipped to it.
+    /// Keeps the edge values that are stepped per pixel within 32 bits
+    /// </summary>
+    static constexpr float TRIANGLE_COORDINATE_LIMIT = 16384.0f;
+
+    /// <summary>
+    /// A triangle edge's half-space function, positive on the triangle's side of the edge.
+    /// Evaluated exactly with integers, at pixel centres, in 1/256 pixel units
+    /// </summary>
+    struct TriangleEdge
+    {
+        /// <summary>
+        /// The change of the function per 1/16 pixel along x and along y
+        /// </summary>
+        std::int64_t StepX;
+        std::int64_t StepY;
+
+        /// <summary>
+        /// The function's constant, including the fill rule's bias
+        /// </summary>
+        std::int64_t Constant;
+
+        TriangleEdge(const FixedPointVertex& from, const FixedPointVertex& to) :
+            StepX(static_cast<std::int64_t>(from.Y) - to.Y),
+            StepY(static_cast<std::int64_t>(to.X) - from.X),
+            Constant(static_cast<std::int64_t>(from.X) * to.Y - static_cast<std::int64_t>(from.Y) * to.X)
+        {
+            // With y pointing down and the inside on the right of the edge,
+            // a top edge is horizontal and goes right, and a left edge goes up.
+            // Pixel centres exactly on any other edge are outside, the values are integers so that is the same as being 1 lower
+            const bool topLeft = ((to.Y == from.Y) && (to.X > from.X)) || (to.Y < from.Y);
+
+            if (topLeft == false)
+                Constant -= 1;
+        };
+
+        /// <summary>
+        /// Evaluate the function at a pixel's centre, the pixel is inside the edge if the value isn't negative
+        /// </summary>
+        /// <param name="x"></param>
+        /// <param name="y"></param>
+        /// <returns></returns>
+        std::int64_t Evaluate(int x, int y) const
+        {
+            return StepX * (static_cast<std::int64_t>(x) * SUBPIXEL_SCALE + SUBPIXEL_SCALE / 2) +
+                   StepY * (static_cast<std::int64_t>(y) * SUBPIXEL_SCALE + SUBPIXEL_SCALE / 2) +
+                   Constant;
+        };
+    };
+
+    /// <summary>
+    /// The width and height of the pixel blocks FillTriangle tests at once
+    /// </summary>
+    static constexpr int TRIANGLE_BLOCK_SIZE = 8;
+
+    /// <summary>
+    /// The pixels of the frame a triangle can cover, inclusive
+    /// </summary>
+    struct TriangleBounds
+    {
+        int MinX;
+        int MinY;
+        int MaxX;
+        int MaxY;
+    };
+
+    /// <summary>
+    /// How much of a block a triangle covers
+    /// </summary>
+    enum class TriangleBlockCoverage
+    {
+        Outside,
+        Partial,
+        Full,
+    };
+
+    /// <summary>
+    /// A triangle's edges rebased to a single block, in 32 bit lanes.
+    /// An edge that crosses the block can't be further than the block's size from any of it's pixels, so it's values there fit.
+    /// Edges that contain the whole block are replaced with a constant 0, which is inside
+    /// </summary>
+    struct TriangleBlockEdges
+    {
+        /// <summary>
+        /// Each edge's value at the block's first pixel, and it's step per row
+        /// </summary>
+        std::int32_t FirstValues[3];
+        std::int32_t StepsY[3];
+
+        /// <summary>
+        /// The values of the block's left and right 4 pixels, relative to the row's first pixel
+        /// </summary>
+        __m128i LeftOffsets[3];
+        __m128i RightOffsets[3];
+    };
+
+    /// <summary>
+    /// The number of values DrawShadedMesh interpolates: 1/W, then red, green, blue, alpha, u and v, all divided by W.
+    /// Divided by W they change linearly across the screen, dividing by the interpolated 1/W gives back the perspective correct value
+    /// </summary>
+    static constexpr int SHADED_ATTRIBUTE_COUNT = 7;
+
+    struct ShadedVertex
+    {
+        float Values[SHADED_ATTRIBUTE_COUNT];
+    };
+
+    /// <summary>
+    /// An interpolated value's plane over the screen, relative to a triangle's first vertex
+    /// </summary>
+    struct AttributePlane
+    {
+        float Value;
+        float StepX;
+        float StepY;
+    };
+
+    /// <summary>
+    /// Outcode bits, the planes a vertex is outside of.
+    /// A triangle whose 3 vertices are all outside the same side of the scissor, or the same W plane, is rejected without clipping.
+    /// The side bits are only set for vertices in front of the near plane
+    /// </summary>
+    static constexpr std::uint8_t CLIP_LEFT = 1 << 0;
+    static constexpr std::uint8_t CLIP_RIGHT = 1 << 1;
+    static constexpr std::uint8_t CLIP_TOP = 1 << 2;
+    static constexpr std::uint8_t CLIP_BOTTOM = 1 << 3;
+    static constexpr std::uint8_t CLIP_NEAR = 1 << 4;
+    static constexpr std::uint8_t CLIP_FAR = 1 << 5;
+
+    /// <summary>
+    /// Beyond TRIANGLE_COORDINATE_LIMIT, the triangle is clipped to the guard band before it's snapped
+    /// </summary>
+    static constexpr std::uint8_t CLIP_GUARD_BAND = 1 << 6;
+
+    /// <summary>
+    /// NaN or infinite, the triangle isn't drawn
+    /// </summary>
+    static constexpr std::uint8_t CLIP_INVALID = 1 << 7;
+
+    static constexpr std::uint8_t CLIP_REJECT_MASK = CLIP_LEFT | CLIP_RIGHT | CLIP_TOP | CLIP_BOTTOM | CLIP_NEAR | CLIP_FAR;
+    static constexpr std::uint8_t CLIP_PLANES_MASK = CLIP_NEAR | CLIP_FAR | CLIP_GUARD_BAND;
+
+    /// <summary>
+    /// A polygon vertex while it's clipped, before the divide by W.
+    /// The attributes are the ShadedVertex values after 1/W, not yet divided
+    /// </summary>
+    struct ClipVertex
+    {
+        float X;
+        float Y;
+        float W;
+
+        float Attributes[SHADED_ATTRIBUTE_COUNT - 1];
+    };
+
+    /// <summary>
+    /// A triangle clipped by the near, far and 4 guard band planes, each plane can add 1 vertex
+    /// </summary>
+    static constexpr int MAX_CLIPPED_VERTICES = 3 + 6;
+
+    /// <summary>
+    /// A mesh's vertices in screen space, see TransformMeshVertices
+    /// </summary>
+    struct MeshScreenVertices
+    {
+        float* X;
+        float* Y;
+
+        /// <summary>
+        /// Only set for vertices without the CLIP_GUARD_BAND or CLIP_INVALID bits
+        /// </summary>
+        FixedPointVertex* Snapped;
+
+        std::uint8_t* Outcodes;
+    };
+
+    /// <summary>
+    /// The width and height of the screen tiles DrawMeshParallel bins triangles into.
+    /// A multiple of the block size, so a block is never shared by 2 tiles
+    /// </summary>
+    static constexpr int BIN_TILE_SIZE = 64;
+
+    /// <summary>
+    /// The number of consecutive triangles a thread bins at a time
+    /// </summary>
+    static constexpr int BIN_TRIANGLES_PER_CHUNK = 512;
+
+    /// <summary>
+    /// The number of vertices a thread transforms at a time
+    /// </summary>
+    static constexpr int BIN_VERTICES_PER_CHUNK = 4096;
+
+    /// <summary>
+    /// The tiles a triangle touches, inclusive
+    /// </summary>
+    struct TileRange
+    {
+        std::uint16_t MinX;
+        std::uint16_t MinY;
+        std::uint16_t MaxX;
+        std::uint16_t MaxY;
+    };
+
+    /// <summary>
+    /// A chunk of consecutive triangles sorted by the tiles they touch, in the arena of the thread that binned them.
+    /// A tile's triangles keep their submission order
+    /// </summary>
+    struct TriangleBin
+    {
+        /// <summary>
+        /// Tile t's triangles are Triangles[TileStarts[t]] up to Triangles[TileStarts[t + 1]].
+        /// Null if the thread's arena ran out of memory
+        /// </summary>
+        std::uint32_t* TileStarts;
+
+        std::uint32_t* Triangles;
+    };
+
     /// <summary>
     /// The actual pixels that will be drawn on screen
     /// </summary>
-    Colour* _pixelData;
+    ImageBuffer _pixelData;
+
+    /// <summary>
+    /// The depth of the frame's pixels, empty unless EnableDepthBuffer was called
+    /// </summary>
+    DepthBuffer _depthBuffer;
 
     int _windowWidth;
     int _windowHeight;
 
+    /// <summary>
+    /// Memory for transient per-frame data, reset when a new frame begins
+    /// </summary>
+    FrameArena _frameArena;
+
+    /// <summary>
+    /// Memory for the tables a single draw call builds from a mesh, emptied at the start of every draw call.
+    /// Grown before a mesh is drawn if it doesn't fit, so meshes of any size can be drawn, see GetDrawArena
+    /// </summary>
+    LinearArena _drawArena;
+
+    /// <summary>
+    /// Worker threads for splitting rendering work, there is one thread per frame arena thread arena
+    /// </summary>
+    WorkerPool _workerPool;
+
+    /// <summary>
+    /// Triangles only fill the pixels inside this rectangle, the whole frame unless SetScissor was called
+    /// </summary>
+    TriangleBounds _scissor;
+
+    /// <summary>
+    /// DrawShadedMesh clips triangles to the part between these W planes
+    /// </summary>
+    float _clipNearW = 0.01f;
+    float _clipFarW = (std::numeric_limits<float>::max)();
+
 public:
 
     Graphics(int windowWidth, int windowHeight) :
         _windowWidth(windowWidth),
-        _windowHeight(windowHeight)
+        _windowHeight(windowHeight),
+
+        _frameArena(1024 * 1024,
+                    (std::max)(1u, std::thread::hardware_concurrency()),
+                    256 * 1024),
+
+        _drawArena(1024 * 1024),
+
+        _workerPool(_frameArena.GetThreadCount()),
+
+        _scissor({ 0, 0, windowWidth - 1, windowHeight - 1 })
     {
 
     };
@@ -111,14 +399,28 @@ public:
 
         CreateSamplerState();
 
-        _pixelData = new Colour[static_cast<std::size_t>(_windowWidth) * static_cast<std::size_t>(_windowHeight)];
+        _pixelData = ImageBuffer(_windowWidth, _windowHeight);
+    };
+
+    /// <summary>
+    /// Allocate the frame without a window or a device, for tools and benchmarks that only draw into memory.
+    /// EndFrame can't be called afterwards
+    /// </summary>
+    void SetupHeadless()
+    {
+        _pixelData = ImageBuffer(_windowWidth, _windowHeight);
     };
 
 
     void ClearFrame()
     {
+        // Everything allocated during the previous frame is now dead
+        _frameArena.Reset();
+
         // Clear pixel buffer
-        memset(_pixelData, 0, (static_cast<std::size_t>(_windowWidth) * static_cast<std::size_t>(_windowHeight)) * sizeof(Colour));
+        _pixelData.Clear();
+
+        _depthBuffer.Clear();
     };
 
 
@@ -129,12 +431,11 @@ public:
         Colour* pDst = reinterpret_cast<Colour*>(_d3dMappedSubResource.pData);
 
         std::size_t destinationPitch = _d3dMappedSubResource.RowPitch / sizeof(Colour);
-        std::size_t srcPitch = _windowWidth;
-        std::size_t rowBytes = srcPitch * sizeof(Colour);
+        std::size_t rowBytes = static_cast<std::size_t>(_windowWidth) * sizeof(Colour);
 
-        for (size_t y = 0u; y < _windowHeight; y++)
+        for (int y = 0; y < _windowHeight; y++)
         {
-            memcpy(&pDst[y * destinationPitch], &_pixelData[y * srcPitch], rowBytes);
+            memcpy(&pDst[y * destinationPitch], _pixelData.GetRow(y), rowBytes);
         };
 
 
@@ -307,48 +608,1780 @@ public:
 
     };
 
-    
+
     /// <summary>
-    /// Get number of pixels 
+    /// Fill a triangle given in screen space, with any winding order.
+    /// The vertices are snapped to 1/16 of a pixel and everything after that is exact integer math,
+    /// so the result only depends on the snapped positions and not on rounding.
+    /// A pixel is filled if it's centre is inside all 3 edges. Centres exactly on an edge only belong to the triangle if the edge is a
+    /// top or a left edge, so triangles that share an edge never leave a gap or draw a pixel twice.
+    /// Only the part of the triangle's bounding box that is inside the scissor is visited.
+    /// The box is walked in 8x8 blocks, a block's corners decide if it's entirely outside or inside the triangle,
+    /// so only the blocks on the triangle's edges are tested per pixel, 4 pixels at a time.
+    /// Triangles entirely outside one side of the scissor are rejected, and triangles that reach past the guard band are clipped to it
     /// </summary>
-    /// <returns></returns>
-    std::size_t GetPixelsCount() const
+    /// <param name="p0"></param>
+    /// <param name="p1"></param>
+    /// <param name="p2"></param>
+    /// <param name="colour"></param>
+    void FillTriangle(const Vector2D& p0, const Vector2D& p1, const Vector2D& p2, const Colour& colour)
     {
-        return static_cast<std::size_t>(_windowHeight) * static_cast<std::size_t>(_windowWidth);
+        const std::uint8_t outcode0 = GetScreenOutcode(p0.X, p0.Y);
+        const std::uint8_t outcode1 = GetScreenOutcode(p1.X, p1.Y);
+        const std::uint8_t outcode2 = GetScreenOutcode(p2.X, p2.Y);
+
+        if (IsTriangleRejected(outcode0, outcode1, outcode2) == true)
+            return;
+
+        // All 3 vertices are inside the guard band, so the triangle can be drawn as it is
+        if (((outcode0 | outcode1 | outcode2) & CLIP_GUARD_BAND) == 0)
+        {
+            FillSnappedTriangle(SnapVertex(p0), SnapVertex(p1), SnapVertex(p2), colour, TriangleCulling::None, _scissor);
+            return;
+        };
+
+        ClipTriangle({ p0.X, p0.Y, 1.0f }, { p1.X, p1.Y, 1.0f }, { p2.X, p2.Y, 1.0f }, CLIP_GUARD_BAND,
+                     [&](const ClipVertex& c0, const ClipVertex& c1, const ClipVertex& c2)
+        {
+            FillSnappedTriangle(SnapClipVertex(c0), SnapClipVertex(c1), SnapClipVertex(c2), colour, TriangleCulling::None, _scissor);
+        });
     };
 
+
     /// <summary>
-    /// Get a pointer to the beggning of the pixels array
+    /// Draw every triangle of a mesh in a single colour.
+    /// All of the mesh's vertices are transformed, snapped and given an outcode once, 4 at a time, into the draw arena,
+    /// so a vertex shared by many triangles is only transformed once and triangles just look their vertices up by index.
+    /// Back facing (if culled), degenerate and off-screen triangles are rejected before any pixel is visited,
+    /// only the few triangles that reach past the guard band are clipped
     /// </summary>
-    /// <returns></returns>
-    Colour* GetPixels()
+    /// <param name="mesh"></param>
+    /// <param name="transform"> Transforms the mesh's vertices to screen space </param>
+    /// <param name="colour"></param>
+    /// <param name="culling"></param>
+    void DrawMesh(const Mesh& mesh, const Matrix3x2& transform, const Colour& colour, TriangleCulling culling = TriangleCulling::Back)
     {
-        return _pixelData;
+        const std::size_t vertexCount = mesh.GetVertexCount();
+
+        if (vertexCount == 0)
+            return;
+
+        LinearArena& arena = GetDrawArena(GetMeshScreenVerticesSize(vertexCount));
+
+        const MeshScreenVertices vertices = AllocateMeshScreenVertices(arena, vertexCount);
+
+        TransformMeshVertices(mesh, transform, vertices, 0, vertexCount);
+
+
+        const std::uint32_t* indices = mesh.GetIndices();
+        const std::size_t triangleCount = mesh.GetTriangleCount();
+
+        for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+            FillMeshTriangle(vertices, indices + triangle * 3, colour, culling, _scissor);
     };
 
+
     /// <summary>
-    /// Get a pixel based on x and y position
+    /// Draw every triangle of a mesh in a single colour like DrawMesh, split between the worker pool's threads.
+    /// First the vertices are transformed, and chunks of consecutive triangles are binned into the 64x64 screen tiles they touch.
+    /// A chunk is binned by a single thread into it's own thread arena, so the threads never contend.
+    /// Then every tile is filled by a single thread, which only writes inside the tile so no pixel is written by 2 threads.
+    /// It walks the chunks in order, so the triangles of a tile are still drawn in submission order.
+    /// The vertex and triangle tables come from the draw arena, which is grown to fit the mesh
     /// </summary>
-    /// <returns></returns>
-    Colour& GetPixel(int x, int y)
+    /// <param name="mesh"></param>
+    /// <param name="transform"> Transforms the mesh's vertices to screen space </param>
+    /// <param name="colour"></param>
+    /// <param name="culling"></param>
+    void DrawMeshParallel(const Mesh& mesh, const Matrix3x2& transform, const Colour& colour, TriangleCulling culling = TriangleCulling::Back)
     {
-        // Bounds check
-        if ((x > _windowWidth || x < 0) || 
-            (y > _windowHeight || y < 0))
+        DrawMeshParallel(mesh, transform, colour, culling, _workerPool, _frameArena);
+    };
+
+    /// <summary>
+    /// DrawMeshParallel on another worker pool, used to measure how it scales with the number of threads
+    /// </summary>
+    /// <param name="mesh"></param>
+    /// <param name="transform"></param>
+    /// <param name="colour"></param>
+    /// <param name="culling"></param>
+    /// <param name="workerPool"></param>
+    /// <param name="frameArena"> Only it's thread arenas are used, it needs one for every thread of the pool </param>
+    void DrawMeshParallel(const Mesh& mesh, const Matrix3x2& transform, const Colour& colour, TriangleCulling culling,
+                          WorkerPool& workerPool, FrameArena& frameArena)
+    {
+        if (frameArena.GetThreadCount() < workerPool.GetThreadCount())
+            throw std::exception("The frame arena needs a thread arena for every worker thread");
+
+        const std::size_t vertexCount = mesh.GetVertexCount();
+        const std::size_t triangleCount = mesh.GetTriangleCount();
+
+        if (triangleCount == 0)
+            return;
+
+        const int chunkCount = static_cast<int>((triangleCount + BIN_TRIANGLES_PER_CHUNK - 1) / BIN_TRIANGLES_PER_CHUNK);
+
+        LinearArena& arena = GetDrawArena(GetMeshScreenVerticesSize(vertexCount) +
+                                          GetArraySize<TileRange>(triangleCount) +
+                                          GetArraySize<TriangleBin>(chunkCount));
+
+        const MeshScreenVertices vertices = AllocateMeshScreenVertices(arena, vertexCount);
+
+        workerPool.ParallelFor(0, static_cast<int>(vertexCount), BIN_VERTICES_PER_CHUNK, [&](int begin, int end, std::size_t)
         {
-            WindowsUtilities::ShowWinErrorW(L"Error. GetPixel() tried to access out of bounds memory");
-            DebugBreak();
+            TransformMeshVertices(mesh, transform, vertices, begin, end);
+        });
+
+
+        // Bin the triangles
+        const int tilesX = (_windowWidth + BIN_TILE_SIZE - 1) / BIN_TILE_SIZE;
+        const int tilesY = (_windowHeight + BIN_TILE_SIZE - 1) / BIN_TILE_SIZE;
+        const int tileCount = tilesX * tilesY;
+
+        const std::uint32_t* indices = mesh.GetIndices();
+
+        TileRange* tileRanges = arena.AllocateArray<TileRange>(triangleCount);
+        TriangleBin* bins = arena.AllocateArray<TriangleBin>(chunkCount);
+
+        workerPool.ParallelFor(0, chunkCount, 1, [&](int firstChunk, int lastChunk, std::size_t threadIndex)
+        {
+            for (int chunk = firstChunk; chunk < lastChunk; chunk++)
+            {
+                const std::size_t firstTriangle = static_cast<std::size_t>(chunk) * BIN_TRIANGLES_PER_CHUNK;
+                const std::size_t lastTriangle = (std::min)(firstTriangle + BIN_TRIANGLES_PER_CHUNK, triangleCount);
+
+                bins[chunk] = BinTriangles(vertices, indices, firstTriangle, lastTriangle, culling,
+                                           tilesX, tileCount, tileRanges, frameArena.GetThreadArena(threadIndex));
+            };
+        });
+
+        // A thread ran out of arena memory, fill every triangle in order on this thread instead
+        for (int chunk = 0; chunk < chunkCount; chunk++)
+        {
+            if (bins[chunk].TileStarts == nullptr)
+            {
+                for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+                    FillMeshTriangle(vertices, indices + triangle * 3, colour, culling, _scissor);
+
+                return;
+            };
         };
 
-        size_t pixelDataIndexer = x + _windowWidth * y;
 
-        Colour& pixel = _pixelData[pixelDataIndexer];
+        // Fill the tiles
+        workerPool.ParallelFor(0, tileCount, 1, [&](int firstTile, int lastTile, std::size_t)
+        {
+            for (int tile = firstTile; tile < lastTile; tile++)
+            {
+                const int tileX = (tile % tilesX) * BIN_TILE_SIZE;
+                const int tileY = (tile / tilesX) * BIN_TILE_SIZE;
 
-        return pixel;
+                const TriangleBounds tileScissor =
+                {
+                    (std::max)(tileX, _scissor.MinX),
+                    (std::max)(tileY, _scissor.MinY),
+                    (std::min)(tileX + BIN_TILE_SIZE - 1, _scissor.MaxX),
+                    (std::min)(tileY + BIN_TILE_SIZE - 1, _scissor.MaxY),
+                };
+
+                if ((tileScissor.MinX > tileScissor.MaxX) || (tileScissor.MinY > tileScissor.MaxY))
+                    continue;
+
+                for (int chunk = 0; chunk < chunkCount; chunk++)
+                {
+                    const TriangleBin& bin = bins[chunk];
+
+                    for (std::uint32_t entry = bin.TileStarts[tile]; entry < bin.TileStarts[tile + 1]; entry++)
+                        FillMeshTriangle(vertices, indices + static_cast<std::size_t>(bin.Triangles[entry]) * 3, colour, culling, tileScissor);
+                };
+            };
+        });
     };
 
 
-private:
+    /// <summary>
+    /// Draw every triangle of a mesh with it's vertex colours interpolated across the triangles,
+    /// optionally multiplied by a texture sampled at the interpolated texture coordinates.
+    /// The mesh's positions are homogeneous, a vertex is drawn at the transformed (X / W, Y / W),
+    /// so a mesh can be given before the perspective divide and triangles that cross behind the camera are still drawn correctly.
+    /// Triangles are clipped to the W range set with SetClipRange, and to the guard band, in homogeneous space before the divide.
+    /// Interpolation is perspective correct using the vertices' W, with a single reciprocal per 8x8 block:
+    /// the values are exact at the block's corners and stepped linearly in between.
+    /// Blocks whose corners are outside the triangle's range of 1/W, where W can blow up past the horizon, divide every pixel instead.
+    /// If the depth buffer is enabled a pixel is only drawn if it's closer than what was drawn there before, and then it's depth is written.
+    /// Blocks that are entirely hidden are skipped before any pixel is shaded, so drawing front to back is much cheaper
+    /// </summary>
+    /// <param name="mesh"></param>
+    /// <param name="transform"> Transforms the mesh's vertices to screen space, the translation is scaled by W </param>
+    /// <param name="texture"> Can be null, a sprite's Pixels can be used as a texture </param>
+    /// <param name="filter"></param>
+    /// <param name="culling"></param>
+    void DrawShadedMesh(const Mesh& mesh, const Matrix3x2& transform,
+                        const ImageBuffer* texture, TextureFilter filter = TextureFilter::Bilinear,
+                        TriangleCulling culling = TriangleCulling::Back)
+    {
+        const std::size_t vertexCount = mesh.GetVertexCount();
+
+        if (vertexCount == 0)
+            return;
+
+        if ((texture != nullptr) && ((texture->GetWidth() <= 0) || (texture->GetHeight() <= 0)))
+            texture = nullptr;
+
+        LinearArena& arena = GetDrawArena(GetArraySize<ClipVertex>(vertexCount) +
+                                          GetArraySize<std::uint8_t>(vertexCount) +
+                                          GetArraySize<FixedPointVertex>(vertexCount) +
+                                          GetArraySize<ShadedVertex>(vertexCount));
+
+        ClipVertex* clipVertices = arena.AllocateArray<ClipVertex>(vertexCount);
+        std::uint8_t* outcodes = arena.AllocateArray<std::uint8_t>(vertexCount);
+
+        FixedPointVertex* snapped = arena.AllocateArray<FixedPointVertex>(vertexCount);
+        ShadedVertex* shadedVertices = arena.AllocateArray<ShadedVertex>(vertexCount);
+
+        const float* positionsX = mesh.GetPositionsX();
+        const float* positionsY = mesh.GetPositionsY();
+        const Colour* colours = mesh.GetColours();
+        const float* textureU = mesh.GetTextureU();
+        const float* textureV = mesh.GetTextureV();
+        const float* w = mesh.GetW();
+
+        for (std::size_t index = 0; index < vertexCount; index++)
+        {
+            ClipVertex& vertex = clipVertices[index];
+
+            vertex.X = positionsX[index] * transform.M11 + positionsY[index] * transform.M21 + w[index] * transform.M31;
+            vertex.Y = positionsX[index] * transform.M12 + positionsY[index] * transform.M22 + w[index] * transform.M32;
+            vertex.W = w[index];
+
+            vertex.Attributes[0] = colours[index].Red;
+            vertex.Attributes[1] = colours[index].Green;
+            vertex.Attributes[2] = colours[index].Blue;
+            vertex.Attributes[3] = colours[index].Alpha;
+            vertex.Attributes[4] = textureU[index];
+            vertex.Attributes[5] = textureV[index];
+
+            outcodes[index] = GetClipOutcode(vertex);
+
+            // Divide every vertex that can be drawn without clipping once
+            if ((outcodes[index] & (CLIP_PLANES_MASK | CLIP_INVALID)) == 0)
+            {
+                snapped[index] = SnapClipVertex(vertex);
+                shadedVertices[index] = GetShadedVertex(vertex);
+            };
+        };
+
+
+        const std::uint32_t* indices = mesh.GetIndices();
+        const std::size_t triangleCount = mesh.GetTriangleCount();
+
+        for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            const std::uint32_t index0 = indices[triangle * 3];
+            const std::uint32_t index1 = indices[triangle * 3 + 1];
+            const std::uint32_t index2 = indices[triangle * 3 + 2];
+
+            if (IsTriangleRejected(outcodes[index0], outcodes[index1], outcodes[index2]) == true)
+                continue;
+
+            const std::uint8_t planes = (outcodes[index0] | outcodes[index1] | outcodes[index2]) & CLIP_PLANES_MASK;
+
+            if (planes == 0)
+            {
+                FillShadedTriangle(snapped[index0], snapped[index1], snapped[index2],
+                                   shadedVertices[index0], shadedVertices[index1], shadedVertices[index2],
+                                   texture, filter, culling);
+                continue;
+            };
+
+            ClipTriangle(clipVertices[index0], clipVertices[index1], clipVertices[index2], planes,
+                         [&](const ClipVertex& c0, const ClipVertex& c1, const ClipVertex& c2)
+            {
+                FillShadedTriangle(SnapClipVertex(c0), SnapClipVertex(c1), SnapClipVertex(c2),
+                                   GetShadedVertex(c0), GetShadedVertex(c1), GetShadedVertex(c2),
+                                   texture, filter, culling);
+            });
+        };
+    };
+
+
+    /// <summary>
+    /// Create a depth buffer the size of the frame, cleared with every frame. DrawShadedMesh tests and writes it from then on,
+    /// the other drawing functions ignore it
+    /// </summary>
+    void EnableDepthBuffer()
+    {
+        if (_depthBuffer.IsEmpty() == true)
+            _depthBuffer = DepthBuffer(_windowWidth, _windowHeight);
+    };
+
+    void DisableDepthBuffer()
+    {
+        _depthBuffer = DepthBuffer();
+    };
+
+    bool IsDepthBufferEnabled() const
+    {
+        return _depthBuffer.IsEmpty() == false;
+    };
+
+    /// <summary>
+    /// Get the depth buffer, empty if it isn't enabled
+    /// </summary>
+    /// <returns></returns>
+    const DepthBuffer& GetDepthBuffer() const
+    {
+        return _depthBuffer;
+    };
+
+
+    /// <summary>
+    /// Only let triangles fill the pixels inside a rectangle, until ResetScissor is called.
+    /// The rectangle is clamped to the frame. Triangles entirely outside of it are rejected from their vertices' outcodes,
+    /// and the others only visit the blocks inside it
+    /// </summary>
+    /// <param name="x"> The rectangle's left edge </param>
+    /// <param name="y"> The rectangle's top edge </param>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    void SetScissor(int x, int y, int width, int height)
+    {
+        _scissor.MinX = (std::max)(x, 0);
+        _scissor.MinY = (std::max)(y, 0);
+
+        _scissor.MaxX = (std::min)(x + (std::max)(width, 0), _windowWidth) - 1;
+        _scissor.MaxY = (std::min)(y + (std::max)(height, 0), _windowHeight) - 1;
+    };
+
+    /// <summary>
+    /// Let triangles fill the whole frame again
+    /// </summary>
+    void ResetScissor()
+    {
+        _scissor = { 0, 0, _windowWidth - 1, _windowHeight - 1 };
+    };
+
+    /// <summary>
+    /// Set the near and far W planes DrawShadedMesh clips triangles to
+    /// </summary>
+    /// <param name="nearW"> Must be positive, triangles are cut where they come closer than this </param>
+    /// <param name="farW"> Must be larger than nearW </param>
+    void SetClipRange(float nearW, float farW)
+    {
+        if (!((nearW > 0.0f) && (farW > nearW)))
+            throw std::exception("Clip range must be positive and not empty");
+
+        _clipNearW = nearW;
+        _clipFarW = farW;
+    };
+
+
+    /// <summary>
+    /// Copy an image onto the frame, a row at a time.
+    /// The parts of the image that fall outside the frame are clipped
+    /// </summary>
+    /// <param name="image"></param>
+    /// <param name="x"> Frame position of the image's left edge </param>
+    /// <param name="y"> Frame position of the image's top edge </param>
+    void DrawImage(const ImageBuffer& image, int x, int y)
+    {
+        const int firstColumn = (std::max)(0, -x);
+        const int firstRow = (std::max)(0, -y);
+
+        const int lastColumn = (std::min)(image.GetWidth(), _windowWidth - x);
+        const int lastRow = (std::min)(image.GetHeight(), _windowHeight - y);
+
+        if ((firstColumn >= lastColumn) || (firstRow >= lastRow))
+            return;
+
+        const std::size_t rowBytes = static_cast<std::size_t>(lastColumn - firstColumn) * sizeof(Colour);
+
+        for (int row = firstRow; row < lastRow; row++)
+            memcpy(_pixelData.GetRow(y + row) + x + firstColumn, image.GetRow(row) + firstColumn, rowBytes);
+    };
+
+    
+    /// <summary>
+    /// Get number of pixels 
+    /// </summary>
+    /// <returns></returns>
+    std::size_t GetPixelsCount() const
+    {
+        return static_cast<std::size_t>(_windowHeight) * static_cast<std::size_t>(_windowWidth);
+    };
+
+    /// <summary>
+    /// Get the arena used for per-frame allocations.
+    /// Memory allocated from it is only valid until the next ClearFrame
+    /// </summary>
+    /// <returns></returns>
+    FrameArena& GetFrameArena()
+    {
+        return _frameArena;
+    };
+
+    /// <summary>
+    /// Get the worker pool used for parallel rendering.
+    /// A job's thread index can be used with GetFrameArena().GetThreadArena() for per-thread scratch memory
+    /// </summary>
+    /// <returns></returns>
+    WorkerPool& GetWorkerPool()
+    {
+        return _workerPool;
+    };
+
+    /// <summary>
+    /// Get the width of the frame in pixels
+    /// </summary>
+    /// <returns></returns>
+    int GetWidth() const
+    {
+        return _windowWidth;
+    };
+
+    /// <summary>
+    /// Get the height of the frame in pixels
+    /// </summary>
+    /// <returns></returns>
+    int GetHeight() const
+    {
+        return _windowHeight;
+    };
+
+    /// <summary>
+    /// Get a pointer to the beggning of the pixels array.
+    /// Rows are GetPitch() pixels apart, which can be wider than the frame
+    /// </summary>
+    /// <returns></returns>
+    Colour* GetPixels()
+    {
+        return _pixelData.GetData();
+    };
+
+    /// <summary>
+    /// Get the distance between 2 rows of the pixels array, in pixels
+    /// </summary>
+    /// <returns></returns>
+    std::size_t GetPitch() const
+    {
+        return _pixelData.GetPitch();
+    };
+
+    /// <summary>
+    /// Get a pixel based on x and y position
+    /// </summary>
+    /// <returns></returns>
+    Colour& GetPixel(int x, int y)
+    {
+        // Bounds check
+        if ((x > _windowWidth || x < 0) || 
+            (y > _windowHeight || y < 0))
+        {
+            WindowsUtilities::ShowWinErrorW(L"Error. GetPixel() tried to access out of bounds memory");
+            DebugBreak();
+        };
+
+        Colour& pixel = _pixelData.GetPixel(x, y);
+
+        return pixel;
+    };
+
+    /// <summary>
+    /// Get a 64 bit FNV-1a hash of the visible pixels of the current frame.
+    /// Used to check that 2 builds render identical frames from the same input
+    /// </summary>
+    /// <returns></returns>
+    std::uint64_t GetFrameHash() const
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (int y = 0; y < _windowHeight; y++)
+        {
+            // Only hash the visible part of the row, the padding isn't part of the frame
+            const std::uint8_t* row = reinterpret_cast<const std::uint8_t*>(_pixelData.GetRow(y));
+            const std::size_t rowSize = static_cast<std::size_t>(_windowWidth) * sizeof(Colour);
+
+            for (std::size_t a = 0; a < rowSize; a++)
+            {
+                hash ^= row[a];
+                hash *= 1099511628211ull;
+            };
+        };
+
+        return hash;
+    };
+
+
+private:
+
+    /// <summary>
+    /// Round a screen space position to the nearest 1/16 of a pixel
+    /// </summary>
+    /// <param name="point"></param>
+    /// <returns></returns>
+    static FixedPointVertex SnapVertex(const Vector2D& point)
+    {
+        return
+        {
+            static_cast<std::int32_t>(std::lrintf(point.X * SUBPIXEL_SCALE)),
+            static_cast<std::int32_t>(std::lrintf(point.Y * SUBPIXEL_SCALE)),
+        };
+    };
+
+
+    /// <summary>
+    /// Divide a clipped vertex by it's W and snap it
+    /// </summary>
+    /// <param name="vertex"></param>
+    /// <returns></returns>
+    static FixedPointVertex SnapClipVertex(const ClipVertex& vertex)
+    {
+        const float inverseW = 1.0f / vertex.W;
+
+        return SnapVertex({ vertex.X * inverseW, vertex.Y * inverseW });
+    };
+
+    /// <summary>
+    /// Divide a clipped vertex's attributes by it's W, for FillShadedTriangle
+    /// </summary>
+    /// <param name="vertex"></param>
+    /// <returns></returns>
+    static ShadedVertex GetShadedVertex(const ClipVertex& vertex)
+    {
+        const float inverseW = 1.0f / vertex.W;
+
+        ShadedVertex shadedVertex;
+        shadedVertex.Values[0] = inverseW;
+
+        for (int index = 0; index < SHADED_ATTRIBUTE_COUNT - 1; index++)
+            shadedVertex.Values[index + 1] = vertex.Attributes[index] * inverseW;
+
+        return shadedVertex;
+    };
+
+
+    /// <summary>
+    /// Find which sides of the scissor and of the guard band a screen space position is outside of.
+    /// Compared against the scissor's outer edges, a triangle can only cover a pixel's centre if it reaches past the pixel's edge
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <returns></returns>
+    std::uint8_t GetScreenOutcode(float x, float y) const
+    {
+        if (!(std::isfinite(x) && std::isfinite(y)))
+            return CLIP_INVALID;
+
+        std::uint8_t outcode = 0;
+
+        if (x < static_cast<float>(_scissor.MinX))
+            outcode |= CLIP_LEFT;
+
+        if (x > static_cast<float>(_scissor.MaxX + 1))
+            outcode |= CLIP_RIGHT;
+
+        if (y < static_cast<float>(_scissor.MinY))
+            outcode |= CLIP_TOP;
+
+        if (y > static_cast<float>(_scissor.MaxY + 1))
+            outcode |= CLIP_BOTTOM;
+
+        if ((std::fabs(x) > TRIANGLE_COORDINATE_LIMIT) || (std::fabs(y) > TRIANGLE_COORDINATE_LIMIT))
+            outcode |= CLIP_GUARD_BAND;
+
+        return outcode;
+    };
+
+    /// <summary>
+    /// Find the planes a homogeneous vertex is outside of.
+    /// A vertex behind the near plane can't be divided by it's W, so only it's CLIP_NEAR bit is set
+    /// </summary>
+    /// <param name="vertex"></param>
+    /// <returns></returns>
+    std::uint8_t GetClipOutcode(const ClipVertex& vertex) const
+    {
+        if (!(std::isfinite(vertex.X) && std::isfinite(vertex.Y) && std::isfinite(vertex.W)))
+            return CLIP_INVALID;
+
+        if (vertex.W < _clipNearW)
+            return CLIP_NEAR;
+
+        const float inverseW = 1.0f / vertex.W;
+
+        std::uint8_t outcode = GetScreenOutcode(vertex.X * inverseW, vertex.Y * inverseW);
+
+        if (vertex.W > _clipFarW)
+            outcode |= CLIP_FAR;
+
+        return outcode;
+    };
+
+    /// <summary>
+    /// Check if a triangle can be skipped from it's vertices' outcodes alone
+    /// </summary>
+    /// <param name="outcode0"></param>
+    /// <param name="outcode1"></param>
+    /// <param name="outcode2"></param>
+    /// <returns></returns>
+    static bool IsTriangleRejected(std::uint8_t outcode0, std::uint8_t outcode1, std::uint8_t outcode2)
+    {
+        if (((outcode0 | outcode1 | outcode2) & CLIP_INVALID) != 0)
+            return true;
+
+        // All 3 vertices are outside of the same plane
+        return ((outcode0 & outcode1 & outcode2) & CLIP_REJECT_MASK) != 0;
+    };
+
+
+    /// <summary>
+    /// Clip a triangle against some of the clipping planes with Sutherland-Hodgman, in homogeneous space,
+    /// and draw what is left of it as a fan of triangles. The fan keeps the triangle's winding, so the pieces are culled like the triangle
+    /// </summary>
+    /// <param name="v0"></param>
+    /// <param name="v1"></param>
+    /// <param name="v2"></param>
+    /// <param name="planes"> The CLIP_NEAR, CLIP_FAR and CLIP_GUARD_BAND bits of the planes to clip against </param>
+    /// <param name="drawTriangle"> Called with the 3 vertices of every triangle of the fan </param>
+    template<typename TDrawTriangle>
+    void ClipTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, std::uint8_t planes, TDrawTriangle&& drawTriangle) const
+    {
+        // The vertices the near plane adds can be projected anywhere, even if all 3 original vertices were inside the guard band
+        if ((planes & CLIP_NEAR) != 0)
+            planes |= CLIP_GUARD_BAND;
+
+        ClipVertex polygons[2][MAX_CLIPPED_VERTICES] = { { v0, v1, v2 } };
+
+        int current = 0;
+        int vertexCount = 3;
+
+        // The inside of a plane is where a * X + b * Y + c * W + d isn't negative
+        const auto clip = [&](float a, float b, float c, float d)
+        {
+            if (vertexCount < 3)
+                return;
+
+            vertexCount = ClipPolygon(polygons[current], vertexCount, polygons[current ^ 1], a, b, c, d);
+            current ^= 1;
+        };
+
+        if ((planes & CLIP_NEAR) != 0)
+            clip(0.0f, 0.0f, 1.0f, -_clipNearW);
+
+        if ((planes & CLIP_FAR) != 0)
+            clip(0.0f, 0.0f, -1.0f, _clipFarW);
+
+        // -limit <= X / W <= limit, multiplied by W which is positive once the near plane is clipped
+        if ((planes & CLIP_GUARD_BAND) != 0)
+        {
+            clip(1.0f, 0.0f, TRIANGLE_COORDINATE_LIMIT, 0.0f);
+            clip(-1.0f, 0.0f, TRIANGLE_COORDINATE_LIMIT, 0.0f);
+            clip(0.0f, 1.0f, TRIANGLE_COORDINATE_LIMIT, 0.0f);
+            clip(0.0f, -1.0f, TRIANGLE_COORDINATE_LIMIT, 0.0f);
+        };
+
+        const ClipVertex* polygon = polygons[current];
+
+        for (int index = 1; index + 1 < vertexCount; index++)
+            drawTriangle(polygon[0], polygon[index], polygon[index + 1]);
+    };
+
+    /// <summary>
+    /// Clip a convex polygon against a single plane
+    /// </summary>
+    /// <param name="input"></param>
+    /// <param name="inputCount"></param>
+    /// <param name="output"> Room for MAX_CLIPPED_VERTICES vertices </param>
+    /// <param name="a"></param>
+    /// <param name="b"></param>
+    /// <param name="c"></param>
+    /// <param name="d"></param>
+    /// <returns> The number of vertices written to output </returns>
+    static int ClipPolygon(const ClipVertex* input, int inputCount, ClipVertex* output, float a, float b, float c, float d)
+    {
+        int outputCount = 0;
+
+        const auto emit = [&](const ClipVertex& vertex)
+        {
+            // Only a polygon made non-convex by rounding can grow past the limit
+            if (outputCount < MAX_CLIPPED_VERTICES)
+                output[outputCount++] = vertex;
+        };
+
+        const ClipVertex* previous = &input[inputCount - 1];
+        float previousDistance = a * previous->X + b * previous->Y + c * previous->W + d;
+
+        for (int index = 0; index < inputCount; index++)
+        {
+            const ClipVertex* vertex = &input[index];
+            const float distance = a * vertex->X + b * vertex->Y + c * vertex->W + d;
+
+            const bool previousInside = (previousDistance >= 0.0f);
+            const bool inside = (distance >= 0.0f);
+
+            // Always interpolate from the inside vertex to the outside one,
+            // so 2 triangles that share the edge get the exact same point and stay watertight
+            if (inside != previousInside)
+            {
+                if (inside == true)
+                    emit(LerpClipVertex(*vertex, *previous, distance / (distance - previousDistance)));
+                else
+                    emit(LerpClipVertex(*previous, *vertex, previousDistance / (previousDistance - distance)));
+            };
+
+            if (inside == true)
+                emit(*vertex);
+
+            previous = vertex;
+            previousDistance = distance;
+        };
+
+        return outputCount;
+    };
+
+    static ClipVertex LerpClipVertex(const ClipVertex& from, const ClipVertex& to, float amount)
+    {
+        ClipVertex result;
+
+        result.X = from.X + (to.X - from.X) * amount;
+        result.Y = from.Y + (to.Y - from.Y) * amount;
+        result.W = from.W + (to.W - from.W) * amount;
+
+        for (int index = 0; index < SHADED_ATTRIBUTE_COUNT - 1; index++)
+            result.Attributes[index] = from.Attributes[index] + (to.Attributes[index] - from.Attributes[index]) * amount;
+
+        return result;
+    };
+
+
+    /// <summary>
+    /// Reject triangles that don't have to be drawn, and find the pixels a triangle can cover
+    /// </summary>
+    /// <param name="v0"></param>
+    /// <param name="v1"> Swapped with v2 if the triangle is counter-clockwise on screen, to make the inside positive for every edge </param>
+    /// <param name="v2"></param>
+    /// <param name="culling"></param>
+    /// <param name="scissor"> The bounds are clipped to it </param>
+    /// <param name="bounds"></param>
+    /// <param name="swapped"> Set to true if v1 and v2 were swapped </param>
+    /// <returns> False if nothing has to be drawn </returns>
+    static bool SetupTriangle(FixedPointVertex& v0, FixedPointVertex& v1, FixedPointVertex& v2, TriangleCulling culling,
+                              const TriangleBounds& scissor, TriangleBounds& bounds, bool& swapped)
+    {
+        // Twice the signed area, y points down so it's negative if the triangle is counter-clockwise on screen
+        const std::int64_t area = static_cast<std::int64_t>(v1.X - v0.X) * (v2.Y - v0.Y) - static_cast<std::int64_t>(v1.Y - v0.Y) * (v2.X - v0.X);
+
+        if (area == 0)
+            return false;
+
+        if ((area > 0) && (culling == TriangleCulling::Back))
+            return false;
+
+        swapped = (area < 0);
+
+        if (swapped == true)
+            std::swap(v1, v2);
+
+
+        // The pixels whose centres can be inside, clipped to the scissor
+        bounds.MinX = (std::max)((std::min)({ v0.X, v1.X, v2.X }) >> SUBPIXEL_BITS, scissor.MinX);
+        bounds.MinY = (std::max)((std::min)({ v0.Y, v1.Y, v2.Y }) >> SUBPIXEL_BITS, scissor.MinY);
+
+        bounds.MaxX = (std::min)((std::max)({ v0.X, v1.X, v2.X }) >> SUBPIXEL_BITS, scissor.MaxX);
+        bounds.MaxY = (std::min)((std::max)({ v0.Y, v1.Y, v2.Y }) >> SUBPIXEL_BITS, scissor.MaxY);
+
+        return (bounds.MinX <= bounds.MaxX) && (bounds.MinY <= bounds.MaxY);
+    };
+
+
+    /// <summary>
+    /// Fill a triangle whose vertices were already snapped
+    /// </summary>
+    /// <param name="v0"></param>
+    /// <param name="v1"></param>
+    /// <param name="v2"></param>
+    /// <param name="colour"></param>
+    /// <param name="culling"></param>
+    /// <param name="scissor"> Only pixels inside it are written, the graphics' scissor or a part of it </param>
+    void FillSnappedTriangle(FixedPointVertex v0, FixedPointVertex v1, FixedPointVertex v2, const Colour& colour, TriangleCulling culling,
+                             const TriangleBounds& scissor)
+    {
+        TriangleBounds bounds;
+        bool swapped;
+
+        if (SetupTriangle(v0, v1, v2, culling, scissor, bounds, swapped) == false)
+            return;
+
+        const int minX = bounds.MinX;
+        const int minY = bounds.MinY;
+        const int maxX = bounds.MaxX;
+        const int maxY = bounds.MaxY;
+
+        const TriangleEdge edges[3] =
+        {
+            TriangleEdge(v1, v2),
+            TriangleEdge(v2, v0),
+            TriangleEdge(v0, v1),
+        };
+
+        std::uint32_t colourBits;
+        std::memcpy(&colourBits, &colour, sizeof(colourBits));
+
+        const __m128i colourVector = _mm_set1_epi32(static_cast<int>(colourBits));
+
+        // Blocks are aligned to the frame, not to the bounding box
+        const int firstBlockX = minX & ~(TRIANGLE_BLOCK_SIZE - 1);
+        const int firstBlockY = minY & ~(TRIANGLE_BLOCK_SIZE - 1);
+
+        for (int blockY = firstBlockY; blockY <= maxY; blockY += TRIANGLE_BLOCK_SIZE)
+        {
+            for (int blockX = firstBlockX; blockX <= maxX; blockX += TRIANGLE_BLOCK_SIZE)
+            {
+                // Blocks that are cut by the scissor, which is never larger than the frame, are drawn a pixel at a time
+                if ((blockX < scissor.MinX) || (blockX + TRIANGLE_BLOCK_SIZE - 1 > scissor.MaxX) ||
+                    (blockY < scissor.MinY) || (blockY + TRIANGLE_BLOCK_SIZE - 1 > scissor.MaxY))
+                {
+                    FillTrianglePixels(edges,
+                                       (std::max)(blockX, minX), (std::max)(blockY, minY),
+                                       (std::min)(blockX + TRIANGLE_BLOCK_SIZE - 1, maxX), (std::min)(blockY + TRIANGLE_BLOCK_SIZE - 1, maxY),
+                                       colour);
+                    continue;
+                };
+
+                FillTriangleBlock(edges, blockX, blockY, colourVector);
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Get the draw arena emptied, and grown first if it's smaller than the memory the draw call needs.
+    /// It's grown by half again more than needed, so a mesh that grows a little every frame doesn't reallocate it every frame
+    /// </summary>
+    /// <param name="size"> The number of bytes the draw call allocates, including the padding for alignment </param>
+    /// <returns></returns>
+    LinearArena& GetDrawArena(std::size_t size)
+    {
+        if (_drawArena.GetCapacity() < size)
+            _drawArena = LinearArena(size + size / 2);
+
+        _drawArena.Reset();
+
+        return _drawArena;
+    };
+
+    /// <summary>
+    /// Get the most arena memory an array of T can take, including the padding that aligns it
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    /// <param name="count"></param>
+    /// <returns></returns>
+    template<class T>
+    static std::size_t GetArraySize(std::size_t count)
+    {
+        return sizeof(T) * count + alignof(T);
+    };
+
+    /// <summary>
+    /// Get the arena memory AllocateMeshScreenVertices takes
+    /// </summary>
+    /// <param name="vertexCount"></param>
+    /// <returns></returns>
+    static std::size_t GetMeshScreenVerticesSize(std::size_t vertexCount)
+    {
+        return GetArraySize<float>(vertexCount) * 2 +
+               GetArraySize<FixedPointVertex>(vertexCount) +
+               GetArraySize<std::uint8_t>(vertexCount);
+    };
+
+    /// <summary>
+    /// Allocate the screen space vertices of a mesh from an arena, which must have GetMeshScreenVerticesSize bytes left
+    /// </summary>
+    /// <param name="arena"></param>
+    /// <param name="vertexCount"></param>
+    /// <returns></returns>
+    static MeshScreenVertices AllocateMeshScreenVertices(LinearArena& arena, std::size_t vertexCount)
+    {
+        MeshScreenVertices vertices;
+
+        vertices.X = arena.AllocateArray<float>(vertexCount);
+        vertices.Y = arena.AllocateArray<float>(vertexCount);
+        vertices.Snapped = arena.AllocateArray<FixedPointVertex>(vertexCount);
+        vertices.Outcodes = arena.AllocateArray<std::uint8_t>(vertexCount);
+
+        return vertices;
+    };
+
+
+    /// <summary>
+    /// Fill one triangle of a mesh whose vertices were already transformed, clipping it to the guard band if it has to be
+    /// </summary>
+    /// <param name="vertices"></param>
+    /// <param name="triangleIndices"> The triangle's 3 vertex indices </param>
+    /// <param name="colour"></param>
+    /// <param name="culling"></param>
+    /// <param name="scissor"></param>
+    void FillMeshTriangle(const MeshScreenVertices& vertices, const std::uint32_t* triangleIndices,
+                          const Colour& colour, TriangleCulling culling, const TriangleBounds& scissor)
+    {
+        const std::uint32_t index0 = triangleIndices[0];
+        const std::uint32_t index1 = triangleIndices[1];
+        const std::uint32_t index2 = triangleIndices[2];
+
+        const std::uint8_t* outcodes = vertices.Outcodes;
+
+        if (IsTriangleRejected(outcodes[index0], outcodes[index1], outcodes[index2]) == true)
+            return;
+
+        if (((outcodes[index0] | outcodes[index1] | outcodes[index2]) & CLIP_GUARD_BAND) == 0)
+        {
+            FillSnappedTriangle(vertices.Snapped[index0], vertices.Snapped[index1], vertices.Snapped[index2], colour, culling, scissor);
+            return;
+        };
+
+        ClipTriangle({ vertices.X[index0], vertices.Y[index0], 1.0f },
+                     { vertices.X[index1], vertices.Y[index1], 1.0f },
+                     { vertices.X[index2], vertices.Y[index2], 1.0f },
+                     CLIP_GUARD_BAND,
+                     [&](const ClipVertex& c0, const ClipVertex& c1, const ClipVertex& c2)
+        {
+            FillSnappedTriangle(SnapClipVertex(c0), SnapClipVertex(c1), SnapClipVertex(c2), colour, culling, scissor);
+        });
+    };
+
+
+    /// <summary>
+    /// Find the tiles a triangle of a mesh can cover, rejecting it if it doesn't have to be drawn
+    /// </summary>
+    /// <param name="vertices"></param>
+    /// <param name="triangleIndices"></param>
+    /// <param name="culling"></param>
+    /// <param name="range"></param>
+    /// <returns> False if the triangle doesn't have to be drawn </returns>
+    bool GetTriangleTileRange(const MeshScreenVertices& vertices, const std::uint32_t* triangleIndices, TriangleCulling culling, TileRange& range) const
+    {
+        const std::uint32_t index0 = triangleIndices[0];
+        const std::uint32_t index1 = triangleIndices[1];
+        const std::uint32_t index2 = triangleIndices[2];
+
+        const std::uint8_t* outcodes = vertices.Outcodes;
+
+        if (IsTriangleRejected(outcodes[index0], outcodes[index1], outcodes[index2]) == true)
+            return false;
+
+        TriangleBounds bounds;
+
+        if (((outcodes[index0] | outcodes[index1] | outcodes[index2]) & CLIP_GUARD_BAND) == 0)
+        {
+            FixedPointVertex v0 = vertices.Snapped[index0];
+            FixedPointVertex v1 = vertices.Snapped[index1];
+            FixedPointVertex v2 = vertices.Snapped[index2];
+
+            bool swapped;
+
+            if (SetupTriangle(v0, v1, v2, culling, _scissor, bounds, swapped) == false)
+                return false;
+        }
+        else
+        {
+            // The triangle is clipped when it's filled, until then it's unclipped box limited to the scissor is close enough
+            const auto clampX = [this](float x)
+            {
+                return static_cast<int>(std::floor((std::min)((std::max)(x, static_cast<float>(_scissor.MinX)), static_cast<float>(_scissor.MaxX))));
+            };
+
+            const auto clampY = [this](float y)
+            {
+                return static_cast<int>(std::floor((std::min)((std::max)(y, static_cast<float>(_scissor.MinY)), static_cast<float>(_scissor.MaxY))));
+            };
+
+            bounds.MinX = clampX((std::min)({ vertices.X[index0], vertices.X[index1], vertices.X[index2] }));
+            bounds.MinY = clampY((std::min)({ vertices.Y[index0], vertices.Y[index1], vertices.Y[index2] }));
+            bounds.MaxX = clampX((std::max)({ vertices.X[index0], vertices.X[index1], vertices.X[index2] }));
+            bounds.MaxY = clampY((std::max)({ vertices.Y[index0], vertices.Y[index1], vertices.Y[index2] }));
+
+            if ((bounds.MinX > bounds.MaxX) || (bounds.MinY > bounds.MaxY))
+                return false;
+        };
+
+        range.MinX = static_cast<std::uint16_t>(bounds.MinX / BIN_TILE_SIZE);
+        range.MinY = static_cast<std::uint16_t>(bounds.MinY / BIN_TILE_SIZE);
+        range.MaxX = static_cast<std::uint16_t>(bounds.MaxX / BIN_TILE_SIZE);
+        range.MaxY = static_cast<std::uint16_t>(bounds.MaxY / BIN_TILE_SIZE);
+
+        return true;
+    };
+
+
+    /// <summary>
+    /// Sort a chunk of a mesh's triangles by the tiles they touch, with a counting sort so each tile's triangles stay in order.
+    /// Runs on a worker thread, so it allocates from the thread's arena and doesn't throw if it runs out of memory
+    /// </summary>
+    /// <param name="vertices"></param>
+    /// <param name="indices"></param>
+    /// <param name="firstTriangle"></param>
+    /// <param name="lastTriangle"> Exclusive </param>
+    /// <param name="culling"></param>
+    /// <param name="tilesX"> The number of tiles in a row </param>
+    /// <param name="tileCount"></param>
+    /// <param name="tileRanges"> Scratch memory for every triangle of the mesh, a chunk only uses it's own triangles </param>
+    /// <param name="arena"> The thread's arena </param>
+    /// <returns> The bin, with null pointers if the arena ran out of memory </returns>
+    TriangleBin BinTriangles(const MeshScreenVertices& vertices, const std::uint32_t* indices,
+                             std::size_t firstTriangle, std::size_t lastTriangle, TriangleCulling culling,
+                             int tilesX, int tileCount, TileRange* tileRanges, LinearArena& arena) const
+    {
+        TriangleBin bin = { nullptr, nullptr };
+
+        std::uint32_t* tileStarts = arena.TryAllocateArray<std::uint32_t>(static_cast<std::size_t>(tileCount) + 1);
+        std::uint32_t* tileEnds = arena.TryAllocateArray<std::uint32_t>(tileCount);
+
+        if ((tileStarts == nullptr) || (tileEnds == nullptr))
+            return bin;
+
+        std::fill(tileStarts, tileStarts + tileCount + 1, 0u);
+
+
+        // Count every tile's triangles, one slot ahead so the running sum below turns the counts into starts
+        std::uint32_t entryCount = 0;
+
+        for (std::size_t triangle = firstTriangle; triangle < lastTriangle; triangle++)
+        {
+            TileRange& range = tileRanges[triangle];
+
+            if (GetTriangleTileRange(vertices, indices + triangle * 3, culling, range) == false)
+            {
+                // An empty range
+                range = { 1, 1, 0, 0 };
+                continue;
+            };
+
+            for (int tileY = range.MinY; tileY <= range.MaxY; tileY++)
+                for (int tileX = range.MinX; tileX <= range.MaxX; tileX++)
+                    tileStarts[tileY * tilesX + tileX + 1]++;
+
+            entryCount += static_cast<std::uint32_t>((range.MaxX - range.MinX + 1) * (range.MaxY - range.MinY + 1));
+        };
+
+        for (int tile = 0; tile < tileCount; tile++)
+        {
+            tileStarts[tile + 1] += tileStarts[tile];
+            tileEnds[tile] = tileStarts[tile];
+        };
+
+
+        std::uint32_t* triangles = arena.TryAllocateArray<std::uint32_t>((std::max)(entryCount, 1u));
+
+        if (triangles == nullptr)
+            return bin;
+
+        for (std::size_t triangle = firstTriangle; triangle < lastTriangle; triangle++)
+        {
+            const TileRange& range = tileRanges[triangle];
+
+            for (int tileY = range.MinY; tileY <= range.MaxY; tileY++)
+                for (int tileX = range.MinX; tileX <= range.MaxX; tileX++)
+                    triangles[tileEnds[tileY * tilesX + tileX]++] = static_cast<std::uint32_t>(triangle);
+        };
+
+        bin.TileStarts = tileStarts;
+        bin.Triangles = triangles;
+
+        return bin;
+    };
+
+
+    /// <summary>
+    /// Transform a range of a mesh's vertices to screen space, 4 at a time, and find their outcodes.
+    /// Vertices without the CLIP_GUARD_BAND or CLIP_INVALID bits are also snapped
+    /// </summary>
+    /// <param name="mesh"></param>
+    /// <param name="transform"></param>
+    /// <param name="vertices"></param>
+    /// <param name="begin"></param>
+    /// <param name="end"> Exclusive </param>
+    void TransformMeshVertices(const Mesh& mesh, const Matrix3x2& transform, const MeshScreenVertices& vertices, std::size_t begin, std::size_t end) const
+    {
+        const float* positionsX = mesh.GetPositionsX();
+        const float* positionsY = mesh.GetPositionsY();
+
+        float* screenX = vertices.X;
+        float* screenY = vertices.Y;
+        FixedPointVertex* snapped = vertices.Snapped;
+        std::uint8_t* outcodes = vertices.Outcodes;
+
+        std::size_t index = begin;
+
+        for (; index + 4 <= end; index += 4)
+        {
+            const __m128 x = _mm_loadu_ps(positionsX + index);
+            const __m128 y = _mm_loadu_ps(positionsY + index);
+
+            const __m128 transformedX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(transform.M11)), _mm_mul_ps(y, _mm_set1_ps(transform.M21))), _mm_set1_ps(transform.M31));
+            const __m128 transformedY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(transform.M12)), _mm_mul_ps(y, _mm_set1_ps(transform.M22))), _mm_set1_ps(transform.M32));
+
+            _mm_storeu_ps(screenX + index, transformedX);
+            _mm_storeu_ps(screenY + index, transformedY);
+
+            // Rounds to nearest, like SnapVertex. Lanes outside the guard band overflow, but those are never used
+            const __m128i fixedX = _mm_cvtps_epi32(_mm_mul_ps(transformedX, _mm_set1_ps(static_cast<float>(SUBPIXEL_SCALE))));
+            const __m128i fixedY = _mm_cvtps_epi32(_mm_mul_ps(transformedY, _mm_set1_ps(static_cast<float>(SUBPIXEL_SCALE))));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(snapped + index), _mm_unpacklo_epi32(fixedX, fixedY));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(snapped + index + 2), _mm_unpackhi_epi32(fixedX, fixedY));
+
+
+            // The same tests as GetScreenOutcode, as 1 bit per lane
+            const __m128 absoluteMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+            const __m128 absoluteX = _mm_and_ps(transformedX, absoluteMask);
+            const __m128 absoluteY = _mm_and_ps(transformedY, absoluteMask);
+
+            const int left = _mm_movemask_ps(_mm_cmplt_ps(transformedX, _mm_set1_ps(static_cast<float>(_scissor.MinX))));
+            const int right = _mm_movemask_ps(_mm_cmpgt_ps(transformedX, _mm_set1_ps(static_cast<float>(_scissor.MaxX + 1))));
+            const int top = _mm_movemask_ps(_mm_cmplt_ps(transformedY, _mm_set1_ps(static_cast<float>(_scissor.MinY))));
+            const int bottom = _mm_movemask_ps(_mm_cmpgt_ps(transformedY, _mm_set1_ps(static_cast<float>(_scissor.MaxY + 1))));
+
+            const int guardBand = _mm_movemask_ps(_mm_or_ps(_mm_cmpgt_ps(absoluteX, _mm_set1_ps(TRIANGLE_COORDINATE_LIMIT)),
+                                                            _mm_cmpgt_ps(absoluteY, _mm_set1_ps(TRIANGLE_COORDINATE_LIMIT))));
+
+            // NaN is unordered with everything, only infinity is larger than the largest float
+            const __m128 largest = _mm_set1_ps((std::numeric_limits<float>::max)());
+
+            const int invalid = _mm_movemask_ps(_mm_or_ps(_mm_cmpunord_ps(transformedX, transformedY),
+                                                          _mm_or_ps(_mm_cmpgt_ps(absoluteX, largest), _mm_cmpgt_ps(absoluteY, largest))));
+
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if (((invalid >> lane) & 1) != 0)
+                {
+                    outcodes[index + lane] = CLIP_INVALID;
+                    continue;
+                };
+
+                outcodes[index + lane] = static_cast<std::uint8_t>((((left >> lane) & 1) * CLIP_LEFT) |
+                                                                   (((right >> lane) & 1) * CLIP_RIGHT) |
+                                                                   (((top >> lane) & 1) * CLIP_TOP) |
+                                                                   (((bottom >> lane) & 1) * CLIP_BOTTOM) |
+                                                                   (((guardBand >> lane) & 1) * CLIP_GUARD_BAND));
+            };
+        };
+
+        for (; index < end; index++)
+        {
+            screenX[index] = positionsX[index] * transform.M11 + positionsY[index] * transform.M21 + transform.M31;
+            screenY[index] = positionsX[index] * transform.M12 + positionsY[index] * transform.M22 + transform.M32;
+
+            outcodes[index] = GetScreenOutcode(screenX[index], screenY[index]);
+
+            snapped[index] = ((outcodes[index] & (CLIP_GUARD_BAND | CLIP_INVALID)) == 0) ? SnapVertex({ screenX[index], screenY[index] }) : FixedPointVertex { 0, 0 };
+        };
+    };
+
+
+    /// <summary>
+    /// Test and fill the pixels of a triangle in a rectangle, one pixel at a time
+    /// </summary>
+    /// <param name="edges"></param>
+    /// <param name="minX"></param>
+    /// <param name="minY"></param>
+    /// <param name="maxX"> Inclusive </param>
+    /// <param name="maxY"> Inclusive </param>
+    /// <param name="colour"></param>
+    void FillTrianglePixels(const TriangleEdge(&edges)[3], int minX, int minY, int maxX, int maxY, const Colour& colour)
+    {
+        for (int y = minY; y <= maxY; y++)
+        {
+            std::int64_t w0 = edges[0].Evaluate(minX, y);
+            std::int64_t w1 = edges[1].Evaluate(minX, y);
+            std::int64_t w2 = edges[2].Evaluate(minX, y);
+
+            Colour* row = _pixelData.GetRow(y);
+
+            for (int x = minX; x <= maxX; x++)
+            {
+                if ((w0 | w1 | w2) >= 0)
+                    row[x] = colour;
+
+                w0 += edges[0].StepX * SUBPIXEL_SCALE;
+                w1 += edges[1].StepX * SUBPIXEL_SCALE;
+                w2 += edges[2].StepX * SUBPIXEL_SCALE;
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Find how much of a block a triangle covers, and rebase the triangle's edges to the block if it's partially covered
+    /// </summary>
+    /// <param name="edges"></param>
+    /// <param name="blockX"></param>
+    /// <param name="blockY"></param>
+    /// <param name="blockEdges"> Only set if the block is partially covered </param>
+    /// <returns></returns>
+    static TriangleBlockCoverage ClassifyTriangleBlock(const TriangleEdge(&edges)[3], int blockX, int blockY, TriangleBlockEdges& blockEdges)
+    {
+        static_assert(TRIANGLE_BLOCK_SIZE == 8, "A block row is tested as 2 groups of 4 pixels");
+
+        std::int32_t stepsX[3];
+
+        int insideEdges = 0;
+
+        for (int index = 0; index < 3; index++)
+        {
+            const TriangleEdge& edge = edges[index];
+
+            const std::int64_t topLeft = edge.Evaluate(blockX, blockY);
+
+            const std::int64_t acrossX = edge.StepX * (SUBPIXEL_SCALE * (TRIANGLE_BLOCK_SIZE - 1));
+            const std::int64_t acrossY = edge.StepY * (SUBPIXEL_SCALE * (TRIANGLE_BLOCK_SIZE - 1));
+
+            // The function is linear, so it's smallest and largest values in the block are at the corners
+            const std::int64_t smallest = topLeft + (std::min)(acrossX, std::int64_t(0)) + (std::min)(acrossY, std::int64_t(0));
+            const std::int64_t largest = topLeft + (std::max)(acrossX, std::int64_t(0)) + (std::max)(acrossY, std::int64_t(0));
+
+            // The whole block is outside of this edge
+            if (largest < 0)
+                return TriangleBlockCoverage::Outside;
+
+            if (smallest >= 0)
+            {
+                insideEdges++;
+
+                blockEdges.FirstValues[index] = 0;
+                blockEdges.StepsY[index] = 0;
+                stepsX[index] = 0;
+            }
+            else
+            {
+                blockEdges.FirstValues[index] = static_cast<std::int32_t>(topLeft);
+                blockEdges.StepsY[index] = static_cast<std::int32_t>(edge.StepY * SUBPIXEL_SCALE);
+                stepsX[index] = static_cast<std::int32_t>(edge.StepX * SUBPIXEL_SCALE);
+            };
+        };
+
+        if (insideEdges == 3)
+            return TriangleBlockCoverage::Full;
+
+        for (int index = 0; index < 3; index++)
+        {
+            const std::int32_t step = stepsX[index];
+
+            blockEdges.LeftOffsets[index] = _mm_setr_epi32(0, step, step * 2, step * 3);
+            blockEdges.RightOffsets[index] = _mm_add_epi32(blockEdges.LeftOffsets[index], _mm_set1_epi32(step * 4));
+        };
+
+        return TriangleBlockCoverage::Partial;
+    };
+
+
+    /// <summary>
+    /// Test a row of a partially covered block
+    /// </summary>
+    /// <param name="blockEdges"></param>
+    /// <param name="row"> The row in the block </param>
+    /// <param name="leftOutside"> All 1 bits in the lanes of the row's left 4 pixels that are outside </param>
+    /// <param name="rightOutside"></param>
+    static void TestTriangleBlockRow(const TriangleBlockEdges& blockEdges, int row, __m128i& leftOutside, __m128i& rightOutside)
+    {
+        __m128i leftSigns = _mm_setzero_si128();
+        __m128i rightSigns = _mm_setzero_si128();
+
+        // A pixel is inside if none of it's edge values is negative, so OR the sign bits together
+        for (int index = 0; index < 3; index++)
+        {
+            const __m128i rowValue = _mm_set1_epi32(blockEdges.FirstValues[index] + blockEdges.StepsY[index] * row);
+
+            leftSigns = _mm_or_si128(leftSigns, _mm_add_epi32(rowValue, blockEdges.LeftOffsets[index]));
+            rightSigns = _mm_or_si128(rightSigns, _mm_add_epi32(rowValue, blockEdges.RightOffsets[index]));
+        };
+
+        leftOutside = _mm_srai_epi32(leftSigns, 31);
+        rightOutside = _mm_srai_epi32(rightSigns, 31);
+    };
+
+
+    /// <summary>
+    /// Fill the pixels of a triangle in a block that is entirely inside the frame
+    /// </summary>
+    /// <param name="edges"></param>
+    /// <param name="blockX"></param>
+    /// <param name="blockY"></param>
+    /// <param name="colour"> The colour in every lane </param>
+    void FillTriangleBlock(const TriangleEdge(&edges)[3], int blockX, int blockY, __m128i colour)
+    {
+        TriangleBlockEdges blockEdges;
+
+        const TriangleBlockCoverage coverage = ClassifyTriangleBlock(edges, blockX, blockY, blockEdges);
+
+        if (coverage == TriangleBlockCoverage::Outside)
+            return;
+
+        // Fully covered, no pixel has to be tested
+        if (coverage == TriangleBlockCoverage::Full)
+        {
+            for (int y = blockY; y < blockY + TRIANGLE_BLOCK_SIZE; y++)
+            {
+                __m128i* row = reinterpret_cast<__m128i*>(_pixelData.GetRow(y) + blockX);
+
+                _mm_storeu_si128(row, colour);
+                _mm_storeu_si128(row + 1, colour);
+            };
+
+            return;
+        };
+
+
+        // Partially covered, test every pixel and only replace the ones that are inside
+        for (int y = 0; y < TRIANGLE_BLOCK_SIZE; y++)
+        {
+            __m128i* row = reinterpret_cast<__m128i*>(_pixelData.GetRow(blockY + y) + blockX);
+
+            __m128i leftOutside;
+            __m128i rightOutside;
+
+            TestTriangleBlockRow(blockEdges, y, leftOutside, rightOutside);
+
+            _mm_storeu_si128(row, _mm_or_si128(_mm_and_si128(leftOutside, _mm_loadu_si128(row)),
+                                               _mm_andnot_si128(leftOutside, colour)));
+
+            _mm_storeu_si128(row + 1, _mm_or_si128(_mm_and_si128(rightOutside, _mm_loadu_si128(row + 1)),
+                                                   _mm_andnot_si128(rightOutside, colour)));
+        };
+    };
+
+
+    /// <summary>
+    /// Fill a triangle with interpolated shading attributes, see DrawShadedMesh
+    /// </summary>
+    /// <param name="v0"></param>
+    /// <param name="v1"></param>
+    /// <param name="v2"></param>
+    /// <param name="a0"> v0's attributes </param>
+    /// <param name="a1"></param>
+    /// <param name="a2"></param>
+    /// <param name="texture"> Can be null </param>
+    /// <param name="filter"></param>
+    /// <param name="culling"></param>
+    void FillShadedTriangle(FixedPointVertex v0, FixedPointVertex v1, FixedPointVertex v2,
+                            const ShadedVertex& a0, ShadedVertex a1, ShadedVertex a2,
+                            const ImageBuffer* texture, TextureFilter filter, TriangleCulling culling)
+    {
+        TriangleBounds bounds;
+        bool swapped;
+
+        if (SetupTriangle(v0, v1, v2, culling, _scissor, bounds, swapped) == false)
+            return;
+
+        if (swapped == true)
+            std::swap(a1, a2);
+
+        const TriangleEdge edges[3] =
+        {
+            TriangleEdge(v1, v2),
+            TriangleEdge(v2, v0),
+            TriangleEdge(v0, v1),
+        };
+
+
+        // Every attribute's screen space gradient, from the snapped positions
+        const float originX = static_cast<float>(v0.X) / SUBPIXEL_SCALE;
+        const float originY = static_cast<float>(v0.Y) / SUBPIXEL_SCALE;
+
+        const float edge1X = static_cast<float>(v1.X - v0.X) / SUBPIXEL_SCALE;
+        const float edge1Y = static_cast<float>(v1.Y - v0.Y) / SUBPIXEL_SCALE;
+        const float edge2X = static_cast<float>(v2.X - v0.X) / SUBPIXEL_SCALE;
+        const float edge2Y = static_cast<float>(v2.Y - v0.Y) / SUBPIXEL_SCALE;
+
+        const float inverseDeterminant = 1.0f / (edge1X * edge2Y - edge2X * edge1Y);
+
+        AttributePlane planes[SHADED_ATTRIBUTE_COUNT];
+
+        for (int index = 0; index < SHADED_ATTRIBUTE_COUNT; index++)
+        {
+            const float delta1 = a1.Values[index] - a0.Values[index];
+            const float delta2 = a2.Values[index] - a0.Values[index];
+
+            planes[index].Value = a0.Values[index];
+            planes[index].StepX = (delta1 * edge2Y - delta2 * edge1Y) * inverseDeterminant;
+            planes[index].StepY = (delta2 * edge1X - delta1 * edge2X) * inverseDeterminant;
+        };
+
+
+        // 1/W is linear, so it's between the vertices' smallest and largest everywhere inside the triangle
+        const float minInverseW = (std::min)({ a0.Values[0], a1.Values[0], a2.Values[0] });
+        const float maxInverseW = (std::max)({ a0.Values[0], a1.Values[0], a2.Values[0] });
+
+
+        // Blocks are aligned to the frame, not to the bounding box
+        const int firstBlockX = bounds.MinX & ~(TRIANGLE_BLOCK_SIZE - 1);
+        const int firstBlockY = bounds.MinY & ~(TRIANGLE_BLOCK_SIZE - 1);
+
+        for (int blockY = firstBlockY; blockY <= bounds.MaxY; blockY += TRIANGLE_BLOCK_SIZE)
+            for (int blockX = firstBlockX; blockX <= bounds.MaxX; blockX += TRIANGLE_BLOCK_SIZE)
+                ShadeTriangleBlock(edges, planes, originX, originY, minInverseW, maxInverseW, blockX, blockY, texture, filter);
+    };
+
+
+    /// <summary>
+    /// Shade the pixels of a triangle in a block, the block can be cut by the scissor.
+    /// With the depth buffer enabled, the block is skipped if it's nearest and farthest depth show the triangle is behind everything in it
+    /// </summary>
+    /// <param name="edges"></param>
+    /// <param name="planes"></param>
+    /// <param name="originX"> The point the planes are relative to </param>
+    /// <param name="originY"></param>
+    /// <param name="minInverseW"> The triangle's range of 1/W </param>
+    /// <param name="maxInverseW"></param>
+    /// <param name="blockX"></param>
+    /// <param name="blockY"></param>
+    /// <param name="texture"></param>
+    /// <param name="filter"></param>
+    void ShadeTriangleBlock(const TriangleEdge(&edges)[3], const AttributePlane(&planes)[SHADED_ATTRIBUTE_COUNT],
+                            float originX, float originY,
+                            float minInverseW, float maxInverseW,
+                            int blockX, int blockY,
+                            const ImageBuffer* texture, TextureFilter filter)
+    {
+        static_assert(DepthBuffer::BLOCK_SIZE == TRIANGLE_BLOCK_SIZE, "Depth buffer blocks are the rasterizer's blocks");
+
+        // The centres of the block's 4 corner pixels
+        const float firstCentreX = blockX + 0.5f - originX;
+        const float lastCentreX = firstCentreX + (TRIANGLE_BLOCK_SIZE - 1);
+        const float firstCentreY = blockY + 0.5f - originY;
+        const float lastCentreY = firstCentreY + (TRIANGLE_BLOCK_SIZE - 1);
+
+        const __m128 cornersX = _mm_setr_ps(firstCentreX, lastCentreX, firstCentreX, lastCentreX);
+        const __m128 cornersY = _mm_setr_ps(firstCentreY, firstCentreY, lastCentreY, lastCentreY);
+
+        const auto evaluatePlane = [cornersX, cornersY](const AttributePlane& plane)
+        {
+            return _mm_add_ps(_mm_set1_ps(plane.Value),
+                              _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.StepX), cornersX),
+                                         _mm_mul_ps(_mm_set1_ps(plane.StepY), cornersY)));
+        };
+
+
+        // A row's depths are it's first pixel's plus these
+        const __m128 depthLeftOffsets = _mm_mul_ps(_mm_set1_ps(planes[0].StepX), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+        const __m128 depthRightOffsets = _mm_mul_ps(_mm_set1_ps(planes[0].StepX), _mm_setr_ps(4.0f, 5.0f, 6.0f, 7.0f));
+
+        const auto getRowDepth = [&planes, firstCentreX, firstCentreY](int y)
+        {
+            return _mm_set1_ps(planes[0].Value + planes[0].StepX * firstCentreX + planes[0].StepY * (firstCentreY + y));
+        };
+
+        const bool depthBufferEnabled = (_depthBuffer.IsEmpty() == false);
+        bool testDepth = false;
+
+        if (depthBufferEnabled == true)
+        {
+            // 1/W is linear, so the triangle's depth over the block is between it's corner pixels' smallest and largest.
+            // They're calculated exactly like the pixels' depths below, so the bounds hold after rounding too
+            const __m128 topDepths = _mm_shuffle_ps(_mm_add_ps(getRowDepth(0), depthLeftOffsets), _mm_add_ps(getRowDepth(0), depthRightOffsets), _MM_SHUFFLE(3, 3, 0, 0));
+            const __m128 bottomDepths = _mm_shuffle_ps(_mm_add_ps(getRowDepth(TRIANGLE_BLOCK_SIZE - 1), depthLeftOffsets), _mm_add_ps(getRowDepth(TRIANGLE_BLOCK_SIZE - 1), depthRightOffsets), _MM_SHUFFLE(3, 3, 0, 0));
+
+            alignas(16) float cornerDepths[4];
+
+            _mm_store_ps(cornerDepths, _mm_max_ps(topDepths, bottomDepths));
+            const float triangleNearest = (std::max)(cornerDepths[0], cornerDepths[2]);
+
+            _mm_store_ps(cornerDepths, _mm_min_ps(topDepths, bottomDepths));
+            const float triangleFarthest = (std::min)(cornerDepths[0], cornerDepths[2]);
+
+            const int blockColumn = blockX / TRIANGLE_BLOCK_SIZE;
+            const int blockRow = blockY / TRIANGLE_BLOCK_SIZE;
+
+            // Everything drawn in the block so far is in front of the triangle
+            if (triangleNearest <= _depthBuffer.GetBlockFarthest(blockColumn, blockRow))
+                return;
+
+            // Unless the triangle is in front of everything in the block, every pixel has to be tested
+            testDepth = (triangleFarthest <= _depthBuffer.GetBlockNearest(blockColumn, blockRow));
+        };
+
+
+        TriangleBlockEdges blockEdges;
+
+        const TriangleBlockCoverage coverage = ClassifyTriangleBlock(edges, blockX, blockY, blockEdges);
+
+        if (coverage == TriangleBlockCoverage::Outside)
+            return;
+
+        // The block's columns and rows that are inside the scissor
+        const int firstColumn = (std::max)(0, _scissor.MinX - blockX);
+        const int firstRow = (std::max)(0, _scissor.MinY - blockY);
+
+        const int columns = (std::min)(TRIANGLE_BLOCK_SIZE, _scissor.MaxX + 1 - blockX);
+        const int rows = (std::min)(TRIANGLE_BLOCK_SIZE, _scissor.MaxY + 1 - blockY);
+
+        const int scissorMask = ((1 << columns) - 1) & ~((1 << firstColumn) - 1);
+
+
+        // The corners can be outside the triangle, where the extrapolated 1/W can be smaller than anywhere on the triangle or even 0 or negative
+        // past the horizon. Stepping between such corners gives the pixels garbage, so then every pixel is divided by it's own 1/W
+        const __m128 cornerInverseW = evaluatePlane(planes[0]);
+
+        const bool dividePixels = (_mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(cornerInverseW, _mm_set1_ps(minInverseW)),
+                                                             _mm_cmpgt_ps(cornerInverseW, _mm_set1_ps(maxInverseW)))) != 0);
+
+        constexpr int attributeCount = SHADED_ATTRIBUTE_COUNT - 1;
+
+        // [attribute][corner], corners are top left, top right, bottom left, bottom right
+        alignas(16) float corners[attributeCount][4];
+
+        // The attributes at the corners.
+        // This is the only division, 1/W for all 4 corners at once
+        if (dividePixels == false)
+        {
+            const __m128 cornerW = _mm_div_ps(_mm_set1_ps(1.0f), cornerInverseW);
+
+            for (int index = 0; index < attributeCount; index++)
+                _mm_store_ps(corners[index], _mm_mul_ps(evaluatePlane(planes[index + 1]), cornerW));
+        };
+
+
+        constexpr float inverseSpan = 1.0f / (TRIANGLE_BLOCK_SIZE - 1);
+
+        bool depthWritten = false;
+
+        for (int y = firstRow; y < rows; y++)
+        {
+            int covered = scissorMask;
+
+            if (coverage == TriangleBlockCoverage::Partial)
+            {
+                __m128i leftOutside;
+                __m128i rightOutside;
+
+                TestTriangleBlockRow(blockEdges, y, leftOutside, rightOutside);
+
+                const int outside = _mm_movemask_ps(_mm_castsi128_ps(leftOutside)) | (_mm_movemask_ps(_mm_castsi128_ps(rightOutside)) << 4);
+
+                covered &= ~outside;
+            };
+
+            if (covered == 0)
+                continue;
+
+
+            float* depthRow = nullptr;
+            alignas(16) float depths[TRIANGLE_BLOCK_SIZE];
+
+            if (depthBufferEnabled == true)
+            {
+                depthRow = _depthBuffer.GetRow(blockY + y) + blockX;
+
+                const __m128 rowDepth = getRowDepth(y);
+
+                const __m128 leftDepths = _mm_add_ps(rowDepth, depthLeftOffsets);
+                const __m128 rightDepths = _mm_add_ps(rowDepth, depthRightOffsets);
+
+                _mm_store_ps(depths, leftDepths);
+                _mm_store_ps(depths + 4, rightDepths);
+
+                // Only keep the pixels that are closer than what is already there
+                if (testDepth == true)
+                {
+                    const int closer = _mm_movemask_ps(_mm_cmpgt_ps(leftDepths, _mm_loadu_ps(depthRow))) |
+                                      (_mm_movemask_ps(_mm_cmpgt_ps(rightDepths, _mm_loadu_ps(depthRow + 4))) << 4);
+
+                    covered &= closer;
+
+                    if (covered == 0)
+                        continue;
+                };
+            };
+
+
+            // The row's ends, between the block's left and right corners, and the step between 2 pixels
+            const float rowPosition = y * inverseSpan;
+
+            float values[attributeCount];
+            float steps[attributeCount];
+
+            // Without corners, the planes are stepped from the row's first pixel and divided at every pixel
+            float inverseW = 0.0f;
+            float inverseWStep = 0.0f;
+
+            if (dividePixels == true)
+            {
+                const float rowCentreY = firstCentreY + y;
+
+                for (int index = 0; index < attributeCount; index++)
+                {
+                    const AttributePlane& plane = planes[index + 1];
+
+                    values[index] = plane.Value + plane.StepX * firstCentreX + plane.StepY * rowCentreY;
+                    steps[index] = plane.StepX;
+                };
+
+                inverseW = planes[0].Value + planes[0].StepX * firstCentreX + planes[0].StepY * rowCentreY;
+                inverseWStep = planes[0].StepX;
+            }
+            else
+            {
+                for (int index = 0; index < attributeCount; index++)
+                {
+                    const float* corner = corners[index];
+
+                    const float left = corner[0] + (corner[2] - corner[0]) * rowPosition;
+                    const float right = corner[1] + (corner[3] - corner[1]) * rowPosition;
+
+                    values[index] = left;
+                    steps[index] = (right - left) * inverseSpan;
+                };
+            };
+
+            Colour* row = _pixelData.GetRow(blockY + y) + blockX;
+
+            for (int x = 0; x < columns; x++)
+            {
+                if ((covered & (1 << x)) != 0)
+                {
+                    if (dividePixels == true)
+                    {
+                        // A covered pixel is inside the triangle, so it's 1/W is positive
+                        const float w = 1.0f / inverseW;
+
+                        float dividedValues[attributeCount];
+
+                        for (int index = 0; index < attributeCount; index++)
+                            dividedValues[index] = values[index] * w;
+
+                        row[x] = ShadeTrianglePixel(dividedValues, texture, filter);
+                    }
+                    else
+                    {
+                        row[x] = ShadeTrianglePixel(values, texture, filter);
+                    };
+
+                    if (depthRow != nullptr)
+                        depthRow[x] = depths[x];
+                };
+
+                for (int index = 0; index < attributeCount; index++)
+                    values[index] += steps[index];
+
+                inverseW += inverseWStep;
+            };
+
+            depthWritten = true;
+        };
+
+        if ((depthBufferEnabled == true) && (depthWritten == true))
+            _depthBuffer.UpdateBlock(blockX / TRIANGLE_BLOCK_SIZE, blockY / TRIANGLE_BLOCK_SIZE);
+    };
+
+
+    /// <summary>
+    /// Get a pixel's colour from it's interpolated attributes
+    /// </summary>
+    /// <param name="values"> Red, green, blue, alpha, u and v </param>
+    /// <param name="texture"> Can be null </param>
+    /// <param name="filter"></param>
+    /// <returns></returns>
+    static Colour ShadeTrianglePixel(const float(&values)[SHADED_ATTRIBUTE_COUNT - 1], const ImageBuffer* texture, TextureFilter filter)
+    {
+        float red = values[0];
+        float green = values[1];
+        float blue = values[2];
+        float alpha = values[3];
+
+        // The texture is multiplied by the vertex colour
+        if (texture != nullptr)
+        {
+            const Colour texel = SampleTexture(*texture, values[4], values[5], filter);
+
+            constexpr float inverse255 = 1.0f / 255.0f;
+
+            red *= texel.Red * inverse255;
+            green *= texel.Green * inverse255;
+            blue *= texel.Blue * inverse255;
+            alpha *= texel.Alpha * inverse255;
+        };
+
+        return
+        {
+            static_cast<std::uint8_t>(std::clamp(red, 0.0f, 255.0f)),
+            static_cast<std::uint8_t>(std::clamp(green, 0.0f, 255.0f)),
+            static_cast<std::uint8_t>(std::clamp(blue, 0.0f, 255.0f)),
+            static_cast<std::uint8_t>(std::clamp(alpha, 0.0f, 255.0f)),
+        };
+    };
+
+
+    /// <summary>
+    /// Sample a texture, the texture repeats outside of [0, 1]
+    /// </summary>
+    /// <param name="texture"></param>
+    /// <param name="u"></param>
+    /// <param name="v"></param>
+    /// <param name="filter"></param>
+    /// <returns></returns>
+    static Colour SampleTexture(const ImageBuffer& texture, float u, float v, TextureFilter filter)
+    {
+        const int width = texture.GetWidth();
+        const int height = texture.GetHeight();
+
+        // Texel coordinates, texel centres are at .5
+        const float x = u * width;
+        const float y = v * height;
+
+        if (filter == TextureFilter::Nearest)
+            return texture.GetRow(WrapTexel(y, height))[WrapTexel(x, width)];
+
+
+        const float left = std::floor(x - 0.5f);
+        const float top = std::floor(y - 0.5f);
+
+        const float weightX = (x - 0.5f) - left;
+        const float weightY = (y - 0.5f) - top;
+
+        const int x0 = WrapTexel(left, width);
+        const int y0 = WrapTexel(top, height);
+        const int x1 = (x0 + 1 < width) ? x0 + 1 : 0;
+        const int y1 = (y0 + 1 < height) ? y0 + 1 : 0;
+
+        const Colour& topLeft = texture.GetRow(y0)[x0];
+        const Colour& topRight = texture.GetRow(y0)[x1];
+        const Colour& bottomLeft = texture.GetRow(y1)[x0];
+        const Colour& bottomRight = texture.GetRow(y1)[x1];
+
+        const auto blend = [weightX, weightY](std::uint8_t a, std::uint8_t b, std::uint8_t c, std::uint8_t d)
+        {
+            const float topValue = a + (b - a) * weightX;
+            const float bottomValue = c + (d - c) * weightX;
+
+            return static_cast<std::uint8_t>(topValue + (bottomValue - topValue) * weightY + 0.5f);
+        };
+
+        return
+        {
+            blend(topLeft.Red, topRight.Red, bottomLeft.Red, bottomRight.Red),
+            blend(topLeft.Green, topRight.Green, bottomLeft.Green, bottomRight.Green),
+            blend(topLeft.Blue, topRight.Blue, bottomLeft.Blue, bottomRight.Blue),
+            blend(topLeft.Alpha, topRight.Alpha, bottomLeft.Alpha, bottomRight.Alpha),
+        };
+    };
+
+
+    /// <summary>
+    /// Wrap a texel coordinate into [0, size)
+    /// </summary>
+    /// <param name="coordinate"></param>
+    /// <param name="size"></param>
+    /// <returns></returns>
+    static int WrapTexel(float coordinate, int size)
+    {
+        const float wrapped = coordinate - std::floor(coordinate / size) * size;
+
+        // Rounding can land exactly on size, and NaN fails every comparison
+        if (!(wrapped >= 0.0f) || (wrapped >= static_cast<float>(size)))
+            return 0;
+
+        return static_cast<int>(wrapped);
+    };
+
 
     void CreateD3D2DTexture(D3D11_TEXTURE2D_DESC& d3d2DTextureDescriptor)
     {
@@ -0,0 +1,318 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <mutex>
+#include <malloc.h>
+#include <emmintrin.h>
+
+#include "Colour.hpp"
+
+
+/// <summary>
+/// Recycles image buffer memory blocks, so buffers that are created and destroyed often don't hit the heap every time.
+/// The pool must outlive every ImageBuffer that was created from it
+/// </summary>
+class ImageBufferPool
+{
+
+private:
+
+    /// <summary>
+    /// A free memory block
+    /// </summary>
+    struct Block
+    {
+        void* Memory;
+        std::size_t Size;
+    };
+
+private:
+
+    /// <summary>
+    /// Blocks that were released and can be handed out again
+    /// </summary>
+    std::vector<Block> _freeBlocks;
+
+    std::mutex _mutex;
+
+
+public:
+
+    ImageBufferPool() = default;
+
+    ImageBufferPool(const ImageBufferPool&) = delete;
+    ImageBufferPool& operator = (const ImageBufferPool&) = delete;
+
+    ~ImageBufferPool()
+    {
+        for (const Block& block : _freeBlocks)
+            _aligned_free(block.Memory);
+    };
+
+
+public:
+
+    /// <summary>
+    /// Get a block of at least 'size' bytes, aligned to 'alignment'
+    /// </summary>
+    /// <param name="size"></param>
+    /// <param name="alignment"></param>
+    /// <returns></returns>
+    void* Acquire(std::size_t size, std::size_t alignment)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // Reuse a block of the exact same size, image sizes tend to repeat
+            for (std::size_t a = 0; a < _freeBlocks.size(); a++)
+            {
+                if (_freeBlocks[a].Size == size)
+                {
+                    void* memory = _freeBlocks[a].Memory;
+
+                    _freeBlocks[a] = _freeBlocks.back();
+                    _freeBlocks.pop_back();
+
+                    return memory;
+                };
+            };
+        }
+
+        return _aligned_malloc(size, alignment);
+    };
+
+    /// <summary>
+    /// Return a block to the pool
+    /// </summary>
+    /// <param name="memory"></param>
+    /// <param name="size"></param>
+    void Release(void* memory, std::size_t size)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _freeBlocks.push_back({ memory, size });
+    };
+
+};
+
+
+
+/// <summary>
+/// An owned 2D pixel buffer.
+/// Every row starts on a 64 byte boundary and the pitch is padded to a multiple of 16 pixels,
+/// so SIMD code can use aligned loads/stores and never needs a scalar tail loop
+/// </summary>
+class ImageBuffer
+{
+
+public:
+
+    /// <summary>
+    /// Row alignment in bytes, one cache line
+    /// </summary>
+    static constexpr std::size_t ROW_ALIGNMENT = 64;
+
+    /// <summary>
+    /// Number of pixels that fit in one aligned row step
+    /// </summary>
+    static constexpr std::size_t PIXELS_PER_ALIGNMENT = ROW_ALIGNMENT / sizeof(Colour);
+
+private:
+
+    Colour* _pixels = nullptr;
+
+    int _width = 0;
+    int _height = 0;
+
+    /// <summary>
+    /// Distance between 2 rows, in pixels
+    /// </summary>
+    std::size_t _pitch = 0;
+
+    /// <summary>
+    /// The pool this buffer's memory came from, null if it came from the heap
+    /// </summary>
+    ImageBufferPool* _pool = nullptr;
+
+
+public:
+
+    ImageBuffer() = default;
+
+    /// <summary>
+    /// Create a buffer, the pixels are zero initialized
+    /// </summary>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    /// <param name="pool"> Optional pool to take the memory from </param>
+    ImageBuffer(int width, int height, ImageBufferPool* pool = nullptr) :
+        _width(width),
+        _height(height),
+        _pitch(((static_cast<std::size_t>(width) + PIXELS_PER_ALIGNMENT - 1) / PIXELS_PER_ALIGNMENT) * PIXELS_PER_ALIGNMENT),
+        _pool(pool)
+    {
+        if (GetSizeInBytes() == 0)
+            return;
+
+        if (_pool != nullptr)
+            _pixels = static_cast<Colour*>(_pool->Acquire(GetSizeInBytes(), ROW_ALIGNMENT));
+        else
+            _pixels = static_cast<Colour*>(_aligned_malloc(GetSizeInBytes(), ROW_ALIGNMENT));
+
+        if (_pixels == nullptr)
+        {
+            throw std::exception("Unable to allocate image buffer");
+        };
+
+        Clear();
+    };
+
+    ImageBuffer(ImageBuffer&& other) noexcept
+    {
+        MoveFrom(other);
+    };
+
+    ImageBuffer& operator = (ImageBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Free();
+            MoveFrom(other);
+        };
+
+        return *this;
+    };
+
+    ImageBuffer(const ImageBuffer&) = delete;
+    ImageBuffer& operator = (const ImageBuffer&) = delete;
+
+    ~ImageBuffer()
+    {
+        Free();
+    };
+
+
+public:
+
+    /// <summary>
+    /// Set every pixel (including row padding) to 0
+    /// </summary>
+    void Clear()
+    {
+        if (_pixels != nullptr)
+            std::memset(_pixels, 0, GetSizeInBytes());
+    };
+
+    /// <summary>
+    /// Set every pixel to a colour
+    /// </summary>
+    /// <param name="colour"></param>
+    void Fill(const Colour& colour)
+    {
+        std::uint32_t packed = 0;
+        std::memcpy(&packed, &colour, sizeof(packed));
+
+        const __m128i fillValue = _mm_set1_epi32(static_cast<int>(packed));
+
+        // The buffer is aligned and padded, so it's filled in whole aligned 16 byte stores
+        __m128i* destination = reinterpret_cast<__m128i*>(_pixels);
+        const std::size_t count = GetSizeInBytes() / sizeof(__m128i);
+
+        for (std::size_t a = 0; a < count; a++)
+            _mm_store_si128(destination + a, fillValue);
+    };
+
+
+    Colour* GetRow(int y)
+    {
+        return _pixels + static_cast<std::size_t>(y) * _pitch;
+    };
+
+    const Colour* GetRow(int y) const
+    {
+        return _pixels + static_cast<std::size_t>(y) * _pitch;
+    };
+
+    Colour& GetPixel(int x, int y)
+    {
+        return GetRow(y)[x];
+    };
+
+    const Colour& GetPixel(int x, int y) const
+    {
+        return GetRow(y)[x];
+    };
+
+
+    Colour* GetData()
+    {
+        return _pixels;
+    };
+
+    const Colour* GetData() const
+    {
+        return _pixels;
+    };
+
+    int GetWidth() const
+    {
+        return _width;
+    };
+
+    int GetHeight() const
+    {
+        return _height;
+    };
+
+    /// <summary>
+    /// Get the distance between 2 rows, in pixels
+    /// </summary>
+    /// <returns></returns>
+    std::size_t GetPitch() const
+    {
+        return _pitch;
+    };
+
+    std::size_t GetSizeInBytes() const
+    {
+        return _pitch * static_cast<std::size_t>(_height) * sizeof(Colour);
+    };
+
+    bool IsEmpty() const
+    {
+        return _pixels == nullptr;
+    };
+
+
+private:
+
+    void Free()
+    {
+        if (_pixels == nullptr)
+            return;
+
+        if (_pool != nullptr)
+            _pool->Release(_pixels, GetSizeInBytes());
+        else
+            _aligned_free(_pixels);
+
+        _pixels = nullptr;
+    };
+
+    void MoveFrom(ImageBuffer& other)
+    {
+        _pixels = other._pixels;
+        _width = other._width;
+        _height = other._height;
+        _pitch = other._pitch;
+        _pool = other._pool;
+
+        other._pixels = nullptr;
+        other._width = 0;
+        other._height = 0;
+        other._pitch = 0;
+        other._pool = nullptr;
+    };
+
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <emmintrin.h>
+
+#include "Colour.hpp"
+#include "ImageBuffer.hpp"
+
+
+/// <summary>
+/// Cache blocked, SSE2 image transposition.
+/// Column oriented renderers (ray casters, sprite columns) can draw every column as a contiguous row of a column-major scratch buffer,
+/// then transpose the result into the row-major framebuffer in one pass
+/// </summary>
+namespace ImageTranspose
+{
+
+    /// <summary>
+    /// Size of a square block in pixels. 16 pixels are exactly one cache line,
+    /// so a block touches 16 source lines and 16 destination lines
+    /// </summary>
+    inline constexpr int BLOCK_SIZE = 16;
+
+
+    /// <summary>
+    /// Transpose a single 4x4 pixel tile
+    /// </summary>
+    /// <param name="source"></param>
+    /// <param name="sourcePitch"> Distance between 2 source rows, in pixels </param>
+    /// <param name="destination"></param>
+    /// <param name="destinationPitch"> Distance between 2 destination rows, in pixels </param>
+    inline void Transpose4x4(const Colour* source, std::size_t sourcePitch,
+                             Colour* destination, std::size_t destinationPitch)
+    {
+        const __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        const __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + sourcePitch));
+        const __m128i row2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + sourcePitch * 2));
+        const __m128i row3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + sourcePitch * 3));
+
+        // a0 b0 a1 b1, c0 d0 c1 d1, a2 b2 a3 b3, c2 d2 c3 d3
+        const __m128i low01 = _mm_unpacklo_epi32(row0, row1);
+        const __m128i low23 = _mm_unpacklo_epi32(row2, row3);
+        const __m128i high01 = _mm_unpackhi_epi32(row0, row1);
+        const __m128i high23 = _mm_unpackhi_epi32(row2, row3);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_unpacklo_epi64(low01, low23));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + destinationPitch), _mm_unpackhi_epi64(low01, low23));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + destinationPitch * 2), _mm_unpacklo_epi64(high01, high23));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + destinationPitch * 3), _mm_unpackhi_epi64(high01, high23));
+    };
+
+
+    /// <summary>
+    /// Transpose the source rows [beginRow, endRow) into destination columns.
+    /// Source pixel (x, y) is written to destination pixel (y, x).
+    /// Disjoint row ranges write to disjoint destination columns, so ranges can be transposed on different threads
+    /// </summary>
+    /// <param name="source"></param>
+    /// <param name="sourcePitch"> Distance between 2 source rows, in pixels </param>
+    /// <param name="sourceWidth"> Number of pixels in a source row, which is the number of destination rows written </param>
+    /// <param name="beginRow"></param>
+    /// <param name="endRow"></param>
+    /// <param name="destination"></param>
+    /// <param name="destinationPitch"> Distance between 2 destination rows, in pixels </param>
+    inline void Transpose(const Colour* source, std::size_t sourcePitch, int sourceWidth,
+                          int beginRow, int endRow,
+                          Colour* destination, std::size_t destinationPitch)
+    {
+        for (int blockRow = beginRow; blockRow < endRow; blockRow += BLOCK_SIZE)
+        {
+            const int blockRowEnd = (std::min)(blockRow + BLOCK_SIZE, endRow);
+
+            // Rows that can be handled as whole 4x4 tiles
+            const int tiledRowEnd = blockRow + ((blockRowEnd - blockRow) / 4) * 4;
+
+            for (int blockColumn = 0; blockColumn < sourceWidth; blockColumn += BLOCK_SIZE)
+            {
+                const int blockColumnEnd = (std::min)(blockColumn + BLOCK_SIZE, sourceWidth);
+                const int tiledColumnEnd = blockColumn + ((blockColumnEnd - blockColumn) / 4) * 4;
+
+                for (int y = blockRow; y < tiledRowEnd; y += 4)
+                {
+                    const Colour* sourceRow = source + static_cast<std::size_t>(y) * sourcePitch;
+
+                    int x = blockColumn;
+
+                    for (; x < tiledColumnEnd; x += 4)
+                        Transpose4x4(sourceRow + x, sourcePitch, destination + static_cast<std::size_t>(x) * destinationPitch + y, destinationPitch);
+
+                    // Leftover columns at the right edge of the image
+                    for (; x < blockColumnEnd; x++)
+                        for (int tileY = y; tileY < y + 4; tileY++)
+                            destination[static_cast<std::size_t>(x) * destinationPitch + tileY] = source[static_cast<std::size_t>(tileY) * sourcePitch + x];
+                };
+
+                // Leftover rows at the end of the range
+                for (int y = tiledRowEnd; y < blockRowEnd; y++)
+                    for (int x = blockColumn; x < blockColumnEnd; x++)
+                        destination[static_cast<std::size_t>(x) * destinationPitch + y] = source[static_cast<std::size_t>(y) * sourcePitch + x];
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Transpose the rows [beginRow, endRow) of an image into destination columns
+    /// </summary>
+    /// <param name="source"></param>
+    /// <param name="beginRow"></param>
+    /// <param name="endRow"></param>
+    /// <param name="destination"></param>
+    /// <param name="destinationPitch"> Distance between 2 destination rows, in pixels </param>
+    inline void Transpose(const ImageBuffer& source, int beginRow, int endRow,
+                          Colour* destination, std::size_t destinationPitch)
+    {
+        Transpose(source.GetData(), source.GetPitch(), source.GetWidth(), beginRow, endRow, destination, destinationPitch);
+    };
+
+};
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include "Vector2D.hpp"
+#include "Colour.hpp"
+
+
+/// <summary>
+/// Which triangles of a mesh are not drawn
+/// </summary>
+enum class TriangleCulling
+{
+    /// <summary>
+    /// Draw every triangle
+    /// </summary>
+    None = 0,
+
+    /// <summary>
+    /// Skip triangles facing away, front faces are counter-clockwise as seen on screen
+    /// </summary>
+    Back = 1,
+};
+
+
+/// <summary>
+/// How a texture is sampled between it's texels
+/// </summary>
+enum class TextureFilter
+{
+    /// <summary>
+    /// The closest texel
+    /// </summary>
+    Nearest = 0,
+
+    /// <summary>
+    /// A weighted average of the 4 closest texels
+    /// </summary>
+    Bilinear = 1,
+};
+
+
+/// <summary>
+/// An indexed triangle mesh.
+/// Vertex positions are stored as separate X and Y arrays so a whole mesh can be transformed 4 vertices at a time,
+/// every 3 indices form a triangle.
+/// Every vertex also has a colour, a texture coordinate and a W, which DrawShadedMesh interpolates across the triangles.
+/// DrawMesh ignores W, DrawShadedMesh divides the positions by it
+/// </summary>
+class Mesh
+{
+
+private:
+
+    std::vector<float> _positionsX;
+    std::vector<float> _positionsY;
+
+    std::vector<Colour> _colours;
+
+    /// <summary>
+    /// Texture coordinates, [0, 1] covers the texture once, it repeats outside of that
+    /// </summary>
+    std::vector<float> _textureU;
+    std::vector<float> _textureV;
+
+    /// <summary>
+    /// The vertices' W, their depth from the camera, 1 for flat 2D meshes.
+    /// DrawShadedMesh treats (X, Y, W) as a homogeneous position and draws the vertex at (X / W, Y / W),
+    /// attributes are interpolated with 1/W so they stay perspective correct
+    /// </summary>
+    std::vector<float> _w;
+
+    std::vector<std::uint32_t> _indices;
+
+
+public:
+
+    Mesh() = default;
+
+
+public:
+
+    void Reserve(std::size_t vertexCount, std::size_t triangleCount)
+    {
+        _positionsX.reserve(vertexCount);
+        _positionsY.reserve(vertexCount);
+
+        _colours.reserve(vertexCount);
+        _textureU.reserve(vertexCount);
+        _textureV.reserve(vertexCount);
+        _w.reserve(vertexCount);
+
+        _indices.reserve(triangleCount * 3);
+    };
+
+
+    /// <summary>
+    /// Add a vertex
+    /// </summary>
+    /// <param name="position"></param>
+    /// <returns> The vertex's index </returns>
+    std::uint32_t AddVertex(const Vector2D& position)
+    {
+        return AddVertex(position, Colours::White, { 0.0f, 0.0f });
+    };
+
+    /// <summary>
+    /// Add a vertex with it's shading attributes
+    /// </summary>
+    /// <param name="position"></param>
+    /// <param name="colour"></param>
+    /// <param name="textureCoordinate"></param>
+    /// <param name="w"> Can be 0 or negative, DrawShadedMesh clips the triangles at it's near plane </param>
+    /// <returns> The vertex's index </returns>
+    std::uint32_t AddVertex(const Vector2D& position, const Colour& colour, const Vector2D& textureCoordinate, float w = 1.0f)
+    {
+        _positionsX.push_back(position.X);
+        _positionsY.push_back(position.Y);
+
+        _colours.push_back(colour);
+        _textureU.push_back(textureCoordinate.X);
+        _textureV.push_back(textureCoordinate.Y);
+        _w.push_back(w);
+
+        return static_cast<std::uint32_t>(_positionsX.size() - 1);
+    };
+
+
+    /// <summary>
+    /// Add a triangle made of 3 existing vertices
+    /// </summary>
+    /// <param name="index0"></param>
+    /// <param name="index1"></param>
+    /// <param name="index2"></param>
+    void AddTriangle(std::uint32_t index0, std::uint32_t index1, std::uint32_t index2)
+    {
+        if ((index0 >= _positionsX.size()) ||
+            (index1 >= _positionsX.size()) ||
+            (index2 >= _positionsX.size()))
+        {
+            throw std::exception("Triangle index is out of range");
+        };
+
+        _indices.push_back(index0);
+        _indices.push_back(index1);
+        _indices.push_back(index2);
+    };
+
+
+    void Clear()
+    {
+        _positionsX.clear();
+        _positionsY.clear();
+
+        _colours.clear();
+        _textureU.clear();
+        _textureV.clear();
+        _w.clear();
+
+        _indices.clear();
+    };
+
+
+public:
+
+    std::size_t GetVertexCount() const
+    {
+        return _positionsX.size();
+    };
+
+    std::size_t GetTriangleCount() const
+    {
+        return _indices.size() / 3;
+    };
+
+    const float* GetPositionsX() const
+    {
+        return _positionsX.data();
+    };
+
+    const float* GetPositionsY() const
+    {
+        return _positionsY.data();
+    };
+
+    const Colour* GetColours() const
+    {
+        return _colours.data();
+    };
+
+    const float* GetTextureU() const
+    {
+        return _textureU.data();
+    };
+
+    const float* GetTextureV() const
+    {
+        return _textureV.data();
+    };
+
+    const float* GetW() const
+    {
+        return _w.data();
+    };
+
+    const std::uint32_t* GetIndices() const
+    {
+        return _indices.data();
+    };
+
+};
@@ -0,0 +1,274 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+#include "Graphics.hpp"
+#include "Mesh.hpp"
+#include "Matrix3x2.hpp"
+#include "FrameArena.hpp"
+#include "WorkerPool.hpp"
+
+
+/// <summary>
+/// Measures how DrawMeshParallel scales from 1 thread to every hardware thread, without a window or a device.
+/// Every run must render the exact same frame as DrawMesh, which is checked with the frame's hash.
+/// Also measures how much the depth buffer saves when overlapping layers are drawn front to back instead of back to front
+/// </summary>
+class RasterBenchmark
+{
+
+private:
+
+    static constexpr int FRAME_WIDTH = 1280;
+    static constexpr int FRAME_HEIGHT = 720;
+
+    static constexpr int ITERATIONS = 20;
+
+    static constexpr int DEPTH_LAYERS = 16;
+
+
+public:
+
+    /// <summary>
+    /// Run the benchmark, the results are written to a file and to the debugger output
+    /// </summary>
+    /// <param name="resultsFile"></param>
+    static void Run(const std::wstring& resultsFile)
+    {
+        std::ofstream file(resultsFile);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to create raster benchmark results file");
+        };
+
+        Graphics graphics(FRAME_WIDTH, FRAME_HEIGHT);
+        graphics.SetupHeadless();
+
+        // Rotated a little around the frame's centre, so the edges aren't axis aligned
+        const Matrix3x2 transform = Matrix3x2::Translation(-FRAME_WIDTH / 2.0f, -FRAME_HEIGHT / 2.0f) *
+                                    Matrix3x2::Rotation(0.1f) *
+                                    Matrix3x2::Translation(FRAME_WIDTH / 2.0f, FRAME_HEIGHT / 2.0f);
+
+        // Many tiny triangles, and a few large ones that are mostly fill
+        const Mesh smallTriangles = BuildGrid(256, 144, 5.0f, 1);
+        const Mesh largeTriangles = BuildGrid(16, 9, 80.0f, 8);
+
+        const unsigned int hardwareThreads = (std::max)(1u, std::thread::hardware_concurrency());
+
+        char line[128];
+
+        for (const Mesh* mesh : { &smallTriangles, &largeTriangles })
+        {
+            const double serialTime = Measure(graphics, [&]()
+            {
+                graphics.DrawMesh(*mesh, transform, Colours::White, TriangleCulling::None);
+            });
+
+            const std::uint64_t referenceHash = graphics.GetFrameHash();
+
+            std::snprintf(line, sizeof(line), "%zu triangles: DrawMesh %.3f ms\n", mesh->GetTriangleCount(), serialTime);
+            WriteLine(file, line);
+
+            double singleThreadTime = 0.0;
+
+            // 1, 2, 4 ... threads, and finally every hardware thread
+            for (unsigned int threadCount = 1; ; threadCount = (std::min)(threadCount * 2, hardwareThreads))
+            {
+                WorkerPool workerPool(threadCount);
+
+                // DrawMeshParallel only bins into the thread arenas
+                FrameArena frameArena(0, threadCount, 4 * 1024 * 1024);
+
+                const double time = Measure(graphics, [&]()
+                {
+                    frameArena.Reset();
+                    graphics.DrawMeshParallel(*mesh, transform, Colours::White, TriangleCulling::None, workerPool, frameArena);
+                });
+
+                if (threadCount == 1)
+                    singleThreadTime = time;
+
+                std::snprintf(line, sizeof(line), "  %u threads: %.3f ms, %.2fx%s\n",
+                              threadCount, time, singleThreadTime / time,
+                              (graphics.GetFrameHash() == referenceHash) ? "" : ", frame doesn't match DrawMesh");
+
+                WriteLine(file, line);
+
+                if (threadCount == hardwareThreads)
+                    break;
+            };
+
+            // What the scenes get, the graphics' own worker pool and frame arena
+            const double defaultTime = Measure(graphics, [&]()
+            {
+                graphics.DrawMeshParallel(*mesh, transform, Colours::White, TriangleCulling::None);
+            });
+
+            std::snprintf(line, sizeof(line), "  default worker pool: %.3f ms, %.2fx%s\n",
+                          defaultTime, singleThreadTime / defaultTime,
+                          (graphics.GetFrameHash() == referenceHash) ? "" : ", frame doesn't match DrawMesh");
+
+            WriteLine(file, line);
+        };
+
+
+        graphics.EnableDepthBuffer();
+
+        std::uint64_t frontLayerHash = 0;
+
+        for (const bool frontToBack : { true, false })
+        {
+            const Mesh layers = BuildLayers(DEPTH_LAYERS, frontToBack);
+
+            const double time = Measure(graphics, [&]()
+            {
+                graphics.DrawShadedMesh(layers, Matrix3x2::Identity(), nullptr, TextureFilter::Nearest, TriangleCulling::None);
+            });
+
+            // Both orders must leave the nearest layer on top
+            if (frontToBack == true)
+                frontLayerHash = graphics.GetFrameHash();
+
+            std::snprintf(line, sizeof(line), "%d depth tested layers, %s: %.3f ms%s\n",
+                          DEPTH_LAYERS, (frontToBack == true) ? "front to back" : "back to front", time,
+                          (graphics.GetFrameHash() == frontLayerHash) ? "" : ", frame doesn't match front to back");
+
+            WriteLine(file, line);
+        };
+
+        graphics.DisableDepthBuffer();
+    };
+
+
+private:
+
+    /// <summary>
+    /// Get the average time a draw takes in milliseconds, the frame is cleared before every draw but that isn't timed
+    /// </summary>
+    /// <typeparam name="TDraw"></typeparam>
+    /// <param name="graphics"></param>
+    /// <param name="draw"></param>
+    /// <returns></returns>
+    template<class TDraw>
+    static double Measure(Graphics& graphics, TDraw&& draw)
+    {
+        // Warm up
+        graphics.ClearFrame();
+        draw();
+
+        double total = 0.0;
+
+        for (int a = 0; a < ITERATIONS; a++)
+        {
+            graphics.ClearFrame();
+
+            const auto begin = std::chrono::steady_clock::now();
+
+            draw();
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+            total += elapsed.count();
+        };
+
+        return total / ITERATIONS;
+    };
+
+
+    /// <summary>
+    /// Build a grid of cells that covers the frame, 2 triangles per cell.
+    /// Every layer is a copy of the grid, moved a little further down and right, so the layers overlap
+    /// </summary>
+    /// <param name="columns"></param>
+    /// <param name="rows"></param>
+    /// <param name="cellSize"></param>
+    /// <param name="layers"></param>
+    /// <returns></returns>
+    static Mesh BuildGrid(int columns, int rows, float cellSize, int layers)
+    {
+        const int columnVertices = columns + 1;
+        const int rowVertices = rows + 1;
+
+        Mesh mesh;
+        mesh.Reserve(static_cast<std::size_t>(columnVertices) * rowVertices * layers, static_cast<std::size_t>(columns) * rows * 2 * layers);
+
+        for (int layer = 0; layer < layers; layer++)
+        {
+            const std::uint32_t firstVertex = static_cast<std::uint32_t>(mesh.GetVertexCount());
+            const float offset = layer * cellSize / 2.0f / layers;
+
+            for (int row = 0; row < rowVertices; row++)
+                for (int column = 0; column < columnVertices; column++)
+                    mesh.AddVertex({ column * cellSize + offset, row * cellSize + offset });
+
+            for (int row = 0; row < rows; row++)
+            {
+                for (int column = 0; column < columns; column++)
+                {
+                    const std::uint32_t topLeft = firstVertex + static_cast<std::uint32_t>(row * columnVertices + column);
+                    const std::uint32_t topRight = topLeft + 1;
+                    const std::uint32_t bottomLeft = topLeft + columnVertices;
+                    const std::uint32_t bottomRight = bottomLeft + 1;
+
+                    mesh.AddTriangle(topLeft, bottomLeft, bottomRight);
+                    mesh.AddTriangle(topLeft, bottomRight, topRight);
+                };
+            };
+        };
+
+        return mesh;
+    };
+
+
+    /// <summary>
+    /// Build layers that each cover the whole frame, at W 1 for the nearest up to W layers for the farthest.
+    /// Every layer has it's own colour
+    /// </summary>
+    /// <param name="layers"></param>
+    /// <param name="frontToBack"> The order the layers are drawn in </param>
+    /// <returns></returns>
+    static Mesh BuildLayers(int layers, bool frontToBack)
+    {
+        Mesh mesh;
+        mesh.Reserve(static_cast<std::size_t>(layers) * 4, static_cast<std::size_t>(layers) * 2);
+
+        for (int layer = 0; layer < layers; layer++)
+        {
+            const float w = static_cast<float>((frontToBack == true) ? (layer + 1) : (layers - layer));
+            const std::uint8_t shade = static_cast<std::uint8_t>(255 - 255 * (w - 1) / layers);
+
+            const Colour colour = { shade, shade, shade, 255 };
+
+            // Positions are before the divide by W
+            const auto addCorner = [&](float x, float y)
+            {
+                return mesh.AddVertex({ x * w, y * w }, colour, { 0.0f, 0.0f }, w);
+            };
+
+            const std::uint32_t topLeft = addCorner(0.0f, 0.0f);
+            const std::uint32_t topRight = addCorner(FRAME_WIDTH, 0.0f);
+            const std::uint32_t bottomRight = addCorner(FRAME_WIDTH, FRAME_HEIGHT);
+            const std::uint32_t bottomLeft = addCorner(0.0f, FRAME_HEIGHT);
+
+            mesh.AddTriangle(topLeft, topRight, bottomRight);
+            mesh.AddTriangle(topLeft, bottomRight, bottomLeft);
+        };
+
+        return mesh;
+    };
+
+
+    static void WriteLine(std::ofstream& file, const char* line)
+    {
+        file << line;
+
+        OutputDebugStringA(line);
+    };
+
+};
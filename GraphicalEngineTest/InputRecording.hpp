@@ -0,0 +1,406 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+
+#include "Keyboard.hpp"
+#include "Mouse.hpp"
+
+
+/// <summary>
+/// The type of a single entry in an input log
+/// </summary>
+enum class InputEventType : std::uint8_t
+{
+    /// <summary>
+    /// Marks the beggining of a frame, followed by the time (in seconds) since the recording started
+    /// </summary>
+    FrameBegin = 0,
+
+    /// <summary>
+    /// A key went down, followed by the keycode
+    /// </summary>
+    KeyDown = 1,
+
+    /// <summary>
+    /// A key went up, followed by the keycode
+    /// </summary>
+    KeyUp = 2,
+
+    /// <summary>
+    /// The mouse position, buttons or inside-window flag changed
+    /// </summary>
+    MouseState = 3,
+
+    /// <summary>
+    /// A raw mouse delta
+    /// </summary>
+    RawMouseMoved = 4,
+
+    /// <summary>
+    /// A mouse wheel spin
+    /// </summary>
+    MouseWheel = 5,
+
+    /// <summary>
+    /// The window lost focus and every held key was released
+    /// </summary>
+    ReleaseAllKeys = 6,
+};
+
+
+/// <summary>
+/// Header of an input log file
+/// </summary>
+struct InputLogHeader
+{
+    char Magic[4] = { 'I', 'N', 'P', '1' };
+
+    /// <summary>
+    /// Index of the scene that was active when the recording started
+    /// </summary>
+    std::uint32_t StartingScene = 0;
+
+    /// <summary>
+    /// The delta time every frame was updated with
+    /// </summary>
+    float FixedDeltaTime = 0.0f;
+
+    std::uint32_t FrameCount = 0;
+};
+
+
+/// <summary>
+/// Records keyboard and mouse input to a compact binary log.
+/// The window reports input as it arrives, the log is kept in memory and written out by SaveToFile
+/// </summary>
+class InputRecorder
+{
+
+private:
+
+    InputLogHeader _header;
+
+    /// <summary>
+    /// When the recording started, frame timestamps are relative to it
+    /// </summary>
+    std::chrono::steady_clock::time_point _recordingStart;
+
+    /// <summary>
+    /// The recorded events, every frame starts with a FrameBegin entry
+    /// </summary>
+    std::vector<std::uint8_t> _events;
+
+    /// <summary>
+    /// The last mouse state that was written, so only changes are recorded
+    /// </summary>
+    int _lastMouseX = 0;
+    int _lastMouseY = 0;
+    KeyState _lastLeftMouseButton = KeyState::None;
+    KeyState _lastRightMouseButton = KeyState::None;
+    bool _lastInsideWindow = false;
+
+
+public:
+
+    InputRecorder(std::uint32_t startingScene, float fixedDeltaTime) :
+        _recordingStart(std::chrono::steady_clock::now())
+    {
+        _header.StartingScene = startingScene;
+        _header.FixedDeltaTime = fixedDeltaTime;
+
+        _events.reserve(1024 * 1024);
+    };
+
+
+public:
+
+    void BeginFrame()
+    {
+        const std::chrono::duration<float> timestamp = std::chrono::steady_clock::now() - _recordingStart;
+
+        Write(InputEventType::FrameBegin);
+        Write(timestamp.count());
+
+        _header.FrameCount++;
+    };
+
+    void RecordKeyDown(int keycode)
+    {
+        Write(InputEventType::KeyDown);
+        Write(static_cast<std::uint8_t>(keycode));
+    };
+
+    void RecordKeyUp(int keycode)
+    {
+        Write(InputEventType::KeyUp);
+        Write(static_cast<std::uint8_t>(keycode));
+    };
+
+    void RecordReleaseAllKeys()
+    {
+        Write(InputEventType::ReleaseAllKeys);
+    };
+
+    void RecordRawMouseMoved(int deltaX, int deltaY)
+    {
+        Write(InputEventType::RawMouseMoved);
+        Write(static_cast<std::int32_t>(deltaX));
+        Write(static_cast<std::int32_t>(deltaY));
+    };
+
+    void RecordMouseWheel(int delta)
+    {
+        Write(InputEventType::MouseWheel);
+        Write(static_cast<std::int32_t>(delta));
+    };
+
+    float GetFixedDeltaTime() const
+    {
+        return _header.FixedDeltaTime;
+    };
+
+    /// <summary>
+    /// Record the mouse's current state, nothing is written if it hasn't changed since the last call
+    /// </summary>
+    /// <param name="mouse"></param>
+    void RecordMouseState(const Mouse& mouse)
+    {
+        if (mouse.X == _lastMouseX &&
+            mouse.Y == _lastMouseY &&
+            mouse.LeftMouseButton == _lastLeftMouseButton &&
+            mouse.RightMouseButton == _lastRightMouseButton &&
+            mouse.InsideWindow() == _lastInsideWindow)
+            return;
+
+        _lastMouseX = mouse.X;
+        _lastMouseY = mouse.Y;
+        _lastLeftMouseButton = mouse.LeftMouseButton;
+        _lastRightMouseButton = mouse.RightMouseButton;
+        _lastInsideWindow = mouse.InsideWindow();
+
+        Write(InputEventType::MouseState);
+        Write(static_cast<std::int16_t>(mouse.X));
+        Write(static_cast<std::int16_t>(mouse.Y));
+        Write(static_cast<std::uint8_t>(mouse.LeftMouseButton));
+        Write(static_cast<std::uint8_t>(mouse.RightMouseButton));
+        Write(static_cast<std::uint8_t>(mouse.InsideWindow()));
+    };
+
+
+    /// <summary>
+    /// Write the recording to a file
+    /// </summary>
+    /// <param name="logFile"></param>
+    void SaveToFile(const std::wstring& logFile) const
+    {
+        std::ofstream file(logFile, std::ios::binary);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to create input log file");
+        };
+
+        file.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+        file.write(reinterpret_cast<const char*>(_events.data()), _events.size());
+    };
+
+
+private:
+
+    template<class T>
+    void Write(const T& value)
+    {
+        const std::size_t offset = _events.size();
+
+        _events.resize(offset + sizeof(T));
+        std::memcpy(_events.data() + offset, &value, sizeof(T));
+    };
+
+};
+
+
+
+/// <summary>
+/// Plays an input log back into the keyboard and mouse, one recorded frame per call to PlayFrame
+/// </summary>
+class InputPlayer
+{
+
+private:
+
+    InputLogHeader _header;
+
+    std::vector<std::uint8_t> _events;
+
+    /// <summary>
+    /// Read position in the event buffer
+    /// </summary>
+    std::size_t _position = 0;
+
+    /// <summary>
+    /// Recording timestamp of the frame that was played last
+    /// </summary>
+    float _frameTimestamp = 0.0f;
+
+
+public:
+
+    /// <summary>
+    /// Load an input log
+    /// </summary>
+    /// <param name="logFile"></param>
+    InputPlayer(const std::wstring& logFile)
+    {
+        std::ifstream file(logFile, std::ios::binary | std::ios::ate);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to open input log file");
+        };
+
+        const std::streamoff fileSize = file.tellg();
+        file.seekg(0);
+
+        file.read(reinterpret_cast<char*>(&_header), sizeof(_header));
+
+        const InputLogHeader expected;
+
+        if ((file.good() == false) ||
+            (std::equal(std::begin(_header.Magic), std::end(_header.Magic), std::begin(expected.Magic)) == false))
+            throw std::exception("Invalid input log file");
+
+        _events.resize(static_cast<std::size_t>(fileSize) - sizeof(_header));
+        file.read(reinterpret_cast<char*>(_events.data()), _events.size());
+    };
+
+
+public:
+
+    /// <summary>
+    /// Feed the next recorded frame into the keyboard and mouse.
+    /// Key transitions are queued exactly as the window procedure would, so Keyboard::Update produces the same states
+    /// </summary>
+    /// <param name="keyboard"></param>
+    /// <param name="mouse"></param>
+    void PlayFrame(Keyboard& keyboard, Mouse& mouse)
+    {
+        if (IsFinished() == true)
+            return;
+
+        // Every frame starts with a FrameBegin entry
+        if (Read<InputEventType>() != InputEventType::FrameBegin)
+            throw std::exception("Corrupted input log");
+
+        _frameTimestamp = Read<float>();
+
+        while ((IsFinished() == false) &&
+               (static_cast<InputEventType>(_events[_position]) != InputEventType::FrameBegin))
+        {
+            switch (Read<InputEventType>())
+            {
+                case InputEventType::KeyDown:
+                {
+                    keyboard.OnKeyDown(Read<std::uint8_t>());
+                    break;
+                };
+
+                case InputEventType::KeyUp:
+                {
+                    keyboard.OnKeyUp(Read<std::uint8_t>());
+                    break;
+                };
+
+                case InputEventType::ReleaseAllKeys:
+                {
+                    keyboard.ReleaseAllKeys();
+                    break;
+                };
+
+                case InputEventType::MouseState:
+                {
+                    mouse.X = Read<std::int16_t>();
+                    mouse.Y = Read<std::int16_t>();
+                    mouse.LeftMouseButton = static_cast<KeyState>(Read<std::uint8_t>());
+                    mouse.RightMouseButton = static_cast<KeyState>(Read<std::uint8_t>());
+                    mouse._insideWindow = (Read<std::uint8_t>() != 0);
+                    break;
+                };
+
+                case InputEventType::RawMouseMoved:
+                {
+                    const std::int32_t deltaX = Read<std::int32_t>();
+                    const std::int32_t deltaY = Read<std::int32_t>();
+
+                    mouse.OnMouseRawMoved(deltaX, deltaY);
+                    break;
+                };
+
+                case InputEventType::MouseWheel:
+                {
+                    mouse._mouseWheenEvent(Read<std::int32_t>());
+                    break;
+                };
+
+                default:
+                    throw std::exception("Corrupted input log");
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Returns true after every recorded frame was played
+    /// </summary>
+    /// <returns></returns>
+    bool IsFinished() const
+    {
+        return _position >= _events.size();
+    };
+
+    std::uint32_t GetStartingScene() const
+    {
+        return _header.StartingScene;
+    };
+
+    float GetFixedDeltaTime() const
+    {
+        return _header.FixedDeltaTime;
+    };
+
+    std::uint32_t GetFrameCount() const
+    {
+        return _header.FrameCount;
+    };
+
+    /// <summary>
+    /// Get the time (in seconds since the recording started) at which the last played frame was recorded
+    /// </summary>
+    /// <returns></returns>
+    float GetFrameTimestamp() const
+    {
+        return _frameTimestamp;
+    };
+
+
+private:
+
+    template<class T>
+    T Read()
+    {
+        if (_position + sizeof(T) > _events.size())
+            throw std::exception("Input log is truncated");
+
+        T value;
+        std::memcpy(&value, _events.data() + _position, sizeof(T));
+
+        _position += sizeof(T);
+
+        return value;
+    };
+
+};
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>
+#include <vector>
+#include <algorithm>
 
 #include "KeyState.hpp"
 
@@ -11,7 +14,10 @@ struct Key
 
 
 /// <summary>
-/// A class responsible for Keyboard interaction
+/// A class responsible for Keyboard interaction.
+/// Key states are event driven, the window feeds key transitions in as they arrive and Update() applies them once per frame,
+/// so the per-frame cost depends on how many keys changed and not on the number of keys.
+/// Nothing here depends on Win32, the transitions can be fed by hand
 /// </summary>
 class Keyboard
 {
@@ -24,13 +30,42 @@ private:
     /// </summary>
     static constexpr std::size_t NUMBER_OF_KEYS = 255;
 
+    /// <summary>
+    /// A single key transition waiting to be applied
+    /// </summary>
+    struct KeyTransition
+    {
+        unsigned char Keycode;
+        bool Down;
+    };
+
 private:
 
     /// <summary>
-    /// An array that stores the keys 
+    /// An array that stores the keys
     /// </summary>
     Key _keys[NUMBER_OF_KEYS] = { 0 };
 
+    /// <summary>
+    /// Transitions received since the last Update, in the order they arrived
+    /// </summary>
+    std::vector<KeyTransition> _pendingTransitions;
+
+    /// <summary>
+    /// Keys that are currently Pressed or Released, these are promoted to Held/None on the next Update
+    /// </summary>
+    std::vector<unsigned char> _transientKeys;
+
+    /// <summary>
+    /// Keys whose state changed in the last Update
+    /// </summary>
+    std::vector<unsigned char> _changedKeys;
+
+    /// <summary>
+    /// Marks keys that were already given a transition in the current Update
+    /// </summary>
+    bool _transitionedThisUpdate[NUMBER_OF_KEYS] = { 0 };
+
 public:
 
     Keyboard()
@@ -40,6 +75,11 @@ public:
         {
             _keys[a] = { static_cast<unsigned char>(a), KeyState::None, false };
         };
+
+        // Reserve up front so handling input never allocates during a frame
+        _pendingTransitions.reserve(64);
+        _transientKeys.reserve(NUMBER_OF_KEYS);
+        _changedKeys.reserve(NUMBER_OF_KEYS);
     };
 
 public:
@@ -64,4 +104,138 @@ public:
         return _keys[keycode].KeyState;
     };
 
+    /// <summary>
+    /// Get the keycodes of every key whose state changed in the last Update
+    /// </summary>
+    /// <returns></returns>
+    const std::vector<unsigned char>& GetChangedKeys() const
+    {
+        return _changedKeys;
+    };
+
+
+    /// <summary>
+    /// Record that a key went down
+    /// </summary>
+    /// <param name="keycode"></param>
+    void OnKeyDown(int keycode)
+    {
+        QueueTransition(keycode, true);
+    };
+
+    /// <summary>
+    /// Record that a key went up
+    /// </summary>
+    /// <param name="keycode"></param>
+    void OnKeyUp(int keycode)
+    {
+        QueueTransition(keycode, false);
+    };
+
+    /// <summary>
+    /// Release every key that is currently down, used when the window loses focus and the key up messages will never arrive
+    /// </summary>
+    void ReleaseAllKeys()
+    {
+        // Downs that weren't applied yet are superseded
+        _pendingTransitions.erase(std::remove_if(_pendingTransitions.begin(), _pendingTransitions.end(),
+                                                 [](const KeyTransition& transition)
+        {
+            return transition.Down;
+        }), _pendingTransitions.end());
+
+        for (int a = 0; a < NUMBER_OF_KEYS; a++)
+        {
+            _keys[a].TextAutoRepeat = false;
+
+            if (IsDown(_keys[a].KeyState) == true)
+                QueueTransition(a, false);
+        };
+    };
+
+
+    /// <summary>
+    /// Apply the queued transitions, should be called once per frame.
+    /// Keys that were Pressed become Held and keys that were Released become None,
+    /// then every queued transition is applied
+    /// </summary>
+    void Update()
+    {
+        _changedKeys.clear();
+
+        // Promote last frame's transient states
+        for (unsigned char keycode : _transientKeys)
+        {
+            Key& key = _keys[keycode];
+
+            if (key.KeyState == KeyState::Pressed)
+                key.KeyState = KeyState::Held;
+            else if (key.KeyState == KeyState::Released)
+                key.KeyState = KeyState::None;
+
+            _changedKeys.push_back(keycode);
+        };
+
+        _transientKeys.clear();
+
+
+        std::size_t transitionIndex = 0;
+
+        for (; transitionIndex < _pendingTransitions.size(); transitionIndex++)
+        {
+            const KeyTransition& transition = _pendingTransitions[transitionIndex];
+
+            // A key that was pressed and released in the same frame would never be seen as pressed,
+            // so the rest of the transitions are left for the next frame
+            if (_transitionedThisUpdate[transition.Keycode] == true)
+                break;
+
+            Key& key = _keys[transition.Keycode];
+
+            // Repeated downs or ups don't change anything
+            if (IsDown(key.KeyState) == transition.Down)
+                continue;
+
+            key.KeyState = transition.Down ? KeyState::Pressed : KeyState::Released;
+
+            if (transition.Down == false)
+                key.TextAutoRepeat = false;
+
+            _transitionedThisUpdate[transition.Keycode] = true;
+
+            _transientKeys.push_back(transition.Keycode);
+
+            // The key may already be in the list if it was promoted above
+            if (std::find(_changedKeys.begin(), _changedKeys.end(), transition.Keycode) == _changedKeys.end())
+                _changedKeys.push_back(transition.Keycode);
+        };
+
+        _pendingTransitions.erase(_pendingTransitions.begin(), _pendingTransitions.begin() + transitionIndex);
+
+        for (unsigned char keycode : _transientKeys)
+            _transitionedThisUpdate[keycode] = false;
+    };
+
+
+private:
+
+    void QueueTransition(int keycode, bool down)
+    {
+        if (keycode < 0 || keycode >= NUMBER_OF_KEYS)
+            return;
+
+        _pendingTransitions.push_back({ static_cast<unsigned char>(keycode), down });
+    };
+
+    /// <summary>
+    /// Returns true if a key state means that the key is physically down
+    /// </summary>
+    /// <param name="keyState"></param>
+    /// <returns></returns>
+    static bool IsDown(KeyState keyState)
+    {
+        return (keyState == KeyState::Pressed) ||
+               (keyState == KeyState::Held);
+    };
+
 };
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "Window.hpp"
 #include "Graphics.hpp"
 #include "IScene.hpp"
+#include "TileMap.hpp"
+#include "CachedLayer.hpp"
 
 
 class LightTestScene : public IScene
@@ -25,10 +27,20 @@ private:
 
     int _cellSize = 20;
 
-    bool* _map;
+    TileMap _map;
 
     float* _mapF;
 
+    /// <summary>
+    /// The drawn light map, only redrawn when the map changes
+    /// </summary>
+    CachedLayer _lightMapLayer;
+
+    /// <summary>
+    /// The map version the light map layer was drawn for
+    /// </summary>
+    std::uint64_t _lightMapVersion = 0;
+
 
 
 public:
@@ -38,22 +50,12 @@ public:
         _window(window),
 
         mt(rd()),
-        dist(0, _mapWidth * _mapHeight)
+        dist(0, _mapWidth * _mapHeight - 1),
+
+        _map(static_cast<int>(_mapWidth), static_cast<int>(_mapHeight))
     {
 
-        _map = new bool[_mapWidth * _mapHeight] // { 0 };
-        {
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,1,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,
-        };
+        _map.SetSolid(4, 4, true);
         /*
         {
             1,0,1,0,1,1,0,0,0,0,
@@ -80,9 +82,6 @@ public:
     {
         delete[] _mapF;
         _mapF = nullptr;
-
-        delete[] _map;
-        _map = nullptr;
     };
 
 
@@ -104,6 +103,29 @@ public:
 
 
     virtual void DrawScene() override
+    {
+        _lightMapLayer.Resize(static_cast<int>(_mapWidth) * _cellSize, static_cast<int>(_mapHeight) * _cellSize);
+
+        if (_map.GetVersion() != _lightMapVersion)
+        {
+            _lightMapVersion = _map.GetVersion();
+            _lightMapLayer.Invalidate();
+        };
+
+        _lightMapLayer.Update([this](ImageBuffer& layer)
+        {
+            RenderLightMap(layer);
+        });
+
+        _lightMapLayer.Draw(_graphics, 0, 0);
+    };
+
+
+    /// <summary>
+    /// Spread the light of every lit cell and draw the resulting cells into an image
+    /// </summary>
+    /// <param name="layer"></param>
+    void RenderLightMap(ImageBuffer& layer)
     {
         std::uint64_t previousIndex = 0;
 
@@ -114,7 +136,7 @@ public:
 
         for (std::uint64_t mapIndex = 0; mapIndex < _mapWidth * _mapHeight; mapIndex++)
         {
-            if (_map[mapIndex] == true)
+            if (_map.IsSolid(static_cast<int>(mapIndex % _mapWidth), static_cast<int>(mapIndex / _mapWidth)) == true)
             {
                 _mapF[mapIndex] = 1.0f;
 
@@ -193,19 +215,17 @@ public:
                     const std::uint64_t xPos = column + (mapX * _cellSize);
                     const std::uint64_t yPos = row + (mapY * _cellSize);
 
-                    _graphics.DrawPixel(xPos,
-                                        yPos,
-                                        colour);
+                    layer.GetPixel(static_cast<int>(xPos), static_cast<int>(yPos)) = colour;
 
 
                     if ((column % _cellSize) == 0)
                     {
-                        _graphics.DrawPixel(xPos, yPos, Colours::Black);
+                        layer.GetPixel(static_cast<int>(xPos), static_cast<int>(yPos)) = Colours::Black;
                     };
 
                     if ((row % _cellSize) == 0)
                     {
-                        _graphics.DrawPixel(xPos, yPos, Colours::Black);
+                        layer.GetPixel(static_cast<int>(xPos), static_cast<int>(yPos)) = Colours::Black;
                     };
 
                 };
@@ -247,9 +267,10 @@ private:
 
     void ClearMaps()
     {
+        _map.Clear();
+
         for (std::uint64_t a = 0; a < _mapWidth * _mapHeight; a++)
         {
-            _map[a] = 0;
             _mapF[a] = 0.0f;
         };
 
@@ -264,7 +285,7 @@ private:
         {
             int position = dist(mt);
 
-            _map[position] = 1;
+            _map.SetSolid(position % _mapWidth, position / _mapWidth, true);
         };
     };
 
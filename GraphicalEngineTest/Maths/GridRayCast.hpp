@@ -0,0 +1,175 @@
+#pragma once
+#include <cmath>
+#include <limits>
+
+
+/// <summary>
+/// Which kind of grid line a ray crossed when it hit a cell
+/// </summary>
+enum class GridRayHitSide
+{
+    /// <summary>
+    /// The ray started inside a solid cell
+    /// </summary>
+    None = 0,
+
+    /// <summary>
+    /// The ray crossed a vertical grid line (a wall facing east or west)
+    /// </summary>
+    X = 1,
+
+    /// <summary>
+    /// The ray crossed a horizontal grid line (a wall facing north or south)
+    /// </summary>
+    Y = 2,
+};
+
+
+/// <summary>
+/// The result of a grid ray cast
+/// </summary>
+struct GridRayHit
+{
+    /// <summary>
+    /// True if the ray hit a solid cell before reaching the maximum distance or leaving the grid
+    /// </summary>
+    bool Hit = false;
+
+    /// <summary>
+    /// The cell that was hit
+    /// </summary>
+    int CellX = 0;
+    int CellY = 0;
+
+    GridRayHitSide Side = GridRayHitSide::None;
+
+    /// <summary>
+    /// Distance to the hit, in units of the ray direction's length.
+    /// With a normalized direction this is the euclidean distance
+    /// </summary>
+    float Distance = 0.0f;
+
+    /// <summary>
+    /// The exact position where the ray entered the cell
+    /// </summary>
+    float HitX = 0.0f;
+    float HitY = 0.0f;
+
+    /// <summary>
+    /// Where along the wall face the ray hit, in the range [0, 1)
+    /// </summary>
+    float WallOffset = 0.0f;
+};
+
+
+namespace Maths
+{
+
+    /// <summary>
+    /// Cast a ray through a uniform grid of unit sized cells (Amanatides & Woo grid traversal).
+    /// Every cell the ray crosses is visited exactly once, so the cost depends on the number of cells crossed and not on the distance
+    /// </summary>
+    /// <typeparam name="TIsSolid"> Callable with the signature bool(int cellX, int cellY) </typeparam>
+    /// <param name="originX"></param>
+    /// <param name="originY"></param>
+    /// <param name="directionX"></param>
+    /// <param name="directionY"></param>
+    /// <param name="maxDistance"> Stop looking after this distance, in units of the direction's length </param>
+    /// <param name="gridWidth"></param>
+    /// <param name="gridHeight"></param>
+    /// <param name="isSolid"> Returns true if a cell blocks the ray, only called for cells inside the grid </param>
+    /// <returns></returns>
+    template<class TIsSolid>
+    inline GridRayHit CastGridRay(float originX, float originY,
+                                  float directionX, float directionY,
+                                  float maxDistance,
+                                  int gridWidth, int gridHeight,
+                                  TIsSolid&& isSolid)
+    {
+        GridRayHit result;
+        result.Distance = maxDistance;
+
+        int cellX = static_cast<int>(std::floor(originX));
+        int cellY = static_cast<int>(std::floor(originY));
+
+        const auto insideGrid = [gridWidth, gridHeight](int x, int y)
+        {
+            return (x >= 0) && (x < gridWidth) &&
+                   (y >= 0) && (y < gridHeight);
+        };
+
+        // Started inside a wall
+        if ((insideGrid(cellX, cellY) == true) &&
+            (isSolid(cellX, cellY) == true))
+        {
+            result.Hit = true;
+            result.CellX = cellX;
+            result.CellY = cellY;
+            result.Distance = 0.0f;
+            result.HitX = originX;
+            result.HitY = originY;
+
+            return result;
+        };
+
+        constexpr float infinity = std::numeric_limits<float>::infinity();
+
+        // How far along the ray we have to move to cross a whole cell on each axis
+        const float deltaDistanceX = (directionX == 0.0f) ? infinity : std::fabs(1.0f / directionX);
+        const float deltaDistanceY = (directionY == 0.0f) ? infinity : std::fabs(1.0f / directionY);
+
+        const int stepX = (directionX < 0.0f) ? -1 : 1;
+        const int stepY = (directionY < 0.0f) ? -1 : 1;
+
+        // Distance along the ray to the first vertical and horizontal grid lines
+        float sideDistanceX = (directionX < 0.0f) ? (originX - cellX) * deltaDistanceX : (cellX + 1.0f - originX) * deltaDistanceX;
+        float sideDistanceY = (directionY < 0.0f) ? (originY - cellY) * deltaDistanceY : (cellY + 1.0f - originY) * deltaDistanceY;
+
+        while (true)
+        {
+            float distance;
+            GridRayHitSide side;
+
+            // Step into whichever neighbouring cell the ray reaches first
+            if (sideDistanceX < sideDistanceY)
+            {
+                distance = sideDistanceX;
+                sideDistanceX += deltaDistanceX;
+                cellX += stepX;
+                side = GridRayHitSide::X;
+            }
+            else
+            {
+                distance = sideDistanceY;
+                sideDistanceY += deltaDistanceY;
+                cellY += stepY;
+                side = GridRayHitSide::Y;
+            };
+
+            if (distance > maxDistance)
+                return result;
+
+            // Left the grid without hitting anything
+            if (insideGrid(cellX, cellY) == false)
+                return result;
+
+            if (isSolid(cellX, cellY) == true)
+            {
+                result.Hit = true;
+                result.CellX = cellX;
+                result.CellY = cellY;
+                result.Side = side;
+                result.Distance = distance;
+                result.HitX = originX + directionX * distance;
+                result.HitY = originY + directionY * distance;
+
+                // The wall face runs along Y for X side hits, and along X for Y side hits
+                const float alongWall = (side == GridRayHitSide::X) ? result.HitY : result.HitX;
+                result.WallOffset = alongWall - std::floor(alongWall);
+
+                return result;
+            };
+        };
+    };
+
+};
\ No newline at end of file
@@ -0,0 +1,180 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <emmintrin.h>
+
+#include "Vector2D.hpp"
+
+
+/// <summary>
+/// A 2D affine transform, points are row vectors multiplied from the left:
+/// x' = x * M11 + y * M21 + M31,
+/// y' = x * M12 + y * M22 + M32
+/// </summary>
+class Matrix3x2
+{
+public:
+
+    float M11 = 1.0f;
+    float M12 = 0.0f;
+
+    float M21 = 0.0f;
+    float M22 = 1.0f;
+
+    /// <summary>
+    /// The translation
+    /// </summary>
+    float M31 = 0.0f;
+    float M32 = 0.0f;
+
+
+public:
+
+    static Matrix3x2 Identity()
+    {
+        return Matrix3x2();
+    };
+
+    static Matrix3x2 Translation(float x, float y)
+    {
+        Matrix3x2 matrix;
+        matrix.M31 = x;
+        matrix.M32 = y;
+
+        return matrix;
+    };
+
+    static Matrix3x2 Scale(float x, float y)
+    {
+        Matrix3x2 matrix;
+        matrix.M11 = x;
+        matrix.M22 = y;
+
+        return matrix;
+    };
+
+    /// <summary>
+    /// A counter-clockwise rotation around the origin, when y points up
+    /// </summary>
+    /// <param name="radians"></param>
+    /// <returns></returns>
+    static Matrix3x2 Rotation(float radians)
+    {
+        const float sine = std::sinf(radians);
+        const float cosine = std::cosf(radians);
+
+        Matrix3x2 matrix;
+        matrix.M11 = cosine;
+        matrix.M12 = sine;
+        matrix.M21 = -sine;
+        matrix.M22 = cosine;
+
+        return matrix;
+    };
+
+
+public:
+
+    Vector2D Transform(const Vector2D& point) const
+    {
+        return
+        {
+            point.X * M11 + point.Y * M21 + M31,
+            point.X * M12 + point.Y * M22 + M32,
+        };
+    };
+
+    /// <summary>
+    /// Transform an array of points stored as separate X and Y arrays, 4 points at a time.
+    /// The output can be the input
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <param name="outputX"></param>
+    /// <param name="outputY"></param>
+    /// <param name="count"></param>
+    void TransformPoints(const float* x, const float* y, float* outputX, float* outputY, std::size_t count) const
+    {
+        const __m128 m11 = _mm_set1_ps(M11);
+        const __m128 m12 = _mm_set1_ps(M12);
+        const __m128 m21 = _mm_set1_ps(M21);
+        const __m128 m22 = _mm_set1_ps(M22);
+        const __m128 m31 = _mm_set1_ps(M31);
+        const __m128 m32 = _mm_set1_ps(M32);
+
+        std::size_t index = 0;
+
+        for (; index + 4 <= count; index += 4)
+        {
+            const __m128 pointX = _mm_loadu_ps(x + index);
+            const __m128 pointY = _mm_loadu_ps(y + index);
+
+            _mm_storeu_ps(outputX + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(pointX, m11), _mm_mul_ps(pointY, m21)), m31));
+            _mm_storeu_ps(outputY + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(pointX, m12), _mm_mul_ps(pointY, m22)), m32));
+        };
+
+        for (; index < count; index++)
+        {
+            const Vector2D result = Transform({ x[index], y[index] });
+
+            outputX[index] = result.X;
+            outputY[index] = result.Y;
+        };
+    };
+
+
+    /// <summary>
+    /// Get the transform that undoes this one, turns screen positions like the mouse's back into the space that was transformed
+    /// </summary>
+    /// <returns></returns>
+    Matrix3x2 Inverse() const
+    {
+        const float determinant = M11 * M22 - M12 * M21;
+
+        if (determinant == 0.0f)
+        {
+            throw std::exception("Matrix3x2 can't be inverted, it's determinant is 0");
+        };
+
+        const float inverseDeterminant = 1.0f / determinant;
+
+        Matrix3x2 result;
+
+        result.M11 = M22 * inverseDeterminant;
+        result.M12 = -M12 * inverseDeterminant;
+        result.M21 = -M21 * inverseDeterminant;
+        result.M22 = M11 * inverseDeterminant;
+
+        // Undo the translation, then the linear part
+        result.M31 = -(M31 * result.M11 + M32 * result.M21);
+        result.M32 = -(M31 * result.M12 + M32 * result.M22);
+
+        return result;
+    };
+
+
+public:
+
+    /// <summary>
+    /// Combine 2 transforms, the result applies this transform first and then the other
+    /// </summary>
+    /// <param name="other"></param>
+    /// <returns></returns>
+    Matrix3x2 operator * (const Matrix3x2& other) const
+    {
+        Matrix3x2 result;
+
+        result.M11 = M11 * other.M11 + M12 * other.M21;
+        result.M12 = M11 * other.M12 + M12 * other.M22;
+
+        result.M21 = M21 * other.M11 + M22 * other.M21;
+        result.M22 = M21 * other.M12 + M22 * other.M22;
+
+        result.M31 = M31 * other.M11 + M32 * other.M21 + other.M31;
+        result.M32 = M31 * other.M12 + M32 * other.M22 + other.M32;
+
+        return result;
+    };
+
+};
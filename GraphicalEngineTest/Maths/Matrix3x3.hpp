@@ -0,0 +1,217 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <emmintrin.h>
+
+#include "Vector3.hpp"
+
+
+/// <summary>
+/// A 3D linear transform without translation, used for directions and normals.
+/// Vectors are row vectors multiplied from the left, like Matrix3x2:
+/// x' = x * M11 + y * M21 + z * M31,
+/// y' = x * M12 + y * M22 + z * M32,
+/// z' = x * M13 + y * M23 + z * M33
+/// </summary>
+class Matrix3x3
+{
+public:
+
+    float M11 = 1.0f;
+    float M12 = 0.0f;
+    float M13 = 0.0f;
+
+    float M21 = 0.0f;
+    float M22 = 1.0f;
+    float M23 = 0.0f;
+
+    float M31 = 0.0f;
+    float M32 = 0.0f;
+    float M33 = 1.0f;
+
+
+public:
+
+    static constexpr Matrix3x3 Identity()
+    {
+        return Matrix3x3();
+    };
+
+    static constexpr Matrix3x3 Scale(float x, float y, float z)
+    {
+        Matrix3x3 matrix;
+        matrix.M11 = x;
+        matrix.M22 = y;
+        matrix.M33 = z;
+
+        return matrix;
+    };
+
+    /// <summary>
+    /// A rotation around an axis, clockwise when looking along the axis towards the origin, in a left-handed coordinate system
+    /// </summary>
+    /// <param name="axis"> Doesn't have to be normalized, but can't be zero </param>
+    /// <param name="radians"></param>
+    /// <returns></returns>
+    static Matrix3x3 Rotation(const Vector3& axis, float radians)
+    {
+        const Vector3 unit = axis.Normalized();
+
+        const float sine = std::sin(radians);
+        const float cosine = std::cos(radians);
+        const float oneMinusCosine = 1.0f - cosine;
+
+        Matrix3x3 matrix;
+
+        matrix.M11 = cosine + unit.X * unit.X * oneMinusCosine;
+        matrix.M12 = unit.X * unit.Y * oneMinusCosine + unit.Z * sine;
+        matrix.M13 = unit.X * unit.Z * oneMinusCosine - unit.Y * sine;
+
+        matrix.M21 = unit.Y * unit.X * oneMinusCosine - unit.Z * sine;
+        matrix.M22 = cosine + unit.Y * unit.Y * oneMinusCosine;
+        matrix.M23 = unit.Y * unit.Z * oneMinusCosine + unit.X * sine;
+
+        matrix.M31 = unit.Z * unit.X * oneMinusCosine + unit.Y * sine;
+        matrix.M32 = unit.Z * unit.Y * oneMinusCosine - unit.X * sine;
+        matrix.M33 = cosine + unit.Z * unit.Z * oneMinusCosine;
+
+        return matrix;
+    };
+
+
+public:
+
+    constexpr Vector3 Transform(const Vector3& vector) const
+    {
+        return
+        {
+            vector.X * M11 + vector.Y * M21 + vector.Z * M31,
+            vector.X * M12 + vector.Y * M22 + vector.Z * M32,
+            vector.X * M13 + vector.Y * M23 + vector.Z * M33,
+        };
+    };
+
+
+    /// <summary>
+    /// Transform a stream of vectors stored as separate X, Y and Z arrays, 4 vectors at a time.
+    /// The output can be the input
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <param name="z"></param>
+    /// <param name="outputX"></param>
+    /// <param name="outputY"></param>
+    /// <param name="outputZ"></param>
+    /// <param name="count"></param>
+    void TransformVectors(const float* x, const float* y, const float* z,
+                          float* outputX, float* outputY, float* outputZ,
+                          std::size_t count) const
+    {
+        const __m128 m11 = _mm_set1_ps(M11), m12 = _mm_set1_ps(M12), m13 = _mm_set1_ps(M13);
+        const __m128 m21 = _mm_set1_ps(M21), m22 = _mm_set1_ps(M22), m23 = _mm_set1_ps(M23);
+        const __m128 m31 = _mm_set1_ps(M31), m32 = _mm_set1_ps(M32), m33 = _mm_set1_ps(M33);
+
+        std::size_t index = 0;
+
+        for (; index + 4 <= count; index += 4)
+        {
+            const __m128 vectorX = _mm_loadu_ps(x + index);
+            const __m128 vectorY = _mm_loadu_ps(y + index);
+            const __m128 vectorZ = _mm_loadu_ps(z + index);
+
+            _mm_storeu_ps(outputX + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vectorX, m11), _mm_mul_ps(vectorY, m21)), _mm_mul_ps(vectorZ, m31)));
+            _mm_storeu_ps(outputY + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vectorX, m12), _mm_mul_ps(vectorY, m22)), _mm_mul_ps(vectorZ, m32)));
+            _mm_storeu_ps(outputZ + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vectorX, m13), _mm_mul_ps(vectorY, m23)), _mm_mul_ps(vectorZ, m33)));
+        };
+
+        for (; index < count; index++)
+        {
+            const Vector3 result = Transform({ x[index], y[index], z[index] });
+
+            outputX[index] = result.X;
+            outputY[index] = result.Y;
+            outputZ[index] = result.Z;
+        };
+    };
+
+
+    constexpr float Determinant() const
+    {
+        return M11 * (M22 * M33 - M23 * M32) -
+               M12 * (M21 * M33 - M23 * M31) +
+               M13 * (M21 * M32 - M22 * M31);
+    };
+
+    constexpr Matrix3x3 Transposed() const
+    {
+        Matrix3x3 result;
+
+        result.M11 = M11; result.M12 = M21; result.M13 = M31;
+        result.M21 = M12; result.M22 = M22; result.M23 = M32;
+        result.M31 = M13; result.M32 = M23; result.M33 = M33;
+
+        return result;
+    };
+
+    /// <summary>
+    /// Get the transform that undoes this one, the transpose of the inverse transforms normals
+    /// </summary>
+    /// <returns></returns>
+    Matrix3x3 Inverse() const
+    {
+        const float determinant = Determinant();
+
+        if (determinant == 0.0f)
+        {
+            throw std::exception("Matrix3x3 can't be inverted, it's determinant is 0");
+        };
+
+        const float inverseDeterminant = 1.0f / determinant;
+
+        // The adjugate, the transposed cofactors
+        Matrix3x3 result;
+
+        result.M11 = (M22 * M33 - M23 * M32) * inverseDeterminant;
+        result.M12 = (M13 * M32 - M12 * M33) * inverseDeterminant;
+        result.M13 = (M12 * M23 - M13 * M22) * inverseDeterminant;
+
+        result.M21 = (M23 * M31 - M21 * M33) * inverseDeterminant;
+        result.M22 = (M11 * M33 - M13 * M31) * inverseDeterminant;
+        result.M23 = (M13 * M21 - M11 * M23) * inverseDeterminant;
+
+        result.M31 = (M21 * M32 - M22 * M31) * inverseDeterminant;
+        result.M32 = (M12 * M31 - M11 * M32) * inverseDeterminant;
+        result.M33 = (M11 * M22 - M12 * M21) * inverseDeterminant;
+
+        return result;
+    };
+
+
+public:
+
+    /// <summary>
+    /// Combine 2 transforms, the result applies this transform first and then the other
+    /// </summary>
+    /// <param name="other"></param>
+    /// <returns></returns>
+    constexpr Matrix3x3 operator * (const Matrix3x3& other) const
+    {
+        Matrix3x3 result;
+
+        result.M11 = M11 * other.M11 + M12 * other.M21 + M13 * other.M31;
+        result.M12 = M11 * other.M12 + M12 * other.M22 + M13 * other.M32;
+        result.M13 = M11 * other.M13 + M12 * other.M23 + M13 * other.M33;
+
+        result.M21 = M21 * other.M11 + M22 * other.M21 + M23 * other.M31;
+        result.M22 = M21 * other.M12 + M22 * other.M22 + M23 * other.M32;
+        result.M23 = M21 * other.M13 + M22 * other.M23 + M23 * other.M33;
+
+        result.M31 = M31 * other.M11 + M32 * other.M21 + M33 * other.M31;
+        result.M32 = M31 * other.M12 + M32 * other.M22 + M33 * other.M32;
+        result.M33 = M31 * other.M13 + M32 * other.M23 + M33 * other.M33;
+
+        return result;
+    };
+
+};
@@ -0,0 +1,455 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <emmintrin.h>
+
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+#include "Matrix3x3.hpp"
+
+
+/// <summary>
+/// A 3D transform with translation and projection, in a left-handed coordinate system where Z points into the screen.
+/// Vectors are row vectors multiplied from the left, like Matrix3x2:
+/// x' = x * M11 + y * M21 + z * M31 + w * M41, and so on for y', z' and w'.
+/// Every row's 4 floats are laid out like an SSE register, so a transform is 4 multiplies and 3 adds of whole rows.
+/// The scalar functions are constexpr, constant transforms are folded at compile time
+/// </summary>
+class Matrix4x4
+{
+public:
+
+    float M11 = 1.0f;
+    float M12 = 0.0f;
+    float M13 = 0.0f;
+    float M14 = 0.0f;
+
+    float M21 = 0.0f;
+    float M22 = 1.0f;
+    float M23 = 0.0f;
+    float M24 = 0.0f;
+
+    float M31 = 0.0f;
+    float M32 = 0.0f;
+    float M33 = 1.0f;
+    float M34 = 0.0f;
+
+    /// <summary>
+    /// The translation
+    /// </summary>
+    float M41 = 0.0f;
+    float M42 = 0.0f;
+    float M43 = 0.0f;
+    float M44 = 1.0f;
+
+
+public:
+
+    static constexpr Matrix4x4 Identity()
+    {
+        return Matrix4x4();
+    };
+
+    static constexpr Matrix4x4 Translation(float x, float y, float z)
+    {
+        Matrix4x4 matrix;
+        matrix.M41 = x;
+        matrix.M42 = y;
+        matrix.M43 = z;
+
+        return matrix;
+    };
+
+    static constexpr Matrix4x4 Scale(float x, float y, float z)
+    {
+        Matrix4x4 matrix;
+        matrix.M11 = x;
+        matrix.M22 = y;
+        matrix.M33 = z;
+
+        return matrix;
+    };
+
+    /// <summary>
+    /// A linear transform followed by a translation
+    /// </summary>
+    /// <param name="linear"></param>
+    /// <param name="translation"></param>
+    /// <returns></returns>
+    static constexpr Matrix4x4 Affine(const Matrix3x3& linear, const Vector3& translation)
+    {
+        Matrix4x4 matrix;
+
+        matrix.M11 = linear.M11; matrix.M12 = linear.M12; matrix.M13 = linear.M13;
+        matrix.M21 = linear.M21; matrix.M22 = linear.M22; matrix.M23 = linear.M23;
+        matrix.M31 = linear.M31; matrix.M32 = linear.M32; matrix.M33 = linear.M33;
+
+        matrix.M41 = translation.X;
+        matrix.M42 = translation.Y;
+        matrix.M43 = translation.Z;
+
+        return matrix;
+    };
+
+    /// <summary>
+    /// A rotation around an axis through the origin, see Matrix3x3::Rotation
+    /// </summary>
+    /// <param name="axis"></param>
+    /// <param name="radians"></param>
+    /// <returns></returns>
+    static Matrix4x4 Rotation(const Vector3& axis, float radians)
+    {
+        return Affine(Matrix3x3::Rotation(axis, radians), {});
+    };
+
+
+    /// <summary>
+    /// A camera's view transform, moves the world so the camera is at the origin looking down the Z axis with Y up.
+    /// The up vector only has to be roughly up, but not along the view direction
+    /// </summary>
+    /// <param name="eye"> The camera's position </param>
+    /// <param name="target"> The point the camera looks at </param>
+    /// <param name="up"></param>
+    /// <returns></returns>
+    static Matrix4x4 LookAt(const Vector3& eye, const Vector3& target, const Vector3& up)
+    {
+        const Vector3 forward = (target - eye).Normalized();
+        const Vector3 right = up.Cross(forward).Normalized();
+        const Vector3 cameraUp = forward.Cross(right);
+
+        Matrix4x4 matrix;
+
+        matrix.M11 = right.X; matrix.M12 = cameraUp.X; matrix.M13 = forward.X;
+        matrix.M21 = right.Y; matrix.M22 = cameraUp.Y; matrix.M23 = forward.Y;
+        matrix.M31 = right.Z; matrix.M32 = cameraUp.Z; matrix.M33 = forward.Z;
+
+        matrix.M41 = -right.Dot(eye);
+        matrix.M42 = -cameraUp.Dot(eye);
+        matrix.M43 = -forward.Dot(eye);
+
+        return matrix;
+    };
+
+    /// <summary>
+    /// A perspective projection of view space.
+    /// W becomes the view depth, so the result can be given straight to DrawShadedMesh with the same near and far as SetClipRange.
+    /// After the divide by W, X and Y are -1 to 1 across the field of view with Y up, and Z is 0 at the near plane and 1 at the far plane
+    /// </summary>
+    /// <param name="verticalFieldOfView"> In radians </param>
+    /// <param name="aspectRatio"> Width divided by height </param>
+    /// <param name="nearW"></param>
+    /// <param name="farW"></param>
+    /// <returns></returns>
+    static Matrix4x4 Perspective(float verticalFieldOfView, float aspectRatio, float nearW, float farW)
+    {
+        if ((verticalFieldOfView <= 0.0f) || (aspectRatio <= 0.0f) || (nearW <= 0.0f) || (farW <= nearW))
+        {
+            throw std::exception("Invalid perspective projection");
+        };
+
+        const float scaleY = 1.0f / std::tan(verticalFieldOfView / 2.0f);
+        const float depthScale = farW / (farW - nearW);
+
+        Matrix4x4 matrix;
+
+        matrix.M11 = scaleY / aspectRatio;
+        matrix.M22 = scaleY;
+
+        matrix.M33 = depthScale;
+        matrix.M34 = 1.0f;
+
+        matrix.M43 = -nearW * depthScale;
+        matrix.M44 = 0.0f;
+
+        return matrix;
+    };
+
+
+public:
+
+    Vector4 Transform(const Vector4& vector) const
+    {
+        return Vector4::Store(Transform(vector.Load()));
+    };
+
+    /// <summary>
+    /// Transform a point, W is 1
+    /// </summary>
+    /// <param name="point"></param>
+    /// <returns></returns>
+    Vector4 TransformPoint(const Vector3& point) const
+    {
+        return Transform(Vector4(point, 1.0f));
+    };
+
+    /// <summary>
+    /// Transform a direction, W is 0 so translation doesn't apply
+    /// </summary>
+    /// <param name="direction"></param>
+    /// <returns></returns>
+    Vector3 TransformDirection(const Vector3& direction) const
+    {
+        return Transform(Vector4(direction, 0.0f)).XYZ();
+    };
+
+
+    /// <summary>
+    /// Transform a stream of points stored as separate X, Y and Z arrays, 4 points at a time.
+    /// Points have a W of 1, the transformed points' W is written too because a projection changes it
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <param name="z"></param>
+    /// <param name="outputX"></param>
+    /// <param name="outputY"></param>
+    /// <param name="outputZ"></param>
+    /// <param name="outputW"></param>
+    /// <param name="count"></param>
+    void TransformPoints(const float* x, const float* y, const float* z,
+                         float* outputX, float* outputY, float* outputZ, float* outputW,
+                         std::size_t count) const
+    {
+        const auto transformColumn = [](__m128 pointX, __m128 pointY, __m128 pointZ, float row1, float row2, float row3, float row4)
+        {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(pointX, _mm_set1_ps(row1)), _mm_mul_ps(pointY, _mm_set1_ps(row2))),
+                              _mm_add_ps(_mm_mul_ps(pointZ, _mm_set1_ps(row3)), _mm_set1_ps(row4)));
+        };
+
+        std::size_t index = 0;
+
+        for (; index + 4 <= count; index += 4)
+        {
+            const __m128 pointX = _mm_loadu_ps(x + index);
+            const __m128 pointY = _mm_loadu_ps(y + index);
+            const __m128 pointZ = _mm_loadu_ps(z + index);
+
+            _mm_storeu_ps(outputX + index, transformColumn(pointX, pointY, pointZ, M11, M21, M31, M41));
+            _mm_storeu_ps(outputY + index, transformColumn(pointX, pointY, pointZ, M12, M22, M32, M42));
+            _mm_storeu_ps(outputZ + index, transformColumn(pointX, pointY, pointZ, M13, M23, M33, M43));
+            _mm_storeu_ps(outputW + index, transformColumn(pointX, pointY, pointZ, M14, M24, M34, M44));
+        };
+
+        for (; index < count; index++)
+        {
+            const Vector4 result = TransformPoint({ x[index], y[index], z[index] });
+
+            outputX[index] = result.X;
+            outputY[index] = result.Y;
+            outputZ[index] = result.Z;
+            outputW[index] = result.W;
+        };
+    };
+
+
+    constexpr Matrix4x4 Transposed() const
+    {
+        Matrix4x4 result;
+
+        result.M11 = M11; result.M12 = M21; result.M13 = M31; result.M14 = M41;
+        result.M21 = M12; result.M22 = M22; result.M23 = M32; result.M24 = M42;
+        result.M31 = M13; result.M32 = M23; result.M33 = M33; result.M34 = M43;
+        result.M41 = M14; result.M42 = M24; result.M43 = M34; result.M44 = M44;
+
+        return result;
+    };
+
+    /// <summary>
+    /// Get the linear part, without the translation and projection
+    /// </summary>
+    /// <returns></returns>
+    constexpr Matrix3x3 GetLinear() const
+    {
+        Matrix3x3 result;
+
+        result.M11 = M11; result.M12 = M12; result.M13 = M13;
+        result.M21 = M21; result.M22 = M22; result.M23 = M23;
+        result.M31 = M31; result.M32 = M32; result.M33 = M33;
+
+        return result;
+    };
+
+
+    /// <summary>
+    /// Get the transform that undoes this one.
+    /// The matrix is split into 2x2 blocks and inverted block-wise, every block fits in an SSE register
+    /// </summary>
+    /// <returns></returns>
+    Matrix4x4 Inverse() const
+    {
+        const __m128 row1 = LoadRow(M11);
+        const __m128 row2 = LoadRow(M21);
+        const __m128 row3 = LoadRow(M31);
+        const __m128 row4 = LoadRow(M41);
+
+        // The 2x2 blocks, as [11, 12, 21, 22]
+        const __m128 a = _mm_movelh_ps(row1, row2);
+        const __m128 b = _mm_movehl_ps(row2, row1);
+        const __m128 c = _mm_movelh_ps(row3, row4);
+        const __m128 d = _mm_movehl_ps(row4, row3);
+
+        // The blocks' determinants, [A, B, C, D]
+        const __m128 blockDeterminants = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row2, row4, _MM_SHUFFLE(3, 1, 3, 1))),
+                                                    _mm_mul_ps(_mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row2, row4, _MM_SHUFFLE(2, 0, 2, 0))));
+
+        const __m128 determinantA = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 determinantB = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 determinantC = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 determinantD = _mm_shuffle_ps(blockDeterminants, blockDeterminants, _MM_SHUFFLE(3, 3, 3, 3));
+
+        // adj(D) * C and adj(A) * B
+        const __m128 adjointDC = AdjointMultiply2x2(d, c);
+        const __m128 adjointAB = AdjointMultiply2x2(a, b);
+
+        // The blocks of the inverse, before they're divided by the determinant and transposed back
+        const __m128 x = _mm_sub_ps(_mm_mul_ps(determinantD, a), Multiply2x2(b, adjointDC));
+        const __m128 w = _mm_sub_ps(_mm_mul_ps(determinantA, d), Multiply2x2(c, adjointAB));
+        const __m128 y = _mm_sub_ps(_mm_mul_ps(determinantB, c), MultiplyAdjoint2x2(d, adjointAB));
+        const __m128 z = _mm_sub_ps(_mm_mul_ps(determinantC, b), MultiplyAdjoint2x2(a, adjointDC));
+
+        // det(M) = det(A) * det(D) + det(B) * det(C) - trace(adj(A) * B * adj(D) * C)
+        __m128 trace = _mm_mul_ps(adjointAB, _mm_shuffle_ps(adjointDC, adjointDC, _MM_SHUFFLE(3, 1, 2, 0)));
+        trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+        trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        const __m128 determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(determinantA, determinantD), _mm_mul_ps(determinantB, determinantC)), trace);
+
+        if (_mm_cvtss_f32(determinant) == 0.0f)
+        {
+            throw std::exception("Matrix4x4 can't be inverted, it's determinant is 0");
+        };
+
+        // The blocks are still each other's adjugates, the signs here and the shuffles below undo that
+        const __m128 inverseDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+
+        const __m128 inverseX = _mm_mul_ps(x, inverseDeterminant);
+        const __m128 inverseY = _mm_mul_ps(y, inverseDeterminant);
+        const __m128 inverseZ = _mm_mul_ps(z, inverseDeterminant);
+        const __m128 inverseW = _mm_mul_ps(w, inverseDeterminant);
+
+        Matrix4x4 result;
+
+        StoreRow(result.M11, _mm_shuffle_ps(inverseX, inverseY, _MM_SHUFFLE(1, 3, 1, 3)));
+        StoreRow(result.M21, _mm_shuffle_ps(inverseX, inverseY, _MM_SHUFFLE(0, 2, 0, 2)));
+        StoreRow(result.M31, _mm_shuffle_ps(inverseZ, inverseW, _MM_SHUFFLE(1, 3, 1, 3)));
+        StoreRow(result.M41, _mm_shuffle_ps(inverseZ, inverseW, _MM_SHUFFLE(0, 2, 0, 2)));
+
+        return result;
+    };
+
+
+public:
+
+    /// <summary>
+    /// Combine 2 transforms, the result applies this transform first and then the other.
+    /// Constexpr, for constant transforms, operator * does the same with SSE
+    /// </summary>
+    /// <param name="first"></param>
+    /// <param name="second"></param>
+    /// <returns></returns>
+    static constexpr Matrix4x4 Multiply(const Matrix4x4& first, const Matrix4x4& second)
+    {
+        const auto multiplyRow = [&second](float row1, float row2, float row3, float row4, float& result1, float& result2, float& result3, float& result4)
+        {
+            result1 = row1 * second.M11 + row2 * second.M21 + row3 * second.M31 + row4 * second.M41;
+            result2 = row1 * second.M12 + row2 * second.M22 + row3 * second.M32 + row4 * second.M42;
+            result3 = row1 * second.M13 + row2 * second.M23 + row3 * second.M33 + row4 * second.M43;
+            result4 = row1 * second.M14 + row2 * second.M24 + row3 * second.M34 + row4 * second.M44;
+        };
+
+        Matrix4x4 result;
+
+        multiplyRow(first.M11, first.M12, first.M13, first.M14, result.M11, result.M12, result.M13, result.M14);
+        multiplyRow(first.M21, first.M22, first.M23, first.M24, result.M21, result.M22, result.M23, result.M24);
+        multiplyRow(first.M31, first.M32, first.M33, first.M34, result.M31, result.M32, result.M33, result.M34);
+        multiplyRow(first.M41, first.M42, first.M43, first.M44, result.M41, result.M42, result.M43, result.M44);
+
+        return result;
+    };
+
+    /// <summary>
+    /// Combine 2 transforms, the result applies this transform first and then the other
+    /// </summary>
+    /// <param name="other"></param>
+    /// <returns></returns>
+    Matrix4x4 operator * (const Matrix4x4& other) const
+    {
+        Matrix4x4 result;
+
+        // Every row of the result is that row transformed by the other matrix
+        StoreRow(result.M11, other.Transform(LoadRow(M11)));
+        StoreRow(result.M21, other.Transform(LoadRow(M21)));
+        StoreRow(result.M31, other.Transform(LoadRow(M31)));
+        StoreRow(result.M41, other.Transform(LoadRow(M41)));
+
+        return result;
+    };
+
+
+private:
+
+    /// <summary>
+    /// Load a row from it's first element, the 4 elements are consecutive
+    /// </summary>
+    /// <param name="first"></param>
+    /// <returns></returns>
+    static __m128 LoadRow(const float& first)
+    {
+        return _mm_loadu_ps(&first);
+    };
+
+    static void StoreRow(float& first, __m128 row)
+    {
+        _mm_storeu_ps(&first, row);
+    };
+
+
+    __m128 Transform(__m128 vector) const
+    {
+        const __m128 x = _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 y = _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 z = _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 w = _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3));
+
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, LoadRow(M11)), _mm_mul_ps(y, LoadRow(M21))),
+                          _mm_add_ps(_mm_mul_ps(z, LoadRow(M31)), _mm_mul_ps(w, LoadRow(M41))));
+    };
+
+
+    /// <summary>
+    /// Multiply 2x2 matrices stored as [11, 12, 21, 22]
+    /// </summary>
+    /// <param name="left"></param>
+    /// <param name="right"></param>
+    /// <returns></returns>
+    static __m128 Multiply2x2(__m128 left, __m128 right)
+    {
+        return _mm_add_ps(_mm_mul_ps(left, _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 3, 0))),
+                          _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+    };
+
+    /// <summary>
+    /// adj(left) * right, of 2x2 matrices
+    /// </summary>
+    /// <param name="left"></param>
+    /// <param name="right"></param>
+    /// <returns></returns>
+    static __m128 AdjointMultiply2x2(__m128 left, __m128 right)
+    {
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(0, 0, 3, 3)), right),
+                          _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 0, 3, 2))));
+    };
+
+    /// <summary>
+    /// left * adj(right), of 2x2 matrices
+    /// </summary>
+    /// <param name="left"></param>
+    /// <param name="right"></param>
+    /// <returns></returns>
+    static __m128 MultiplyAdjoint2x2(__m128 left, __m128 right)
+    {
+        return _mm_sub_ps(_mm_mul_ps(left, _mm_shuffle_ps(right, right, _MM_SHUFFLE(0, 3, 0, 3))),
+                          _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+    };
+
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+#include "Vector2D.hpp"
+#include "Matrix3x2.hpp"
+
+
+/// <summary>
+/// A stack of 2D transforms for nesting a camera, zoom, pan and per-object transforms.
+/// Every entry is already combined with the ones below it, so the top is the whole transform from the current space to the screen,
+/// and drawing only ever transforms each vertex once
+/// </summary>
+class TransformStack
+{
+
+private:
+
+    /// <summary>
+    /// The combined transforms, the first is the base and the last is the top
+    /// </summary>
+    std::vector<Matrix3x2> _transforms;
+
+    /// <summary>
+    /// The top's inverse, calculated when it's first needed after the top changed
+    /// </summary>
+    mutable Matrix3x2 _inverse;
+    mutable bool _inverseValid = false;
+
+
+public:
+
+    TransformStack(const Matrix3x2& base = Matrix3x2::Identity())
+    {
+        Reset(base);
+    };
+
+
+public:
+
+    /// <summary>
+    /// Remove every pushed transform and replace the base
+    /// </summary>
+    /// <param name="base"></param>
+    void Reset(const Matrix3x2& base)
+    {
+        _transforms.clear();
+        _transforms.push_back(base);
+
+        _inverseValid = false;
+    };
+
+
+    /// <summary>
+    /// Add a transform on top, it applies before everything already on the stack
+    /// </summary>
+    /// <param name="transform"></param>
+    void Push(const Matrix3x2& transform)
+    {
+        _transforms.push_back(transform * _transforms.back());
+
+        _inverseValid = false;
+    };
+
+    /// <summary>
+    /// Remove the last pushed transform
+    /// </summary>
+    void Pop()
+    {
+        if (_transforms.size() == 1)
+        {
+            throw std::exception("Transform stack has nothing to pop, only the base is left");
+        };
+
+        _transforms.pop_back();
+
+        _inverseValid = false;
+    };
+
+
+public:
+
+    /// <summary>
+    /// Transform a point from the current space to the base's space
+    /// </summary>
+    /// <param name="point"></param>
+    /// <returns></returns>
+    Vector2D Transform(const Vector2D& point) const
+    {
+        return GetTop().Transform(point);
+    };
+
+    void TransformPoints(const float* x, const float* y, float* outputX, float* outputY, std::size_t count) const
+    {
+        GetTop().TransformPoints(x, y, outputX, outputY, count);
+    };
+
+    /// <summary>
+    /// Transform a point from the base's space back to the current space, for picking with the mouse
+    /// </summary>
+    /// <param name="point"></param>
+    /// <returns></returns>
+    Vector2D InverseTransform(const Vector2D& point) const
+    {
+        return GetInverse().Transform(point);
+    };
+
+
+public:
+
+    const Matrix3x2& GetTop() const
+    {
+        return _transforms.back();
+    };
+
+    const Matrix3x2& GetInverse() const
+    {
+        if (_inverseValid == false)
+        {
+            _inverse = GetTop().Inverse();
+            _inverseValid = true;
+        };
+
+        return _inverse;
+    };
+
+    /// <summary>
+    /// Get the number of pushed transforms, 0 when only the base is on the stack
+    /// </summary>
+    /// <returns></returns>
+    std::size_t GetDepth() const
+    {
+        return _transforms.size() - 1;
+    };
+
+};
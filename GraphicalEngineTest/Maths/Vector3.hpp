@@ -0,0 +1,157 @@
+#pragma once
+#include <cmath>
+
+
+/// <summary>
+/// A 3D vector of floats.
+/// Everything except the length and normalization is constexpr, so constant vectors are folded at compile time
+/// </summary>
+class Vector3
+{
+public:
+
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+
+
+public:
+
+    constexpr Vector3() = default;
+
+    constexpr Vector3(float x, float y, float z) :
+        X(x),
+        Y(y),
+        Z(z)
+    {
+    };
+
+
+public:
+
+    constexpr float Dot(const Vector3& other) const
+    {
+        return (X * other.X) + (Y * other.Y) + (Z * other.Z);
+    };
+
+    /// <summary>
+    /// Get the vector perpendicular to both vectors, in a left-handed coordinate system X cross Y is Z
+    /// </summary>
+    /// <param name="other"></param>
+    /// <returns></returns>
+    constexpr Vector3 Cross(const Vector3& other) const
+    {
+        return
+        {
+            (Y * other.Z) - (Z * other.Y),
+            (Z * other.X) - (X * other.Z),
+            (X * other.Y) - (Y * other.X),
+        };
+    };
+
+
+    constexpr float LengthSquare() const
+    {
+        return Dot(*this);
+    };
+
+    float Length() const
+    {
+        return std::sqrt(LengthSquare());
+    };
+
+
+    /// <summary>
+    /// Get the vector with a length of 1, a zero vector has no direction and stays zero
+    /// </summary>
+    /// <returns></returns>
+    Vector3 Normalized() const
+    {
+        const float length = Length();
+
+        if (length == 0.0f)
+            return {};
+
+        return *this * (1.0f / length);
+    };
+
+    Vector3& Normalize()
+    {
+        *this = Normalized();
+
+        return *this;
+    };
+
+
+    #pragma region Operators
+
+public:
+
+    constexpr Vector3 operator - () const
+    {
+        return { -X, -Y, -Z };
+    };
+
+    constexpr Vector3 operator - (const Vector3& rightVector) const
+    {
+        return { X - rightVector.X, Y - rightVector.Y, Z - rightVector.Z };
+    };
+
+    constexpr Vector3& operator -= (const Vector3& rightVector)
+    {
+        X -= rightVector.X;
+        Y -= rightVector.Y;
+        Z -= rightVector.Z;
+
+        return *this;
+    };
+
+
+    constexpr Vector3 operator + (const Vector3& rightVector) const
+    {
+        return { X + rightVector.X, Y + rightVector.Y, Z + rightVector.Z };
+    };
+
+    constexpr Vector3& operator += (const Vector3& rightVector)
+    {
+        X += rightVector.X;
+        Y += rightVector.Y;
+        Z += rightVector.Z;
+
+        return *this;
+    };
+
+
+    constexpr Vector3 operator * (const Vector3& rightVector) const
+    {
+        return { X * rightVector.X, Y * rightVector.Y, Z * rightVector.Z };
+    };
+
+    constexpr Vector3 operator * (float value) const
+    {
+        return { X * value, Y * value, Z * value };
+    };
+
+    constexpr Vector3& operator *= (float value)
+    {
+        X *= value;
+        Y *= value;
+        Z *= value;
+
+        return *this;
+    };
+
+
+    constexpr bool operator == (const Vector3& rightVector) const
+    {
+        return (X == rightVector.X) && (Y == rightVector.Y) && (Z == rightVector.Z);
+    };
+
+    constexpr bool operator != (const Vector3& rightVector) const
+    {
+        return !(*this == rightVector);
+    };
+
+    #pragma endregion
+
+};
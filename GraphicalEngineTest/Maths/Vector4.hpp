@@ -0,0 +1,152 @@
+#pragma once
+#include <cmath>
+#include <emmintrin.h>
+
+#include "Vector3.hpp"
+
+
+/// <summary>
+/// A 4D vector of floats, usually a homogeneous position before the divide by W.
+/// The members are laid out like an SSE register, Load and Store move the vector in and out of one
+/// </summary>
+class Vector4
+{
+public:
+
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+    float W = 0.0f;
+
+
+public:
+
+    constexpr Vector4() = default;
+
+    constexpr Vector4(float x, float y, float z, float w) :
+        X(x),
+        Y(y),
+        Z(z),
+        W(w)
+    {
+    };
+
+    /// <summary>
+    /// Extend a 3D vector, W is 1 for a point and 0 for a direction
+    /// </summary>
+    /// <param name="vector"></param>
+    /// <param name="w"></param>
+    constexpr Vector4(const Vector3& vector, float w) :
+        X(vector.X),
+        Y(vector.Y),
+        Z(vector.Z),
+        W(w)
+    {
+    };
+
+
+public:
+
+    __m128 Load() const
+    {
+        return _mm_loadu_ps(&X);
+    };
+
+    static Vector4 Store(__m128 vector)
+    {
+        Vector4 result;
+        _mm_storeu_ps(&result.X, vector);
+
+        return result;
+    };
+
+
+public:
+
+    constexpr float Dot(const Vector4& other) const
+    {
+        return (X * other.X) + (Y * other.Y) + (Z * other.Z) + (W * other.W);
+    };
+
+    constexpr float LengthSquare() const
+    {
+        return Dot(*this);
+    };
+
+    float Length() const
+    {
+        return std::sqrt(LengthSquare());
+    };
+
+    /// <summary>
+    /// Get the vector with a length of 1, a zero vector has no direction and stays zero
+    /// </summary>
+    /// <returns></returns>
+    Vector4 Normalized() const
+    {
+        const float length = Length();
+
+        if (length == 0.0f)
+            return {};
+
+        return *this * (1.0f / length);
+    };
+
+
+    /// <summary>
+    /// Get the X, Y and Z, without dividing by W
+    /// </summary>
+    /// <returns></returns>
+    constexpr Vector3 XYZ() const
+    {
+        return { X, Y, Z };
+    };
+
+    /// <summary>
+    /// Divide X, Y and Z by W, W has to be non-zero
+    /// </summary>
+    /// <returns></returns>
+    constexpr Vector3 PerspectiveDivide() const
+    {
+        return XYZ() * (1.0f / W);
+    };
+
+
+    #pragma region Operators
+
+public:
+
+    constexpr Vector4 operator - (const Vector4& rightVector) const
+    {
+        return { X - rightVector.X, Y - rightVector.Y, Z - rightVector.Z, W - rightVector.W };
+    };
+
+    constexpr Vector4 operator + (const Vector4& rightVector) const
+    {
+        return { X + rightVector.X, Y + rightVector.Y, Z + rightVector.Z, W + rightVector.W };
+    };
+
+    constexpr Vector4 operator * (const Vector4& rightVector) const
+    {
+        return { X * rightVector.X, Y * rightVector.Y, Z * rightVector.Z, W * rightVector.W };
+    };
+
+    constexpr Vector4 operator * (float value) const
+    {
+        return { X * value, Y * value, Z * value, W * value };
+    };
+
+
+    constexpr bool operator == (const Vector4& rightVector) const
+    {
+        return (X == rightVector.X) && (Y == rightVector.Y) && (Z == rightVector.Z) && (W == rightVector.W);
+    };
+
+    constexpr bool operator != (const Vector4& rightVector) const
+    {
+        return !(*this == rightVector);
+    };
+
+    #pragma endregion
+
+};
@@ -2,6 +2,7 @@
 
 #include "Vector2D.hpp"
 #include "Mouse.hpp"
+#include "Matrix3x2.hpp"
 
 class VectorTransformer
 {
@@ -10,63 +11,78 @@ private:
     int _consoleWindowWidth;
     int _consoleWindowHeight;
 
+    /// <summary>
+    /// Where the cartesian origin is on the screen, calculated once instead of with every conversion
+    /// </summary>
+    float _halfWidth;
+    float _halfHeight;
+
 
 public:
 
     VectorTransformer(int consoleWindowWidth, int consoleWindowHeight) :
         _consoleWindowWidth(consoleWindowWidth),
-        _consoleWindowHeight(consoleWindowHeight)
+        _consoleWindowHeight(consoleWindowHeight),
+        _halfWidth(static_cast<float>(consoleWindowWidth / 2)),
+        _halfHeight(static_cast<float>(consoleWindowHeight / 2))
     {
     };
 
     VectorTransformer(const Window& window) :
-        _consoleWindowWidth(window.GetWindowWidth()),
-        _consoleWindowHeight(window.GetWindowHeight())
+        VectorTransformer(window.GetWindowWidth(), window.GetWindowHeight())
     {
     };
 
 public:
 
-    Vector2D CartesianToScreenSpace(float x, float y)
+    /// <summary>
+    /// Get the cartesian to screen space conversion as a transform, so it can be combined with others and applied to whole meshes
+    /// </summary>
+    /// <returns></returns>
+    Matrix3x2 GetCartesianToScreen() const
+    {
+        return Matrix3x2::Scale(1.0f, -1.0f) * Matrix3x2::Translation(_halfWidth, _halfHeight);
+    };
+
+
+    Vector2D CartesianToScreenSpace(float x, float y) const
     {
-        float screenSpaceX = x + (_consoleWindowWidth / 2);
-        float screenSpaceY = (-y) + (_consoleWindowHeight / 2);
+        float screenSpaceX = x + _halfWidth;
+        float screenSpaceY = (-y) + _halfHeight;
 
         return { screenSpaceX, screenSpaceY };
     };
 
-    Vector2D CartesianVectorToScreenSpace(const Vector2D& vector)
+    Vector2D CartesianVectorToScreenSpace(const Vector2D& vector) const
     {
         return CartesianToScreenSpace(vector.X, vector.Y);
     };
 
-    Vector2D NDCToScreenSpace(const Vector2D& vector)
+    Vector2D NDCToScreenSpace(const Vector2D& vector) const
     {
-        return { ((vector.X + 1.0f) * ((_consoleWindowWidth) / 2)),  ((-vector.Y + 1.0f) * ((_consoleWindowHeight) / 2)) };
+        return { ((vector.X + 1.0f) * _halfWidth),  ((-vector.Y + 1.0f) * _halfHeight) };
     };
 
 
-    Vector2D MouseToVector(short x, short y)
+    Vector2D MouseToVector(short x, short y) const
     {
         return { static_cast<float>(x), static_cast<float>(y) };
     };
 
-    Vector2D MouseToVector(const Mouse& mouse)
+    Vector2D MouseToVector(const Mouse& mouse) const
     {
         return { static_cast<float>(mouse.X), static_cast<float>(mouse.Y) };
     };
 
 
-    Vector2D MouseToCartesian(short x, short y)
+    Vector2D MouseToCartesian(short x, short y) const
     {
-         // return { static_cast<float>(x) - _consoleWindowWidth / 2, -(static_cast<float>(y) - _consoleWindowHeight / 2) };
-        return { static_cast<float>(x) - (_consoleWindowWidth / 2), (static_cast<float>(-y)) + (_consoleWindowHeight / 2) };
+        return { static_cast<float>(x) - _halfWidth, (static_cast<float>(-y)) + _halfHeight };
     };
-    
-    Vector2D MouseToCartesian(const Mouse& mouse)
+
+    Vector2D MouseToCartesian(const Mouse& mouse) const
     {
-        // return { static_cast<float>(x) - _consoleWindowWidth / 2, -(static_cast<float>(y) - _consoleWindowHeight / 2) };
-        return { static_cast<float>(mouse.X) - (_consoleWindowWidth / 2), (static_cast<float>(-mouse.Y)) + (_consoleWindowHeight / 2) };
+        return { static_cast<float>(mouse.X) - _halfWidth, (static_cast<float>(-mouse.Y)) + _halfHeight };
     };
 
 };
\ No newline at end of file
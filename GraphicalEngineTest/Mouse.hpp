@@ -14,6 +14,9 @@ class Mouse
     // Allow Window class to set some private data that I don't want other classes to touch
     friend class Window;
 
+    // Input replay sets the same state the window would
+    friend class InputPlayer;
+
 private:
 
     /// <summary>
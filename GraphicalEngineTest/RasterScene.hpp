@@ -1,5 +1,8 @@
 #include <Array>
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string_view>
 
 #include "IScene.hpp"
 #include "Window.hpp"
@@ -7,6 +10,10 @@
 #include "VectorTransformer.hpp"
 #include "Vector2D.hpp"
 #include "FontSheet.hpp"
+#include "Sprite.hpp"
+#include "Mesh.hpp"
+#include "Matrix3x2.hpp"
+#include "TransformStack.hpp"
 
 
 class RasterScene : public IScene
@@ -19,8 +26,62 @@ private:
     float _degreesScalar = 1.f;
     VectorTransformer _vectorTransformer;
 
+    /// <summary>
+    /// The transforms from the cartesian plane to the screen, rebuilt every frame
+    /// </summary>
+    TransformStack _view;
+
+    /// <summary>
+    /// The cartesian point in the middle of the screen, moved with the arrow keys
+    /// </summary>
+    float _cameraX = 0.0f;
+    float _cameraY = 0.0f;
+
+    /// <summary>
+    /// The camera's scale, changed with Q and E
+    /// </summary>
+    float _zoom = 1.0f;
+
     FontSheet _fontSheet;
 
+    /// <summary>
+    /// A checkerboard drawn behind the triangle, many small triangles that share their vertices
+    /// </summary>
+    Mesh _checkerboard;
+
+    /// <summary>
+    /// The checkerboard's rotation in radians, turned by the mouse wheel like the triangle
+    /// </summary>
+    float _checkerboardAngle = 0.0f;
+
+    static constexpr int CHECKERBOARD_COLUMNS = 40;
+    static constexpr int CHECKERBOARD_ROWS = 30;
+    static constexpr float CHECKERBOARD_CELL_SIZE = 20.0f;
+
+    /// <summary>
+    /// A textured floor seen in perspective, in front of the checkerboard
+    /// </summary>
+    Mesh _floor;
+
+    Sprite _floorTexture;
+
+    TextureFilter _floorFilter = TextureFilter::Bilinear;
+
+    /// <summary>
+    /// Limits the meshes to the middle of the screen
+    /// </summary>
+    bool _scissorEnabled = false;
+
+    /// <summary>
+    /// If true the checkerboard is binned and drawn by the graphics worker threads
+    /// </summary>
+    bool _parallelRendering = true;
+
+    /// <summary>
+    /// The editable triangle, with a different colour at every corner
+    /// </summary>
+    Mesh _triangle;
+
 
     std::array<Vector2D, 3> _points =
     {
@@ -39,9 +100,14 @@ public:
         _graphics(graphics),
         _window(window),
         _vectorTransformer(VectorTransformer(_window)),
-        _fontSheet(_graphics, 13, 24)
+        _fontSheet(_graphics, 13, 24),
+        _floorTexture(_graphics)
     {
         _fontSheet.LoadFromFile(L"Resources\\Consolas13x24.bmp");
+        _floorTexture.LoadFromFile(L"Resources\\dg_iso32.bmp");
+
+        BuildCheckerboard();
+        BuildFloor();
 
         _window.GetMouse().AddMouseWheelEventHandler([&](int delta)
         {
@@ -57,417 +123,237 @@ public:
 
     virtual void UpdateScene(float deltaTime) override
     {
-    };
-
-
-    void DrawTopFacingTriangle(const Vector2D& top, const Vector2D& right, const Vector2D& left, const Colour& colour = Colours::White)
-    {
-        float height = top.Y - left.Y;
-
-        // Run / Rise
-        if ((top.X == left.X) ||
-            (top.X == right.X))
-
-        {
-            float slope1 = (top.X - left.X) / (top.Y - left.Y);
-            float b1 = left.X - (slope1 * left.Y);
-
-
-            float slope2 = (top.X - right.X) / (top.Y - right.Y);
-            float b2 = top.X - (slope2 * top.Y);
-
-
-            auto f = [](float y, float slope, float b)
-            {
-                return (y * slope) + b;
-            };
-
-            auto fInv = [](float x, float slope, float b)
-            {
-                return (x - b) / slope;
-            };
+        // Switch the floor's texture filter
+        if (_window.GetKeyboard().GetKeyState('F') == KeyState::Pressed)
+            _floorFilter = (_floorFilter == TextureFilter::Bilinear) ? TextureFilter::Nearest : TextureFilter::Bilinear;
 
+        UpdateCamera(deltaTime);
 
-            int deltaY = -1;
-            int yBegin = top.Y;
-            int yEnd = left.Y;
+        if (_window.GetKeyboard().GetKeyState('S') == KeyState::Pressed)
+            _scissorEnabled = !_scissorEnabled;
 
-            int deltaX = 1;
+        // Switch between parallel and serial checkerboard rendering, for comparison
+        if (_window.GetKeyboard().GetKeyState('P') == KeyState::Pressed)
+            _parallelRendering = !_parallelRendering;
 
-            for (int y = yBegin; y != yEnd; y += deltaY)
-            {
-                int xBegin = f(y, slope1, b1);
-                int xEnd = f(y, slope2, b2);
-
-                if (xBegin > xEnd)
-                    deltaX = -1;
-                else
-                    deltaX = 1;
-
-                for (int x = xBegin; x != xEnd; x += deltaX)
-                {
-                    _graphics.DrawPixel(_vectorTransformer.CartesianToScreenSpace(x, y), colour, false);
-                };
-            };
-        }
-        // Rise / Run
-        else
+        // The floor and the triangle are depth tested against each other
+        if (_window.GetKeyboard().GetKeyState('Z') == KeyState::Pressed)
         {
-            float slope1 = (top.Y - left.Y) / (top.X - left.X);
-
-            float b1 = top.Y - (slope1 * top.X);
-
-
-            float slope2 = (top.Y - right.Y) / (top.X - right.X);
-
-            float b2 = top.Y - (slope2 * top.X);
-
-
-            auto f = [](float x, float slope, float b)
-            {
-                return (slope * x) + b;
-            };
-
-            auto fInv = [](float y, float slope, float b)
-            {
-                return (y - b) / slope;
-            };
-
-
-            int deltaY = -1;
-            int yBegin = top.Y;
-            int yEnd = left.Y;
-
-            int deltaX = -1;
-
-            for (int y = yBegin; y > yEnd; y += deltaY)
-            {
-                int beginX = fInv(y, slope1, b1);
-                int endX = fInv(y, slope2, b2);
-
-                if (beginX > endX)
-                    deltaX = -1;
-                else
-                    deltaX = 1;
-
-                for (int x = beginX; x != endX; x += deltaX)
-                {
-                    _graphics.DrawPixel(_vectorTransformer.CartesianVectorToScreenSpace({ x, y }), colour, false);
-                };
-            };
+            if (_graphics.IsDepthBufferEnabled() == true)
+                _graphics.DisableDepthBuffer();
+            else
+                _graphics.EnableDepthBuffer();
         };
     };
 
 
-    void DrawBottomFacingTriangle(const Vector2D& bottom, const Vector2D& left, const Vector2D& right, const Colour& colour = Colours::White)
+    virtual void DrawScene() override
     {
-        float height = left.Y - bottom.Y;
-
-        // Run / Rise
-        if ((bottom.X == left.X) ||
-            (bottom.X == right.X))
-        {
-            float slope1 = (bottom.X - left.X) / (bottom.Y - left.Y);
-            float b1 = bottom.X - (slope1 * bottom.Y);
-
-
-            float slope2 = (bottom.X - right.X) / (bottom.Y - right.Y);
-            float b2 = bottom.X - (slope2 * bottom.Y);
-
+        Colour colour { 255, 0, 0 };
 
-            auto f = [](float y, float slope, float b)
-            {
-                return (y * slope) + b;
-            };
+        for (auto& point : _points)
+            point.RotateDeg(_degrees);
 
-            auto fInv = [](float x, float slope, float b)
-            {
-                return (x - b) / slope;
-            };
+        _checkerboardAngle += Maths::DegreesToRadians(_degrees);
 
+        if (_scissorEnabled == true)
+            _graphics.SetScissor(_graphics.GetWidth() / 4, _graphics.GetHeight() / 4, _graphics.GetWidth() / 2, _graphics.GetHeight() / 2);
 
-            int deltaY = -1;
-            int yBegin = left.Y;
-            int yEnd = bottom.Y;
+        // The camera pans and zooms the cartesian plane, then it's flipped and moved to the middle of the screen
+        _view.Reset(_vectorTransformer.GetCartesianToScreen());
+        _view.Push(Matrix3x2::Translation(-_cameraX, -_cameraY) * Matrix3x2::Scale(_zoom, _zoom));
 
-            int deltaX = 1;
+        // The checkerboard rotates around the origin
+        _view.Push(Matrix3x2::Rotation(_checkerboardAngle));
 
-            for (int y = yBegin; y != yEnd; y += deltaY)
-            {
-                int xBegin = f(y, slope1, b1);
-                int xEnd = f(y, slope2, b2);
-
-                if (xBegin > xEnd)
-                    deltaX = -1;
-                else
-                    deltaX = 1;
-
-                for (int x = xBegin; x != xEnd; x += deltaX)
-                {
-                    _graphics.DrawPixel(_vectorTransformer.CartesianToScreenSpace(x, y), colour, false);
-                };
-            };
-        }
-        // Rise / Run
+        if (_parallelRendering == true)
+            _graphics.DrawMeshParallel(_checkerboard, _view.GetTop(), { 40, 40, 90, 255 });
         else
-        {
-            float slope1 = (bottom.Y - left.Y) / (bottom.X - left.X);
+            _graphics.DrawMesh(_checkerboard, _view.GetTop(), { 40, 40, 90, 255 });
 
-            float b1 = left.Y - (slope1 * left.X);
+        _view.Pop();
 
+        // The floor has it's own perspective, the camera doesn't move it
+        _graphics.DrawShadedMesh(_floor, _vectorTransformer.GetCartesianToScreen(), &_floorTexture.Pixels, _floorFilter);
 
-            float slope2 = (bottom.Y - right.Y) / (bottom.X - right.X);
 
-            float b2 = bottom.Y - (slope2 * bottom.X);
+        // The points can be dragged into either winding order, so the triangle is never culled
+        _triangle.Clear();
+        _triangle.AddVertex(_points[0], Colours::Red, { 0.0f, 0.0f });
+        _triangle.AddVertex(_points[1], Colours::Green, { 0.0f, 0.0f });
+        _triangle.AddVertex(_points[2], Colours::Blue, { 0.0f, 0.0f });
+        _triangle.AddTriangle(0, 1, 2);
 
+        _graphics.DrawShadedMesh(_triangle, _view.GetTop(), nullptr, TextureFilter::Nearest, TriangleCulling::None);
 
-            auto f = [](float x, float slope, float b)
-            {
-                return (slope * x) + b;
-            };
-
-            auto fInv = [](float y, float slope, float b)
-            {
-                return (y - b) / slope;
-            };
-
+        _graphics.ResetScissor();
 
-            int deltaY = -1;
-            int yBegin = left.Y;
-            int yEnd = bottom.Y;
 
-            int deltaX = 1;
-            // if (top.X < right.X)
-            //     deltaX = -1;
-            // else
-            //     deltaX = 1;
+        // The points on screen, converted once for the outline, the labels and the highlights
+        std::array<float, 3> pointsX;
+        std::array<float, 3> pointsY;
 
-            for (int y = yBegin; y != yEnd; y += deltaY)
-            {
-                int beginX = fInv(y, slope1, b1);
-                int endX = fInv(y, slope2, b2);
-
-                if (beginX > endX)
-                    deltaX = -1;
-                else
-                    deltaX = 1;
-
-                for (int x = beginX; x != endX; x += deltaX)
-                {
-                    _graphics.DrawPixel(_vectorTransformer.CartesianVectorToScreenSpace({ x, y }), colour, false);
-                };
-            };
+        for (std::size_t index = 0; index < _points.size(); index++)
+        {
+            pointsX[index] = _points[index].X;
+            pointsY[index] = _points[index].Y;
         };
-    };
-
-
-    virtual void DrawScene() override
-    {
-        Colour colour { 255, 0, 0 };
 
-        for (auto& point : _points)
-            point.RotateDeg(_degrees);
+        std::array<float, 3> screenX;
+        std::array<float, 3> screenY;
 
+        _view.TransformPoints(pointsX.data(), pointsY.data(), screenX.data(), screenY.data(), _points.size());
 
-        if (std::roundf(_points[0].Y) == std::roundf(_points[1].Y))
-        {
-            bool topFacing = _points[2].Y > _points[0].Y;
 
-            // Top facing triangle
-            if (topFacing == true)
-            {
-                DrawTopFacingTriangle(_points[2], _points[0], _points[1]);
-            }
-             // Bottom facing triangle
-            else
-            {
-                DrawBottomFacingTriangle(_points[2], _points[0], _points[1]);
-            };
-        }
-        else if (std::roundf(_points[0].Y) == std::roundf(_points[2].Y))
+        // Outline 
+        for (std::size_t index = 0; index < _points.size(); index++)
         {
-            bool topFacing = _points[1].Y > _points[0].Y;
-
-            //  Top facing triangle
-            if (topFacing == true)
-            {
-                DrawTopFacingTriangle(_points[1], _points[0], _points[2]);
-            }
-            //  Bottom facing triangle
-            else
-            {
-                DrawBottomFacingTriangle(_points[1], _points[0], _points[2]);
-            };
+            const std::size_t next = (index + 1) % _points.size();
 
-        }
-        else if (std::roundf(_points[1].Y) == std::roundf(_points[2].Y))
-        {
-            bool topFacing = _points[0].Y > _points[1].Y;
+            _graphics.DrawLine({ screenX[index], screenY[index] }, { screenX[next], screenY[next] }, colour, false);
+        };
 
-             // Top facing triangle
-            if (topFacing == true)
-            {
-                DrawTopFacingTriangle(_points[0], _points[1], _points[2]);
-            }
-             // Bottom facing triangle
-            else
-            {
-                DrawBottomFacingTriangle(_points[0], _points[1], _points[2]);
-            };
-        }
-        else
-        {
-            const Vector2D& topPoint = *std::max_element(_points.begin(), _points.end(),
-                                                         [](const Vector2D& point1, const Vector2D& point2)
-            {
-                return point2.Y > point1.Y;
-            });
 
-            const Vector2D& bottomPoint = *std::max_element(_points.begin(), _points.end(),
-                                                            [](const Vector2D& point1, const Vector2D& point2)
-            {
-                return point1.Y > point2.Y;
-            });
+        _fontSheet.DrawString({ screenX[0], screenY[0] }, "p0", 0.7f);
+        _fontSheet.DrawString({ screenX[1], screenY[1] }, "p1", 0.7f);
+        _fontSheet.DrawString({ screenX[2], screenY[2] }, "p2", 0.7f);
 
-            Vector2D const* midPoint = nullptr;
 
 
-            if ((topPoint == _points[0]) &&
-                (bottomPoint == _points[1]))
-            {
-                midPoint = &_points[2];
-            };
+        constexpr int margin = 5;
 
-            if ((topPoint == _points[0]) &&
-                (bottomPoint == _points[2]))
-            {
-                midPoint = &_points[1];
-            };
+        // The mouse picks points in their own space, through the inverse of the view
+        const Vector2D mousePosition = _view.InverseTransform(_vectorTransformer.MouseToVector(_window.GetMouse()));
 
+        for (std::size_t index = 0; index < _points.size(); index++)
+        {
+            Vector2D& point = _points[index];
 
+            if ((std::fabs(mousePosition.X - point.X) >= margin) ||
+                (std::fabs(mousePosition.Y - point.Y) >= margin))
+                continue;
 
-            if ((topPoint == _points[1]) &&
-                (bottomPoint == _points[0]))
-            {
-                midPoint = &_points[2];
-            };
 
-            if ((topPoint == _points[1]) &&
-                (bottomPoint == _points[2]))
-            {
-                midPoint = &_points[0];
-            };
+            // Highlight the point with a square around it's position on screen
+            const int left = static_cast<int>(screenX[index]) - margin;
+            const int top = static_cast<int>(screenY[index]) - margin;
 
+            for (int y = top; y < top + margin * 2; y++)
+                for (int x = left; x < left + margin * 2; x++)
+                    _graphics.DrawPixel(x, y, Colours::Magenta, false);
 
 
-            if ((topPoint == _points[2]) &&
-                (bottomPoint == _points[0]))
-            {
-                midPoint = &_points[1];
-            };
+            if (_window.GetMouse().LeftMouseButton == KeyState::Held)
+                point = mousePosition;
 
-            if ((topPoint == _points[2]) &&
-                (bottomPoint == _points[1]))
-            {
-                midPoint = &_points[0];
-            };
 
+            // Format the label into frame memory, it only has to live until the string is drawn
+            constexpr std::size_t labelCapacity = 32;
+            char* label = _graphics.GetFrameArena().GetArena().AllocateArray<char>(labelCapacity);
 
-            if (midPoint == nullptr)
-                return;
+            const int labelLength = std::snprintf(label, labelCapacity, "(%d,%d)", static_cast<int>(point.X), static_cast<int>(point.Y));
 
+            _fontSheet.DrawString(_view.Transform({ mousePosition.X, mousePosition.Y + margin }),
+                                  std::string_view(label, labelLength),
+                                  0.7f);
+        };
 
-            // Run / Rise
-            if (bottomPoint.X == topPoint.X)
-            {
-                float s1 = (topPoint.X - bottomPoint.X) / (topPoint.Y - bottomPoint.Y);
-                float b1 = topPoint.X - (s1 * topPoint.Y);
+    };
 
-                int beginX = (s1 * midPoint->Y) + b1;
-                int endX = midPoint->X;
 
+private:
 
-                DrawTopFacingTriangle(topPoint, { static_cast<float>(beginX), midPoint->Y }, *midPoint);
-                DrawBottomFacingTriangle(bottomPoint, { static_cast<float>(beginX), midPoint->Y }, *midPoint);
+    /// <summary>
+    /// Pan and zoom the camera with the keyboard
+    /// </summary>
+    /// <param name="deltaTime"></param>
+    void UpdateCamera(float deltaTime)
+    {
+        const Keyboard& keyboard = _window.GetKeyboard();
 
+        // Pans the same distance on screen at any zoom
+        const float panDistance = 300.0f * deltaTime / _zoom;
 
-                _graphics.DrawLine(_vectorTransformer.CartesianVectorToScreenSpace({ static_cast<float>(beginX), midPoint->Y }), 
-                                   _vectorTransformer.CartesianVectorToScreenSpace(*midPoint), 
-                                   Colours::Red, false);
-            }
-            // Rise / Run
-            else
-            {
-                float s1 = (topPoint.Y - bottomPoint.Y) / (topPoint.X - bottomPoint.X);
-                float b1 = topPoint.Y - (s1 * topPoint.X);
+        if (keyboard.GetKeyState(VK_LEFT) == KeyState::Held)
+            _cameraX -= panDistance;
+        else if (keyboard.GetKeyState(VK_RIGHT) == KeyState::Held)
+            _cameraX += panDistance;
 
-                int beginX = midPoint->X;
-                int endX = (midPoint->Y - b1) / s1;
+        if (keyboard.GetKeyState(VK_DOWN) == KeyState::Held)
+            _cameraY -= panDistance;
+        else if (keyboard.GetKeyState(VK_UP) == KeyState::Held)
+            _cameraY += panDistance;
 
+        if (keyboard.GetKeyState('E') == KeyState::Held)
+            _zoom *= 1.0f + deltaTime;
+        else if (keyboard.GetKeyState('Q') == KeyState::Held)
+            _zoom /= 1.0f + deltaTime;
+    };
 
-                DrawTopFacingTriangle(topPoint, { static_cast<float>(endX), midPoint->Y }, *midPoint);
-                DrawBottomFacingTriangle(bottomPoint, { static_cast<float>(endX), midPoint->Y }, *midPoint);
 
+    /// <summary>
+    /// Fill the checkerboard mesh, every other cell of a grid centred on the origin, as 2 counter-clockwise triangles
+    /// </summary>
+    void BuildCheckerboard()
+    {
+        const int columnVertices = CHECKERBOARD_COLUMNS + 1;
+        const int rowVertices = CHECKERBOARD_ROWS + 1;
 
+        _checkerboard.Reserve(static_cast<std::size_t>(columnVertices) * rowVertices, CHECKERBOARD_COLUMNS * CHECKERBOARD_ROWS);
 
-                _graphics.DrawLine(_vectorTransformer.CartesianVectorToScreenSpace({ static_cast<float>(endX), midPoint->Y }),
-                                   _vectorTransformer.CartesianVectorToScreenSpace(*midPoint),
-                                   Colours::Red, false);
-            };
-        };
+        const float left = -(CHECKERBOARD_COLUMNS * CHECKERBOARD_CELL_SIZE) / 2.0f;
+        const float bottom = -(CHECKERBOARD_ROWS * CHECKERBOARD_CELL_SIZE) / 2.0f;
 
+        for (int row = 0; row < rowVertices; row++)
+            for (int column = 0; column < columnVertices; column++)
+                _checkerboard.AddVertex({ left + column * CHECKERBOARD_CELL_SIZE, bottom + row * CHECKERBOARD_CELL_SIZE });
 
-        // Outline 
-        for (std::size_t index = 0; index < _points.size() - 1; index++)
+        for (int row = 0; row < CHECKERBOARD_ROWS; row++)
         {
-            _graphics.DrawLine(_vectorTransformer.CartesianVectorToScreenSpace(_points[index]), _vectorTransformer.CartesianVectorToScreenSpace(_points[index + 1]), colour, false);
-        };
-
-        _graphics.DrawLine(_vectorTransformer.CartesianVectorToScreenSpace(*(_points.end() - 1)), _vectorTransformer.CartesianVectorToScreenSpace(*_points.begin()), colour, false);
+            for (int column = 0; column < CHECKERBOARD_COLUMNS; column++)
+            {
+                if (((row + column) % 2) != 0)
+                    continue;
 
+                const std::uint32_t bottomLeft = static_cast<std::uint32_t>(row * columnVertices + column);
+                const std::uint32_t bottomRight = bottomLeft + 1;
+                const std::uint32_t topLeft = bottomLeft + columnVertices;
+                const std::uint32_t topRight = topLeft + 1;
 
-        _fontSheet.DrawString(_vectorTransformer.CartesianVectorToScreenSpace(_points[0]), "p0", 0.7f);
-        _fontSheet.DrawString(_vectorTransformer.CartesianVectorToScreenSpace(_points[1]), "p1", 0.7f);
-        _fontSheet.DrawString(_vectorTransformer.CartesianVectorToScreenSpace(_points[2]), "p2", 0.7f);
+                _checkerboard.AddTriangle(bottomLeft, bottomRight, topRight);
+                _checkerboard.AddTriangle(bottomLeft, topRight, topLeft);
+            };
+        };
+    };
 
 
+    /// <summary>
+    /// Fill the floor mesh, a rectangle on the plane y = -1 around a camera at the origin looking down the z axis.
+    /// The corners are given before the perspective divide with their depth as W, the near ones are behind the camera,
+    /// so the floor is clipped at the near plane when it's drawn
+    /// </summary>
+    void BuildFloor()
+    {
+        constexpr float focalLength = 300.0f;
 
-        int margin = 5;
+        constexpr float floorY = -1.0f;
+        constexpr float halfWidth = 2.0f;
+        constexpr float nearZ = -2.0f;
+        constexpr float farZ = 8.0f;
 
-        for (Vector2D& point : _points)
+        // The texture repeats twice across and 5 times along the floor
+        const auto addCorner = [&](float x, float z, float u, float v)
         {
-            auto mousePositionCartesian = _vectorTransformer.MouseToCartesian(_window.GetMouse());
-
-
-            for (int x = point.X - margin; x < point.X + margin; x++)
-            {
-                for (int y = point.Y - margin; y < point.Y + margin; y++)
-                {
-                    if ((mousePositionCartesian.X == x) &&
-                        mousePositionCartesian.Y == y)
-                    {
-                        for (int _x = point.X - margin; _x < point.X + margin; _x++)
-                            for (int _y = point.Y - margin; _y < point.Y + margin; _y++)
-                                _graphics.DrawPixel(_vectorTransformer.CartesianToScreenSpace(_x, _y), Colours::Magenta, false);
-
-
-                        if (_window.GetMouse().LeftMouseButton == KeyState::Held)
-                            point = mousePositionCartesian;
-
-
-                        _fontSheet.DrawString(_vectorTransformer.CartesianToScreenSpace(mousePositionCartesian.X, mousePositionCartesian.Y + margin),
-                                              std::string("(")
-                                              .append(std::to_string(static_cast<int>(point.X)))
-                                              .append(",")
-                                              .append(std::to_string(static_cast<int>(point.Y)))
-                                              .append(")"),
-                                              0.7f);
-                    };
-                };
-            };
-
-
+            return _floor.AddVertex({ x * focalLength, floorY * focalLength }, Colours::White, { u, v }, z);
         };
 
+        const std::uint32_t nearLeft = addCorner(-halfWidth, nearZ, 0.0f, 0.0f);
+        const std::uint32_t nearRight = addCorner(halfWidth, nearZ, 2.0f, 0.0f);
+        const std::uint32_t farRight = addCorner(halfWidth, farZ, 2.0f, 5.0f);
+        const std::uint32_t farLeft = addCorner(-halfWidth, farZ, 0.0f, 5.0f);
+
+        _floor.AddTriangle(nearLeft, nearRight, farRight);
+        _floor.AddTriangle(nearLeft, farRight, farLeft);
     };
+
 };
\ No newline at end of file
@@ -5,13 +5,26 @@
 
 #include <cmath>
 #include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <emmintrin.h>
 
 #include "IScene.hpp"
 #include "Vector2D.hpp"
 #include "VectorTransformer.hpp"
 #include "Maths.hpp"
+#include "GridRayCast.hpp"
 #include "Button.hpp"
 #include "StaticFontSheet.hpp"
+#include "SDFFontSheet.hpp"
+#include "ImageBuffer.hpp"
+#include "ImageTranspose.hpp"
+#include "WallTexture.hpp"
+#include "TileMap.hpp"
+#include "BillboardSprite.hpp"
+#include "CachedLayer.hpp"
 
 class RayCasterScene : public IScene
 {
@@ -27,22 +40,308 @@ private:
 
     float _playerLookAtAngle = 0.0f;
 
-    int _mapWidth = 10;
-    int _mapHeight = 10;
-
     float _playerFOV = Maths::DegreesToRadians(90);
 
     float _maxDepth = 10;
 
-    bool* _map;
+    TileMap _map;
+
+    /// <summary>
+    /// Number of cells the minimap shows on each axis, centered on the player
+    /// </summary>
+    static constexpr int MINIMAP_CELLS = 16;
+
+    /// <summary>
+    /// The minimap's background and walls, the player and view cone are drawn over it every frame
+    /// </summary>
+    CachedLayer _miniMapLayer;
+
+    /// <summary>
+    /// The first cell and map version the minimap layer was drawn for
+    /// </summary>
+    int _miniMapFirstCellX = -1;
+    int _miniMapFirstCellY = -1;
+    std::uint64_t _miniMapVersion = 0;
 
     std::function<void(int, int)> _rawMouseMovedHandler;
 
     FontSheet _fontSheet;
 
+    /// <summary>
+    /// Distance field font, used for text that is drawn at scales other than 1
+    /// </summary>
+    SDFFontSheet _sdfFontSheet;
+
     Button _button;
 
-    StaticBitmap staticBitmap = { 0 };
+    StaticBitmap staticBitmap;
+
+    /// <summary>
+    /// Where the ceiling, wall and floor of a single screen column start
+    /// </summary>
+    struct ColumnSpan
+    {
+        int Ceiling;
+        int Floor;
+
+        /// <summary>
+        /// The texture column (of the selected mip level) mapped onto the wall
+        /// </summary>
+        const Colour* TextureColumn;
+
+        /// <summary>
+        /// Texel index mask, the mip level size minus 1
+        /// </summary>
+        std::uint32_t TextureMask;
+
+        /// <summary>
+        /// 16.16 fixed point texel position of the first wall pixel, and the step between 2 wall pixels
+        /// </summary>
+        std::uint32_t TextureCoordinate;
+        std::uint32_t TextureStep;
+
+        /// <summary>
+        /// Wall light level, 256 is full brightness
+        /// </summary>
+        int Brightness;
+    };
+
+    /// <summary>
+    /// What a single column's ray hit, everything needed to draw the column's wall
+    /// </summary>
+    struct ColumnHit
+    {
+        /// <summary>
+        /// Distance along the ray (not the view direction) to the wall, or to the end of the view range
+        /// </summary>
+        float RayDistance;
+
+        /// <summary>
+        /// Horizontal texture coordinate, already flipped for faces seen from behind
+        /// </summary>
+        float TextureU;
+
+        std::uint32_t TextureIndex;
+
+        GridRayHitSide Side;
+    };
+
+    /// <summary>
+    /// Where the columns of a DrawColumns call are written to
+    /// </summary>
+    struct ColumnRenderTarget
+    {
+        Colour* Pixels = nullptr;
+
+        /// <summary>
+        /// Distance between 2 rows of Pixels, in pixels
+        /// </summary>
+        std::size_t Pitch = 0;
+
+        int Width = 0;
+        int Height = 0;
+
+        /// <summary>
+        /// If set, columns are first drawn into this column-major buffer (one row per column) and then transposed into Pixels
+        /// </summary>
+        ImageBuffer* ColumnBuffer = nullptr;
+
+        /// <summary>
+        /// If set, the first floor row of every column is written here and the flat floor and ceiling fills are skipped,
+        /// the textured floor and ceiling pass draws them instead
+        /// </summary>
+        int* WallBottoms = nullptr;
+
+        /// <summary>
+        /// If set, the perpendicular distance to the wall of every column is written here, billboards behind it are not drawn
+        /// </summary>
+        float* WallDepths = nullptr;
+
+        /// <summary>
+        /// If set, every column's hit is written here, so the next frame can reproject them
+        /// </summary>
+        ColumnHit* Hits = nullptr;
+
+        /// <summary>
+        /// If set, the columns of ReprojectedParity (0 for even, 1 for odd) are not cast,
+        /// they are reprojected from these hits of the previous frame, which was drawn from the same position looking at PreviousLookAtAngle
+        /// </summary>
+        const ColumnHit* PreviousHits = nullptr;
+
+        float PreviousLookAtAngle = 0.0f;
+
+        int ReprojectedParity = 0;
+
+        /// <summary>
+        /// True if every column of PreviousHits was cast, false if only the ones of ReprojectedParity were
+        /// </summary>
+        bool PreviousFullyCast = false;
+    };
+
+    /// <summary>
+    /// A world object drawn as a camera facing sprite
+    /// </summary>
+    struct Billboard
+    {
+        /// <summary>
+        /// Position of the object's center on the map
+        /// </summary>
+        float X;
+        float Y;
+
+        std::size_t SpriteIndex;
+    };
+
+    /// <summary>
+    /// A billboard that survived culling, ready to be drawn
+    /// </summary>
+    struct VisibleBillboard
+    {
+        const BillboardSprite* Source;
+
+        /// <summary>
+        /// Distance along the view direction, compared against the wall depths
+        /// </summary>
+        float Depth;
+
+        /// <summary>
+        /// Projected screen rectangle, can reach outside the screen
+        /// </summary>
+        float Left;
+        float Top;
+        float Width;
+        float Height;
+
+        int Brightness;
+    };
+
+    /// <summary>
+    /// Per column ray constants, they only depend on the screen width and the FOV
+    /// </summary>
+    struct ColumnRayTable
+    {
+        /// <summary>
+        /// The screen width and FOV the table was built for
+        /// </summary>
+        int Width = 0;
+        float FOV = 0.0f;
+
+        /// <summary>
+        /// Where every column's ray crosses the camera plane, in units of the view direction's length.
+        /// A column's ray direction is the view direction plus the plane's (unit) right vector times this offset
+        /// </summary>
+        std::vector<float> PlaneOffsets;
+
+        /// <summary>
+        /// 1 / the length of every column's ray direction,
+        /// scales a distance along the view direction to a distance along the ray
+        /// </summary>
+        std::vector<float> InverseRayLengths;
+
+        /// <summary>
+        /// Half the camera plane's width, the plane is 1 unit in front of the camera
+        /// </summary>
+        float PlaneScale = 0.0f;
+    };
+
+    ColumnRayTable _columnRays;
+
+    /// <summary>
+    /// If true only half of the columns are cast every frame, alternating between even and odd columns,
+    /// the other half is reprojected from the previous frame
+    /// </summary>
+    bool _interlacedRendering = false;
+
+    /// <summary>
+    /// The parity of the columns that are cast in the next interlaced frame
+    /// </summary>
+    int _interlaceParity = 0;
+
+    /// <summary>
+    /// The column hits of the last 2 frames, _columnHits[_currentColumnHits] is written by the current frame
+    /// </summary>
+    std::vector<ColumnHit> _columnHits[2];
+    std::size_t _currentColumnHits = 0;
+
+    /// <summary>
+    /// The camera and map the previous frame's column hits were cast with
+    /// </summary>
+    struct PreviousFrameState
+    {
+        bool Valid = false;
+        bool FullyCast = true;
+
+        float PlayerX = 0.0f;
+        float PlayerY = 0.0f;
+        float LookAtAngle = 0.0f;
+        float FOV = 0.0f;
+
+        int Width = 0;
+
+        std::uint64_t MapVersion = 0;
+    };
+
+    PreviousFrameState _previousFrame;
+
+    /// <summary>
+    /// Reprojection only corrects for rotation, any movement falls back to casting every column
+    /// </summary>
+    static constexpr float TEMPORAL_MAX_MOVEMENT = 0.0001f;
+
+    /// <summary>
+    /// Rotating more than this (in radians) in a single frame falls back to casting every column
+    /// </summary>
+    static constexpr float TEMPORAL_MAX_ROTATION = 0.1f;
+
+    /// <summary>
+    /// Number of columns a worker thread draws at a time.
+    /// A multiple of 16 pixels, so 2 threads never write to the same cache line of a row
+    /// </summary>
+    static constexpr int COLUMNS_PER_CHUNK = 32;
+
+    /// <summary>
+    /// Number of floor rows (and their mirrored ceiling rows) a worker thread draws at a time
+    /// </summary>
+    static constexpr int FLOOR_ROWS_PER_CHUNK = 8;
+
+    /// <summary>
+    /// If true the columns are split between the graphics worker threads, otherwise they're all drawn on the calling thread
+    /// </summary>
+    bool _parallelRendering = true;
+
+    /// <summary>
+    /// If true the columns are drawn into _columnBuffer and transposed into the frame, otherwise they are written to the frame directly
+    /// </summary>
+    bool _columnMajorOutput = true;
+
+    /// <summary>
+    /// Column-major scratch frame, row 'x' holds screen column 'x'
+    /// </summary>
+    ImageBuffer _columnBuffer;
+
+    /// <summary>
+    /// Text output of the last column output benchmark
+    /// </summary>
+    std::string _benchmarkResults;
+
+    /// <summary>
+    /// The textures the walls are drawn with
+    /// </summary>
+    std::vector<WallTexture> _wallTextures;
+
+    /// <summary>
+    /// Floor and ceiling textures, tiled once per map cell
+    /// </summary>
+    std::vector<WallTexture> _floorTextures;
+
+    std::vector<BillboardSprite> _billboardSprites;
+
+    std::vector<Billboard> _billboards;
+
+    /// <summary>
+    /// Billboards closer than this are behind the camera or inside it
+    /// </summary>
+    static constexpr float BILLBOARD_NEAR_DISTANCE = 0.1f;
 
     // std::string s = "averylarg\nelongasfuckkstringasasdfasdashf\nha\nsash";
     std::string s;
@@ -60,6 +359,8 @@ public:
 
         _fontSheet(graphics, 13, 24),
 
+        _sdfFontSheet(graphics),
+
         _button(L"Text",
                 50, 25,
                 5, 105)
@@ -111,21 +412,36 @@ public:
 
         _fontSheet.LoadFromFile(L"Resources\\Consolas13x24.bmp");
 
+        _columnBuffer = ImageBuffer(_window.GetWindowHeight(), _window.GetWindowWidth());
+
+        // Wall textures are cut out of the tile atlas, a grey and a sand coloured stone wall
+        Sprite tileAtlas(_graphics);
+        tileAtlas.LoadFromFile(L"Resources\\dg_iso32.bmp");
+
+        _wallTextures.emplace_back(tileAtlas, 13, 318, 16, 16);
+        _wallTextures.emplace_back(tileAtlas, 457, 510, 12, 17);
+
+        // A dirt floor and a grey stone ceiling
+        _floorTextures.emplace_back(tileAtlas, 560, 120, 16, 16);
+        _floorTextures.emplace_back(tileAtlas, 504, 120, 16, 16);
+
+        // Trees for billboards, the atlas background is black
+        _billboardSprites.emplace_back(tileAtlas, 285, 158, 30, 32, Colours::Black);
+        _billboardSprites.emplace_back(tileAtlas, 390, 157, 30, 32, Colours::Black);
+
+        _sdfFontSheet.LoadFromBitmap(L"Resources\\Consolas13x24.bmp", 13, 24);
+
         _window.AddRawMouseMovedHandler(_rawMouseMovedHandler);
 
-        _map = new bool[_mapWidth * _mapHeight]
-        {
-            1,1,1,1,1,1,1,1,1,1,
-            1,0,0,0,0,0,0,0,0,1,
-            1,0,1,1,0,0,0,0,0,1,
-            1,0,1,1,0,0,0,0,0,1,
-            1,0,0,0,0,0,0,0,0,1,
-            1,0,0,0,0,0,0,0,0,1,
-            1,0,0,1,0,0,0,0,0,1,
-            1,0,0,1,1,0,0,0,0,1,
-            1,0,0,0,0,0,0,0,0,1,
-            1,1,1,1,1,1,1,1,1,1,
-        };
+        // A binary map is memory-mapped if there is one, so very large worlds don't have to be read up front
+        const std::wstring binaryMapFile = L"Resources\\RayCasterMap.tmap";
+
+        if (GetFileAttributesW(binaryMapFile.c_str()) != INVALID_FILE_ATTRIBUTES)
+            _map.MapFile(binaryMapFile);
+        else
+            _map.LoadFromTextFile(L"Resources\\RayCasterMap.txt");
+
+        PlaceBillboards();
 
         _button.BindClickEvent([this]()
         {
@@ -148,15 +464,6 @@ public:
         //  staticBitmap = f.GenerateString(s);
     };
 
-    ~RayCasterScene()
-    {
-        delete[] staticBitmap.PixelBuffer;
-        staticBitmap.PixelBuffer = nullptr;
-
-        delete[] _map;
-        _map = nullptr;
-    };
-
 public:
 
     bool cursorConfined = false;
@@ -194,6 +501,22 @@ public:
 
 
 
+        // Switch between parallel and serial column rendering, for comparison
+        if (_window.GetKeyboard().GetKeyState('P') == KeyState::Pressed)
+            _parallelRendering = !_parallelRendering;
+
+        // Switch between column-major + transpose and direct output
+        if (_window.GetKeyboard().GetKeyState('T') == KeyState::Pressed)
+            _columnMajorOutput = !_columnMajorOutput;
+
+        if (_window.GetKeyboard().GetKeyState('B') == KeyState::Pressed)
+            RunColumnOutputBenchmark();
+
+        // Switch between casting every column and interlaced reprojection
+        if (_window.GetKeyboard().GetKeyState('I') == KeyState::Pressed)
+            _interlacedRendering = !_interlacedRendering;
+
+
         if (_window.GetKeyboard().GetKeyState(VK_LEFT) == KeyState::Held)
         {
             _playerLookAtAngle -= 1.5f * deltaTime;
@@ -230,98 +553,916 @@ public:
 
     virtual void DrawScene() override
     {
-    
-        for (int x = 0; x < _window.GetWindowWidth(); x++)
+        ColumnRenderTarget target;
+        target.Pixels = _graphics.GetPixels();
+        target.Pitch = _graphics.GetPitch();
+        target.Width = _window.GetWindowWidth();
+        target.Height = _window.GetWindowHeight();
+        target.ColumnBuffer = _columnMajorOutput ? &_columnBuffer : nullptr;
+        target.WallBottoms = _graphics.GetFrameArena().GetArena().AllocateArray<int>(static_cast<std::size_t>(target.Width));
+        target.WallDepths = _graphics.GetFrameArena().GetArena().AllocateArray<float>(static_cast<std::size_t>(target.Width));
+
+        std::vector<ColumnHit>& columnHits = _columnHits[_currentColumnHits];
+        const std::vector<ColumnHit>& previousColumnHits = _columnHits[1 - _currentColumnHits];
+
+        columnHits.resize(static_cast<std::size_t>(target.Width));
+        target.Hits = columnHits.data();
+
+        const bool reprojected = (_interlacedRendering == true) && (CanReprojectPreviousFrame(target.Width) == true);
+
+        if (reprojected == true)
         {
-            const float rayAngle = (_playerLookAtAngle - _playerFOV / 2.0f) + (static_cast<float>(x) / static_cast<float>(_window.GetWindowWidth())) * _playerFOV;
+            target.PreviousHits = previousColumnHits.data();
+            target.PreviousLookAtAngle = _previousFrame.LookAtAngle;
+            target.PreviousFullyCast = _previousFrame.FullyCast;
+            target.ReprojectedParity = 1 - _interlaceParity;
+        };
+
+        RenderColumns(target, _graphics.GetFrameArena());
+
+        // Remember what this frame's hits were cast with
+        _previousFrame.Valid = true;
+        _previousFrame.FullyCast = (reprojected == false);
+        _previousFrame.PlayerX = _playerX;
+        _previousFrame.PlayerY = _playerY;
+        _previousFrame.LookAtAngle = _playerLookAtAngle;
+        _previousFrame.FOV = _playerFOV;
+        _previousFrame.Width = target.Width;
+        _previousFrame.MapVersion = _map.GetVersion();
+
+        _interlaceParity = 1 - _interlaceParity;
+        _currentColumnHits = 1 - _currentColumnHits;
+
+        // The walls are done, fill what's left above and below them
+        RenderFloorAndCeiling(target);
+
+        RenderBillboards(target, _graphics.GetFrameArena().GetArena());
+
+        // Draw a little minimap showing where the player is located at
+        DrawMiniMap();
 
+        _button.Draw(_graphics);
+
+        _sdfFontSheet.DrawString(_button.GetX() + 5, _button.GetY() + 6, "Button", 0.5f, Colours::Black);
+
+        _sdfFontSheet.DrawString(static_cast<float>(_button.GetX()), static_cast<float>(_button.GetY() + 30),
+                                 _parallelRendering ? "Parallel (P)" : "Serial (P)",
+                                 0.5f, Colours::Black);
 
-            float distanceToWall = 0.0f;
+        _sdfFontSheet.DrawString(static_cast<float>(_button.GetX()), static_cast<float>(_button.GetY() + 42),
+                                 _columnMajorOutput ? "Column-major (T)" : "Direct (T)",
+                                 0.5f, Colours::Black);
 
-            const float steps = 0.01f;
+        _sdfFontSheet.DrawString(static_cast<float>(_button.GetX()), static_cast<float>(_button.GetY() + 54),
+                                 _interlacedRendering ? "Interlaced (I)" : "Full (I)",
+                                 0.5f, Colours::Black);
 
-            bool hitWall = false;
+        // Results of the last column output benchmark
+        _sdfFontSheet.DrawString(static_cast<float>(_button.GetX()), static_cast<float>(_button.GetY() + 72),
+                                 _benchmarkResults,
+                                 0.5f, Colours::Black);
+    };
 
 
-            const float playerEyeX = std::cosf(rayAngle);
-            const float playerEyeY = std::sinf(rayAngle);
+    /// <summary>
+    /// Draw every column of a target, either on the worker pool or on the calling thread
+    /// </summary>
+    /// <param name="target"></param>
+    /// <param name="arena"> Provides the scratch memory, a sub-arena per worker thread </param>
+    void RenderColumns(const ColumnRenderTarget& target, FrameArena& arena)
+    {
+        UpdateColumnRayTable(target.Width);
 
-            // Find distance to wall
-            while ((hitWall == false) &&
-                   distanceToWall < _maxDepth)
+        if (_parallelRendering == true)
+        {
+            // Columns are independent, every thread draws whole chunks of them with it's own scratch arena
+            _graphics.GetWorkerPool().ParallelFor(0, target.Width, COLUMNS_PER_CHUNK, [this, &target, &arena](int beginColumn, int endColumn, std::size_t threadIndex)
             {
-                distanceToWall += steps;
+                DrawColumns(beginColumn, endColumn, target, arena.GetThreadArena(threadIndex));
+            });
+        }
+        else
+            DrawColumns(0, target.Width, target, arena.GetArena());
+    };
 
 
-                int testX = static_cast<int>(_playerX + playerEyeX * distanceToWall);
-                int testY = static_cast<int>(_playerY + playerEyeY * distanceToWall);
+    /// <summary>
+    /// Rebuild the column ray table if the width or FOV changed since it was built
+    /// </summary>
+    /// <param name="screenWidth"></param>
+    void UpdateColumnRayTable(int screenWidth)
+    {
+        if ((_columnRays.Width == screenWidth) && (_columnRays.FOV == _playerFOV))
+            return;
 
-                // Test if ray is out of bounds
-                if (testX < 0 || testX >= _mapWidth ||
-                    testY < 0 || testY >= _mapHeight)
-                {
-                    hitWall = true;
-                    distanceToWall = _maxDepth;
-                }
-                else
+        _columnRays.Width = screenWidth;
+        _columnRays.FOV = _playerFOV;
+
+        _columnRays.PlaneOffsets.resize(static_cast<std::size_t>(screenWidth));
+        _columnRays.InverseRayLengths.resize(static_cast<std::size_t>(screenWidth));
+
+        const float planeScale = std::tanf(_playerFOV / 2.0f);
+
+        _columnRays.PlaneScale = planeScale;
+
+        for (int x = 0; x < screenWidth; x++)
+        {
+            // Through the column's center, in the range (-1, 1)
+            const float cameraX = ((x + 0.5f) * 2.0f) / screenWidth - 1.0f;
+            const float planeOffset = cameraX * planeScale;
+
+            _columnRays.PlaneOffsets[x] = planeOffset;
+            _columnRays.InverseRayLengths[x] = 1.0f / std::sqrt(1.0f + planeOffset * planeOffset);
+        };
+    };
+
+
+    /// <summary>
+    /// Cast a single column's ray through the map
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="directionX"> The view direction </param>
+    /// <param name="directionY"></param>
+    /// <returns></returns>
+    ColumnHit CastColumn(int x, float directionX, float directionY) const
+    {
+        const float planeOffset = _columnRays.PlaneOffsets[x];
+
+        // The camera plane's right vector is the view direction rotated by 90 degrees
+        const float playerEyeX = directionX - directionY * planeOffset;
+        const float playerEyeY = directionY + directionX * planeOffset;
+
+        // Find distance to wall, walking the map one crossed cell at a time.
+        // The ray direction is 1 unit long along the view direction, so the distance is scaled to a distance along the ray below
+        const GridRayHit gridHit = Maths::CastGridRay(_playerX, _playerY,
+                                                      playerEyeX, playerEyeY,
+                                                      _maxDepth * _columnRays.InverseRayLengths[x],
+                                                      _map.GetWidth(), _map.GetHeight(),
+                                                      [this](int cellX, int cellY)
+        {
+            return _map.IsSolid(cellX, cellY);
+        });
+
+        ColumnHit hit;
+        hit.RayDistance = gridHit.Distance / _columnRays.InverseRayLengths[x];
+        hit.Side = gridHit.Side;
+
+        // Texture the wall, the hit position along the wall face is the texture column
+        hit.TextureIndex = static_cast<std::uint32_t>(static_cast<std::size_t>(gridHit.CellX + gridHit.CellY) % _wallTextures.size());
+
+        // Flip faces that are seen "from behind" so textures aren't mirrored
+        hit.TextureU = gridHit.WallOffset;
+
+        if (((gridHit.Side == GridRayHitSide::X) && (playerEyeX < 0.0f)) ||
+            ((gridHit.Side == GridRayHitSide::Y) && (playerEyeY > 0.0f)))
+            hit.TextureU = 1.0f - hit.TextureU;
+
+        return hit;
+    };
+
+
+    /// <summary>
+    /// Rebuild a column's hit from the previous frame, which was drawn from the same position with a slightly different view direction.
+    /// The column's ray is projected onto the previous camera plane, and the closest column that was cast in the previous frame is reused
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="target"></param>
+    /// <param name="directionX"> The current view direction </param>
+    /// <param name="directionY"></param>
+    /// <param name="previousDirectionX"> The previous frame's view direction </param>
+    /// <param name="previousDirectionY"></param>
+    /// <param name="hit"></param>
+    /// <returns> False if the ray wasn't visible in the previous frame and the column has to be cast </returns>
+    bool ReprojectColumn(int x, const ColumnRenderTarget& target,
+                         float directionX, float directionY,
+                         float previousDirectionX, float previousDirectionY,
+                         ColumnHit& hit) const
+    {
+        const float planeOffset = _columnRays.PlaneOffsets[x];
+
+        const float rayX = directionX - directionY * planeOffset;
+        const float rayY = directionY + directionX * planeOffset;
+
+        // The ray in the previous camera's space
+        const float previousDepth = rayX * previousDirectionX + rayY * previousDirectionY;
+        const float previousSide = rayY * previousDirectionX - rayX * previousDirectionY;
+
+        if (previousDepth <= 0.0f)
+            return false;
+
+        // Inverse of the column ray table, plane offset back to a column position
+        const float previousColumn = ((previousSide / previousDepth) / _columnRays.PlaneScale + 1.0f) * (target.Width / 2.0f) - 0.5f;
+
+        int sourceColumn;
+
+        // Only reuse columns that were actually cast, not ones that were reprojected themselves
+        if (target.PreviousFullyCast == true)
+            sourceColumn = static_cast<int>(std::floor(previousColumn + 0.5f));
+        else
+            sourceColumn = static_cast<int>(std::floor((previousColumn - target.ReprojectedParity) / 2.0f + 0.5f)) * 2 + target.ReprojectedParity;
+
+        if ((sourceColumn < 0) || (sourceColumn >= target.Width))
+            return false;
+
+        hit = target.PreviousHits[sourceColumn];
+
+        return true;
+    };
+
+
+    /// <summary>
+    /// Check if the previous frame's column hits can be reprojected into the current frame
+    /// </summary>
+    /// <param name="screenWidth"></param>
+    /// <returns></returns>
+    bool CanReprojectPreviousFrame(int screenWidth) const
+    {
+        if ((_previousFrame.Valid == false) ||
+            (_previousFrame.Width != screenWidth) ||
+            (_previousFrame.FOV != _playerFOV) ||
+            (_previousFrame.MapVersion != _map.GetVersion()))
+            return false;
+
+        // Fast camera movement, reprojection would be visibly wrong
+        if ((std::fabs(_playerX - _previousFrame.PlayerX) > TEMPORAL_MAX_MOVEMENT) ||
+            (std::fabs(_playerY - _previousFrame.PlayerY) > TEMPORAL_MAX_MOVEMENT) ||
+            (std::fabs(_playerLookAtAngle - _previousFrame.LookAtAngle) > TEMPORAL_MAX_ROTATION))
+            return false;
+
+        return true;
+    };
+
+
+    /// <summary>
+    /// Cast and draw the target columns in the range [beginColumn, endColumn).
+    /// Only the pixels of these columns and the scratch arena are written to, so disjoint ranges can be drawn at the same time
+    /// </summary>
+    /// <param name="beginColumn"></param>
+    /// <param name="endColumn"></param>
+    /// <param name="target"></param>
+    /// <param name="scratch"> Memory for this call's temporary data </param>
+    void DrawColumns(int beginColumn, int endColumn, const ColumnRenderTarget& target, LinearArena& scratch)
+    {
+        // This can run on a worker thread, which must not throw
+        ColumnSpan* columns = scratch.TryAllocateArray<ColumnSpan>(static_cast<std::size_t>(endColumn - beginColumn));
+
+        // The view direction
+        const float directionX = std::cosf(_playerLookAtAngle);
+        const float directionY = std::sinf(_playerLookAtAngle);
+
+        // The previous frame's view direction, for reprojected columns
+        const bool reproject = (target.PreviousHits != nullptr);
+
+        const float previousDirectionX = reproject ? std::cosf(target.PreviousLookAtAngle) : 0.0f;
+        const float previousDirectionY = reproject ? std::sinf(target.PreviousLookAtAngle) : 0.0f;
+
+        // The scratch arena is full, draw every column on it's own as soon as it's cast. Much slower, but nothing is left undrawn
+        if (columns == nullptr)
+        {
+            for (int x = beginColumn; x < endColumn; x++)
+            {
+                ColumnSpan column = CastColumnSpan(x, target, directionX, directionY, previousDirectionX, previousDirectionY);
+
+                FillColumns(x, x + 1, &column, target);
+            };
+
+            return;
+        };
+
+        // Cast every column's ray first
+        for (int x = beginColumn; x < endColumn; x++)
+            columns[x - beginColumn] = CastColumnSpan(x, target, directionX, directionY, previousDirectionX, previousDirectionY);
+
+        FillColumns(beginColumn, endColumn, columns, target);
+    };
+
+
+    /// <summary>
+    /// Cast a column's ray, or reproject it from the previous frame, and find what to draw in it.
+    /// Also writes the column's hit, wall bottom and wall depth to the target if it has them
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="target"></param>
+    /// <param name="directionX"> The view direction </param>
+    /// <param name="directionY"></param>
+    /// <param name="previousDirectionX"> The previous frame's view direction, only used if the target has previous hits </param>
+    /// <param name="previousDirectionY"></param>
+    /// <returns></returns>
+    ColumnSpan CastColumnSpan(int x, const ColumnRenderTarget& target,
+                              float directionX, float directionY,
+                              float previousDirectionX, float previousDirectionY)
+    {
+        const int screenHeight = target.Height;
+        const bool reproject = (target.PreviousHits != nullptr);
+
+        ColumnHit hit;
+
+        // Half of the columns are taken from the previous frame if possible
+        if ((reproject == false) ||
+            ((x & 1) != target.ReprojectedParity) ||
+            (ReprojectColumn(x, target, directionX, directionY, previousDirectionX, previousDirectionY, hit) == false))
+            hit = CastColumn(x, directionX, directionY);
+
+        if (target.Hits != nullptr)
+            target.Hits[x] = hit;
+
+        // The distance to the camera plane, which is what the projection needs and has no fisheye distortion.
+        // Kept away from 0 so the projection below stays finite
+        const float distanceToWall = (std::max)(hit.RayDistance * _columnRays.InverseRayLengths[x], 0.001f);
+
+
+        // The wall's projected top and height, can reach beyond the screen
+        const float wallTop = (screenHeight / 2.0f) - screenHeight / distanceToWall;
+        const float wallHeight = screenHeight - (wallTop * 2.0f);
+
+        ColumnSpan column;
+
+        // Clamped so a wall right in front of the camera can't overflow the conversion
+        column.Ceiling = static_cast<int>(std::clamp(wallTop, 0.0f, screenHeight / 2.0f));
+        column.Floor = screenHeight - column.Ceiling;
+
+        if (target.WallBottoms != nullptr)
+            target.WallBottoms[x] = column.Floor;
+
+        if (target.WallDepths != nullptr)
+            target.WallDepths[x] = distanceToWall;
+
+
+        const WallTexture& texture = _wallTextures[hit.TextureIndex];
+
+        // Far, small walls sample a smaller mip level
+        const int mipLevel = WallTexture::SelectMipLevel(wallHeight);
+        const int mipLevelSize = WallTexture::GetMipLevelSize(mipLevel);
+
+        // The only division, every wall pixel then steps the texture coordinate by a constant
+        const float texelsPerPixel = mipLevelSize / wallHeight;
+
+        column.TextureColumn = texture.GetColumn(mipLevel, hit.TextureU);
+        column.TextureMask = static_cast<std::uint32_t>(mipLevelSize - 1);
+        column.TextureStep = static_cast<std::uint32_t>(texelsPerPixel * 65536.0f);
+        column.TextureCoordinate = static_cast<std::uint32_t>((column.Ceiling - wallTop) * texelsPerPixel * 65536.0f);
+
+        // Calculate wall shading based on distance
+        std::uint8_t shade = 0;
+        if (distanceToWall < _maxDepth)
+            shade = _maxDepth * distanceToWall;
+
+        // Darken walls facing north/south a little so corners are visible
+        if (hit.Side == GridRayHitSide::Y)
+            shade += 30;
+
+        column.Brightness = 256 - shade;
+
+        return column;
+    };
+
+
+    /// <summary>
+    /// Draw the target columns in the range [beginColumn, endColumn) from their spans
+    /// </summary>
+    /// <param name="beginColumn"></param>
+    /// <param name="endColumn"></param>
+    /// <param name="columns"> The spans of the columns, starting with beginColumn's. Their texture coordinates are stepped while drawing </param>
+    /// <param name="target"></param>
+    void FillColumns(int beginColumn, int endColumn, ColumnSpan* columns, const ColumnRenderTarget& target) const
+    {
+        const int screenHeight = target.Height;
+
+        const Colour ceilingColour = { 0, 255, 255 };
+        const Colour floorColour = Colours::Green;
+
+        // The textured floor pass will overwrite the floor and ceiling anyway
+        const bool flatFloor = (target.WallBottoms == nullptr);
+
+        if (target.ColumnBuffer != nullptr)
+        {
+            // Every column is a contiguous row of the column buffer, so each one is 3 straight fills
+            for (int x = beginColumn; x < endColumn; x++)
+            {
+                const ColumnSpan& column = columns[x - beginColumn];
+
+                Colour* columnPixels = target.ColumnBuffer->GetRow(x);
+
+                if (flatFloor == true)
+                    std::fill(columnPixels, columnPixels + column.Ceiling, ceilingColour);
+
+                std::uint32_t textureCoordinate = column.TextureCoordinate;
+
+                for (int y = column.Ceiling; y < column.Floor; y++)
                 {
-                    if (_map[testX + _mapWidth * testY] == true)
-                    {
-                        hitWall = true;
-                    };
+                    columnPixels[y] = ShadeTexel(column.TextureColumn[(textureCoordinate >> 16) & column.TextureMask], column.Brightness);
+                    textureCoordinate += column.TextureStep;
                 };
-            };
 
+                if (flatFloor == true)
+                    std::fill(columnPixels + column.Floor, columnPixels + screenHeight, floorColour);
+            };
 
-            // No idea why or how but this fixes the "fisheye" effect
-            const float projectedAngle = (_playerLookAtAngle - rayAngle) * (_playerFOV / 2.0f);
-            distanceToWall *= std::cosf(projectedAngle);
+            // Then written to the frame in cache sized blocks
+            ImageTranspose::Transpose(*target.ColumnBuffer, beginColumn, endColumn, target.Pixels, target.Pitch);
 
+            return;
+        };
 
-            const int ceiling = static_cast<float>(_window.GetWindowHeight() / 2.0) - _window.GetWindowHeight() / distanceToWall;
-            const int floor = _window.GetWindowHeight() - ceiling;
 
-            // Calculate wall shading based on distance
-            std::uint8_t shade = 0;
-            if (distanceToWall < _maxDepth)
-                shade = _maxDepth * distanceToWall;
+        // Fill the columns a row at a time, so every write to a row stays on the same few cache lines
+        for (int y = 0; y < screenHeight; y++)
+        {
+            Colour* row = target.Pixels + static_cast<std::size_t>(y) * target.Pitch;
 
-            // Draw the frame column-by-column
-            for (int y = 0; y < _window.GetWindowHeight(); y++)
+            for (int x = beginColumn; x < endColumn; x++)
             {
+                ColumnSpan& column = columns[x - beginColumn];
+
                 // Draw ceiling
-                if (y < ceiling)
+                if (y < column.Ceiling)
                 {
-                    _graphics.DrawPixel(x, y, { 0, 255, 255 });
+                    if (flatFloor == true)
+                        row[x] = ceilingColour;
                 }
                 // Draw walls
-                else if (y > ceiling && y < floor)
+                else if (y < column.Floor)
                 {
-                    Colour colour = Colours::White;
-
-                    colour.Red -= shade;
-                    colour.Green -= shade;
-                    colour.Blue -= shade;
-
-                    _graphics.DrawPixel(x, y, colour);
+                    row[x] = ShadeTexel(column.TextureColumn[(column.TextureCoordinate >> 16) & column.TextureMask], column.Brightness);
+                    column.TextureCoordinate += column.TextureStep;
                 }
                 // Draw floor
-                else
+                else if (flatFloor == true)
+                    row[x] = floorColour;
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Draw the textured floor and ceiling of a target whose walls were already drawn with WallBottoms set
+    /// </summary>
+    /// <param name="target"></param>
+    void RenderFloorAndCeiling(const ColumnRenderTarget& target)
+    {
+        const int horizon = target.Height / 2;
+
+        if (_parallelRendering == true)
+        {
+            // Every floor row writes itself and it's mirrored ceiling row, so row ranges never overlap
+            _graphics.GetWorkerPool().ParallelFor(horizon, target.Height, FLOOR_ROWS_PER_CHUNK, [this, &target](int beginRow, int endRow, std::size_t threadIndex)
+            {
+                DrawFloorAndCeilingRows(beginRow, endRow, target);
+            });
+        }
+        else
+            DrawFloorAndCeilingRows(horizon, target.Height, target);
+    };
+
+
+    /// <summary>
+    /// Draw the floor rows [beginRow, endRow) and the ceiling rows mirrored across the horizon.
+    /// Every pixel of a floor row is at the same distance, so the world position is stepped linearly across the row
+    /// in 16.16 fixed point, 8 pixels at a time.
+    /// Walls are symmetric around the horizon, a ceiling row is visible in exactly the columns where it's mirrored floor row is
+    /// </summary>
+    /// <param name="beginRow"></param>
+    /// <param name="endRow"></param>
+    /// <param name="target"></param>
+    void DrawFloorAndCeilingRows(int beginRow, int endRow, const ColumnRenderTarget& target)
+    {
+        const int screenWidth = target.Width;
+        const int screenHeight = target.Height;
+
+        // The same integer horizon RenderFloorAndCeiling starts the rows at
+        const int horizon = screenHeight / 2;
+
+        // The rays through the left and right edges of the screen
+        const float directionX = std::cosf(_playerLookAtAngle);
+        const float directionY = std::sinf(_playerLookAtAngle);
+
+        const float planeScale = std::tanf(_playerFOV / 2.0f);
+        const float planeX = -directionY * planeScale;
+        const float planeY = directionX * planeScale;
+
+        const float leftRayX = directionX - planeX;
+        const float leftRayY = directionY - planeY;
+
+        const WallTexture& floorTexture = _floorTextures[0];
+        const WallTexture& ceilingTexture = _floorTextures[1];
+
+        const __m128i zero = _mm_setzero_si128();
+
+        for (int y = beginRow; y < endRow; y++)
+        {
+            Colour* floorRow = target.Pixels + static_cast<std::size_t>(y) * target.Pitch;
+            Colour* ceilingRow = target.Pixels + static_cast<std::size_t>(screenHeight - 1 - y) * target.Pitch;
+
+            // A wall 'd' units away ends (screenHeight / d) pixels below the horizon, so does the floor.
+            // Measured from the integer horizon, the first row's centre is half a pixel below it even if the height is odd
+            const float rowDistance = screenHeight / ((y - horizon) + 0.5f);
+
+            // World distance between 2 neighbouring pixels of this row
+            const float worldStepX = rowDistance * (planeX * 2.0f) / screenWidth;
+            const float worldStepY = rowDistance * (planeY * 2.0f) / screenWidth;
+
+            // Sampled at the pixel's centre
+            const float worldX = _playerX + rowDistance * leftRayX + worldStepX * 0.5f;
+            const float worldY = _playerY + rowDistance * leftRayY + worldStepY * 0.5f;
+
+            // Far rows cover many texels per pixel and sample a smaller mip level
+            const float texelsPerPixel = (std::max)(std::fabs(worldStepX), std::fabs(worldStepY)) * WallTexture::SIZE;
+            const int mipLevel = WallTexture::SelectMipLevel(WallTexture::SIZE / (std::max)(texelsPerPixel, 0.0001f));
+
+            const int levelShift = WallTexture::SIZE_SHIFT - mipLevel;
+            const float levelScale = static_cast<float>(1 << levelShift) * 65536.0f;
+
+            // Only the fraction matters, the textures repeat every cell.
+            // 2^32 is a whole number of textures too, so the coordinates are free to wrap
+            std::uint32_t u = static_cast<std::uint32_t>(static_cast<std::int64_t>((worldX - std::floor(worldX)) * levelScale));
+            std::uint32_t v = static_cast<std::uint32_t>(static_cast<std::int64_t>((worldY - std::floor(worldY)) * levelScale));
+
+            const std::uint32_t stepU = static_cast<std::uint32_t>(static_cast<std::int64_t>(worldStepX * levelScale));
+            const std::uint32_t stepV = static_cast<std::uint32_t>(static_cast<std::int64_t>(worldStepY * levelScale));
+
+            const std::uint32_t* floorTexels = reinterpret_cast<const std::uint32_t*>(floorTexture.GetMipLevel(mipLevel));
+            const std::uint32_t* ceilingTexels = reinterpret_cast<const std::uint32_t*>(ceilingTexture.GetMipLevel(mipLevel));
+
+            const std::uint32_t texelMask = (1u << levelShift) - 1;
+
+            // Same fall off as the walls
+            const int brightness = 256 - static_cast<int>(_maxDepth * (std::min)(rowDistance, _maxDepth));
+
+            int x = 0;
+
+            // 2 groups of 4 lanes, lane 'a' of each group is 'a' pixels ahead of the group's first pixel
+            __m128i u0 = _mm_setr_epi32(static_cast<int>(u), static_cast<int>(u + stepU), static_cast<int>(u + stepU * 2), static_cast<int>(u + stepU * 3));
+            __m128i v0 = _mm_setr_epi32(static_cast<int>(v), static_cast<int>(v + stepV), static_cast<int>(v + stepV * 2), static_cast<int>(v + stepV * 3));
+            __m128i u1 = _mm_add_epi32(u0, _mm_set1_epi32(static_cast<int>(stepU * 4)));
+            __m128i v1 = _mm_add_epi32(v0, _mm_set1_epi32(static_cast<int>(stepV * 4)));
+
+            const __m128i stepU8 = _mm_set1_epi32(static_cast<int>(stepU * 8));
+            const __m128i stepV8 = _mm_set1_epi32(static_cast<int>(stepV * 8));
+
+            const __m128i texelMask4 = _mm_set1_epi32(static_cast<int>(texelMask));
+            const __m128i levelShift4 = _mm_cvtsi32_si128(levelShift);
+
+            const __m128i row4 = _mm_set1_epi32(y);
+
+            // Alpha is multiplied by 256 and survives unchanged
+            const __m128i brightness8 = _mm_setr_epi16(static_cast<short>(brightness), static_cast<short>(brightness), static_cast<short>(brightness), 256,
+                                                       static_cast<short>(brightness), static_cast<short>(brightness), static_cast<short>(brightness), 256);
+
+            alignas(16) std::uint32_t texelIndices[8];
+
+            for (; x + 8 <= screenWidth; x += 8)
+            {
+                // Texel index = (u << levelShift) | v, the texture is column-major
+                const __m128i index0 = _mm_or_si128(_mm_sll_epi32(_mm_and_si128(_mm_srli_epi32(u0, 16), texelMask4), levelShift4),
+                                                    _mm_and_si128(_mm_srli_epi32(v0, 16), texelMask4));
+
+                const __m128i index1 = _mm_or_si128(_mm_sll_epi32(_mm_and_si128(_mm_srli_epi32(u1, 16), texelMask4), levelShift4),
+                                                    _mm_and_si128(_mm_srli_epi32(v1, 16), texelMask4));
+
+                _mm_store_si128(reinterpret_cast<__m128i*>(texelIndices), index0);
+                _mm_store_si128(reinterpret_cast<__m128i*>(texelIndices + 4), index1);
+
+                u0 = _mm_add_epi32(u0, stepU8);
+                v0 = _mm_add_epi32(v0, stepV8);
+                u1 = _mm_add_epi32(u1, stepU8);
+                v1 = _mm_add_epi32(v1, stepV8);
+
+                // Columns whose wall reaches below this row keep their wall pixels
+                const __m128i wallMask0 = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(target.WallBottoms + x)), row4);
+                const __m128i wallMask1 = _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(target.WallBottoms + x + 4)), row4);
+
+                // SSE2 has no gather, the 8 texels of each texture are fetched one by one
+                const __m128i floorTexels0 = _mm_setr_epi32(static_cast<int>(floorTexels[texelIndices[0]]), static_cast<int>(floorTexels[texelIndices[1]]),
+                                                            static_cast<int>(floorTexels[texelIndices[2]]), static_cast<int>(floorTexels[texelIndices[3]]));
+                const __m128i floorTexels1 = _mm_setr_epi32(static_cast<int>(floorTexels[texelIndices[4]]), static_cast<int>(floorTexels[texelIndices[5]]),
+                                                            static_cast<int>(floorTexels[texelIndices[6]]), static_cast<int>(floorTexels[texelIndices[7]]));
+
+                const __m128i ceilingTexels0 = _mm_setr_epi32(static_cast<int>(ceilingTexels[texelIndices[0]]), static_cast<int>(ceilingTexels[texelIndices[1]]),
+                                                              static_cast<int>(ceilingTexels[texelIndices[2]]), static_cast<int>(ceilingTexels[texelIndices[3]]));
+                const __m128i ceilingTexels1 = _mm_setr_epi32(static_cast<int>(ceilingTexels[texelIndices[4]]), static_cast<int>(ceilingTexels[texelIndices[5]]),
+                                                              static_cast<int>(ceilingTexels[texelIndices[6]]), static_cast<int>(ceilingTexels[texelIndices[7]]));
+
+                StoreShadedTexels(floorRow + x, ShadeTexels(floorTexels0, brightness8, zero), wallMask0);
+                StoreShadedTexels(floorRow + x + 4, ShadeTexels(floorTexels1, brightness8, zero), wallMask1);
+
+                StoreShadedTexels(ceilingRow + x, ShadeTexels(ceilingTexels0, brightness8, zero), wallMask0);
+                StoreShadedTexels(ceilingRow + x + 4, ShadeTexels(ceilingTexels1, brightness8, zero), wallMask1);
+            };
+
+            // The last few pixels of the row
+            u += stepU * static_cast<std::uint32_t>(x);
+            v += stepV * static_cast<std::uint32_t>(x);
+
+            for (; x < screenWidth; x++)
+            {
+                if (target.WallBottoms[x] <= y)
                 {
-                    _graphics.DrawPixel(x, y, Colours::Green);
+                    const std::size_t texelIndex = (static_cast<std::size_t>((u >> 16) & texelMask) << levelShift) | ((v >> 16) & texelMask);
+
+                    floorRow[x] = ShadeTexel(floorTexture.GetMipLevel(mipLevel)[texelIndex], brightness);
+                    ceilingRow[x] = ShadeTexel(ceilingTexture.GetMipLevel(mipLevel)[texelIndex], brightness);
                 };
 
+                u += stepU;
+                v += stepV;
             };
+        };
+    };
+
+
+    /// <summary>
+    /// Cull, sort and draw every billboard of a target whose walls were already drawn with WallDepths set
+    /// </summary>
+    /// <param name="target"></param>
+    /// <param name="arena"> Provides memory for the visible billboards list </param>
+    void RenderBillboards(const ColumnRenderTarget& target, LinearArena& arena)
+    {
+        if (_billboards.empty() == true)
+            return;
 
+        VisibleBillboard* visible = arena.AllocateArray<VisibleBillboard>(_billboards.size());
+        std::size_t visibleCount = 0;
+
+        const float directionX = std::cosf(_playerLookAtAngle);
+        const float directionY = std::sinf(_playerLookAtAngle);
+
+        const float halfFOVTangent = std::tanf(_playerFOV / 2.0f);
+
+        const float screenWidth = static_cast<float>(target.Width);
+        const float screenHeight = static_cast<float>(target.Height);
+
+        for (const Billboard& billboard : _billboards)
+        {
+            const float relativeX = billboard.X - _playerX;
+            const float relativeY = billboard.Y - _playerY;
+
+            // Camera space, depth along the view direction and offset to the right of it
+            const float depth = relativeX * directionX + relativeY * directionY;
+            const float side = relativeY * directionX - relativeX * directionY;
+
+            // Behind the camera or too far to be seen
+            if ((depth < BILLBOARD_NEAR_DISTANCE) || (depth > _maxDepth))
+                continue;
+
+            // Outside the view frustum, with a margin of half a cell for the sprite's width
+            if (std::fabs(side) - 0.5f > depth * halfFOVTangent)
+                continue;
+
+            const BillboardSprite& sprite = _billboardSprites[billboard.SpriteIndex];
+
+            // As tall as a wall at the same distance, keeping the sprite's aspect ratio
+            const float height = (screenHeight * 2.0f) / depth;
+            const float width = height * sprite.GetWidth() / sprite.GetHeight();
+
+            // Project onto the camera plane, like the wall rays
+            const float centerX = (1.0f + side / (depth * halfFOVTangent)) * (screenWidth / 2.0f);
+
+            if ((centerX + width / 2.0f < 0.0f) || (centerX - width / 2.0f >= screenWidth))
+                continue;
+
+            VisibleBillboard& entry = visible[visibleCount++];
+            entry.Source = &sprite;
+            entry.Depth = depth;
+            entry.Left = centerX - width / 2.0f;
+            entry.Top = (screenHeight / 2.0f) - screenHeight / depth;
+            entry.Width = width;
+            entry.Height = height;
+            entry.Brightness = 256 - static_cast<int>(_maxDepth * (std::min)(depth, _maxDepth));
         };
 
-        // Draw a little minimap showing where the player is located at
-        DrawMiniMap();
+        // Far to near, so closer billboards are drawn over farther ones
+        std::sort(visible, visible + visibleCount, [](const VisibleBillboard& a, const VisibleBillboard& b)
+        {
+            return a.Depth > b.Depth;
+        });
 
-        _button.Draw(_graphics);
+        if (_parallelRendering == true)
+        {
+            _graphics.GetWorkerPool().ParallelFor(0, target.Width, COLUMNS_PER_CHUNK, [this, &target, visible, visibleCount](int beginColumn, int endColumn, std::size_t threadIndex)
+            {
+                DrawBillboardColumns(beginColumn, endColumn, target, visible, visibleCount);
+            });
+        }
+        else
+            DrawBillboardColumns(0, target.Width, target, visible, visibleCount);
+    };
+
+
+    /// <summary>
+    /// Draw the parts of sorted billboards that fall in the columns [beginColumn, endColumn)
+    /// </summary>
+    /// <param name="beginColumn"></param>
+    /// <param name="endColumn"></param>
+    /// <param name="target"></param>
+    /// <param name="billboards"> Visible billboards, sorted far to near </param>
+    /// <param name="billboardCount"></param>
+    void DrawBillboardColumns(int beginColumn, int endColumn, const ColumnRenderTarget& target,
+                              const VisibleBillboard* billboards, std::size_t billboardCount)
+    {
+        for (std::size_t a = 0; a < billboardCount; a++)
+        {
+            const VisibleBillboard& billboard = billboards[a];
+            const BillboardSprite& sprite = *billboard.Source;
+
+            const int firstColumn = (std::max)(static_cast<int>(std::ceil(billboard.Left - 0.5f)), beginColumn);
+            const int lastColumn = (std::min)(static_cast<int>(std::ceil(billboard.Left + billboard.Width - 0.5f)), endColumn);
 
-        _fontSheet.DrawString(_button.GetX() + 5, _button.GetY() + 8, "Button", 0.5, 0.5);
+            const float texelsPerPixelX = sprite.GetWidth() / billboard.Width;
+            const float pixelsPerTexelY = billboard.Height / sprite.GetHeight();
 
+            const std::uint32_t textureStep = static_cast<std::uint32_t>(65536.0f / pixelsPerTexelY);
+
+            for (int x = firstColumn; x < lastColumn; x++)
+            {
+                // Hidden behind this column's wall
+                if (billboard.Depth >= target.WallDepths[x])
+                    continue;
+
+                const int u = std::clamp(static_cast<int>((x + 0.5f - billboard.Left) * texelsPerPixelX), 0, sprite.GetWidth() - 1);
+
+                const Colour* texels = sprite.GetColumn(u);
+
+                // Only the opaque runs are visited
+                for (const BillboardSprite::Run* run = sprite.GetColumnRunsBegin(u); run != sprite.GetColumnRunsEnd(u); run++)
+                {
+                    const float runTop = billboard.Top + run->Start * pixelsPerTexelY;
+                    const float runBottom = runTop + run->Length * pixelsPerTexelY;
+
+                    const int firstRow = (std::max)(static_cast<int>(std::ceil(runTop - 0.5f)), 0);
+                    const int lastRow = (std::min)(static_cast<int>(std::ceil(runBottom - 0.5f)), target.Height);
+
+                    if (firstRow >= lastRow)
+                        continue;
+
+                    // 16.16 fixed point texel position of the first row, relative to the run
+                    std::uint32_t textureCoordinate = static_cast<std::uint32_t>((std::max)((firstRow + 0.5f - runTop) / pixelsPerTexelY, 0.0f) * 65536.0f);
+
+                    const int lastTexel = run->Length - 1;
+
+                    Colour* pixel = target.Pixels + static_cast<std::size_t>(firstRow) * target.Pitch + x;
+
+                    for (int y = firstRow; y < lastRow; y++)
+                    {
+                        const int texel = (std::min)(static_cast<int>(textureCoordinate >> 16), lastTexel);
+
+                        *pixel = ShadeTexel(texels[run->Start + texel], billboard.Brightness);
+
+                        textureCoordinate += textureStep;
+                        pixel += target.Pitch;
+                    };
+                };
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Scatter billboards over the empty cells of the map
+    /// </summary>
+    void PlaceBillboards()
+    {
+        _billboards.clear();
+
+        // Large maps only get billboards near the start
+        const int width = (std::min)(_map.GetWidth(), TileMap::CHUNK_SIZE);
+        const int height = (std::min)(_map.GetHeight(), TileMap::CHUNK_SIZE);
+
+        const int playerCellX = static_cast<int>(_playerX);
+        const int playerCellY = static_cast<int>(_playerY);
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                if ((_map.IsSolid(x, y) == true) ||
+                    ((x == playerCellX) && (y == playerCellY)))
+                    continue;
+
+                // A cheap hash, so the same map always gets the same objects
+                const std::uint32_t hash = (static_cast<std::uint32_t>(x) * 73856093u) ^ (static_cast<std::uint32_t>(y) * 19349663u);
+
+                if ((hash % 5) != 0)
+                    continue;
+
+                _billboards.push_back({ x + 0.5f, y + 0.5f, (hash / 5) % _billboardSprites.size() });
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Scale 4 texels' colour by a light level
+    /// </summary>
+    /// <param name="texels"></param>
+    /// <param name="brightness"> A 16 bit light level per channel, 256 is full brightness </param>
+    /// <param name="zero"></param>
+    /// <returns></returns>
+    static __m128i ShadeTexels(__m128i texels, __m128i brightness, __m128i zero)
+    {
+        // Widen to 16 bits, 255 * 256 still fits
+        const __m128i low = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(texels, zero), brightness), 8);
+        const __m128i high = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(texels, zero), brightness), 8);
+
+        return _mm_packus_epi16(low, high);
+    };
+
+
+    /// <summary>
+    /// Write 4 pixels, except the ones whose mask lane is set
+    /// </summary>
+    /// <param name="destination"></param>
+    /// <param name="pixels"></param>
+    /// <param name="keepMask"> All bits set for pixels that keep their current value </param>
+    static void StoreShadedTexels(Colour* destination, __m128i pixels, __m128i keepMask)
+    {
+        const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination),
+                         _mm_or_si128(_mm_andnot_si128(keepMask, pixels), _mm_and_si128(keepMask, current)));
+    };
+
+
+    /// <summary>
+    /// Scale a texel's colour by a light level
+    /// </summary>
+    /// <param name="texel"></param>
+    /// <param name="brightness"> 256 is full brightness </param>
+    /// <returns></returns>
+    static Colour ShadeTexel(const Colour& texel, int brightness)
+    {
+        Colour shaded;
+        shaded.Red = static_cast<std::uint8_t>((texel.Red * brightness) >> 8);
+        shaded.Green = static_cast<std::uint8_t>((texel.Green * brightness) >> 8);
+        shaded.Blue = static_cast<std::uint8_t>((texel.Blue * brightness) >> 8);
+        shaded.Alpha = texel.Alpha;
+
+        return shaded;
+    };
+
+
+    /// <summary>
+    /// Time the column output modes against each other at a few resolutions.
+    /// The results are written to the debugger output and shown on screen
+    /// </summary>
+    void RunColumnOutputBenchmark()
+    {
+        constexpr int resolutions[][2] =
+        {
+            { 320, 240 },
+            { 800, 600 },
+            { 1280, 720 },
+            { 1920, 1080 },
+        };
+
+        constexpr int iterations = 30;
+
+        // Separate arenas so the benchmark can reset them between iterations without touching the frame's allocations
+        FrameArena arena(256 * 1024, _graphics.GetWorkerPool().GetThreadCount(), 256 * 1024);
+
+        _benchmarkResults.clear();
+
+        for (const auto& resolution : resolutions)
+        {
+            ImageBuffer frame(resolution[0], resolution[1]);
+            ImageBuffer columnBuffer(resolution[1], resolution[0]);
+
+            ColumnRenderTarget target;
+            target.Pixels = frame.GetData();
+            target.Pitch = frame.GetPitch();
+            target.Width = frame.GetWidth();
+            target.Height = frame.GetHeight();
+
+            double times[2] = { 0 };
+
+            for (int mode = 0; mode < 2; mode++)
+            {
+                target.ColumnBuffer = (mode == 1) ? &columnBuffer : nullptr;
+
+                // Warm up
+                RenderColumns(target, arena);
+                arena.Reset();
+
+                const auto begin = std::chrono::steady_clock::now();
+
+                for (int a = 0; a < iterations; a++)
+                {
+                    RenderColumns(target, arena);
+                    arena.Reset();
+                };
+
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+                times[mode] = elapsed.count() / iterations;
+            };
+
+            char line[128];
+            std::snprintf(line, sizeof(line), "%dx%d: direct %.3f ms, column-major %.3f ms\n",
+                          resolution[0], resolution[1], times[0], times[1]);
+
+            OutputDebugStringA(line);
+
+            _benchmarkResults.append(line);
+        };
     };
 
 
@@ -336,39 +1477,56 @@ public:
 
         float lineLength = ((miniMapWidthScale + miniMapHeightScale) / 2);
 
+        // Only the cells around the player are shown, maps can be much larger than the screen
+        const int miniMapWidth = (std::min)(MINIMAP_CELLS, _map.GetWidth());
+        const int miniMapHeight = (std::min)(MINIMAP_CELLS, _map.GetHeight());
 
-        // Draw the _map
-        for (std::uint64_t x = 0; x < _mapWidth * miniMapWidthScale; x++)
-        {
-            for (std::uint64_t y = 0; y < _mapHeight * miniMapHeightScale; y++)
-            {
-                _graphics.DrawPixel(miniMapXOffset + x, miniMapYOffset + y);
-            };
-        };
+        const int firstCellX = std::clamp(static_cast<int>(_playerX) - miniMapWidth / 2, 0, _map.GetWidth() - miniMapWidth);
+        const int firstCellY = std::clamp(static_cast<int>(_playerY) - miniMapHeight / 2, 0, _map.GetHeight() - miniMapHeight);
 
+        // Player position relative to the minimap
+        const float playerX = _playerX - firstCellX;
+        const float playerY = _playerY - firstCellY;
 
-        // Draw _map blocks
-        for (std::uint64_t a = 0; a < _mapHeight * _mapWidth; a++)
+
+        _miniMapLayer.Resize(miniMapWidth * miniMapWidthScale, miniMapHeight * miniMapHeightScale);
+
+        // The walls only have to be redrawn when the minimap scrolls or the map changes
+        if ((firstCellX != _miniMapFirstCellX) ||
+            (firstCellY != _miniMapFirstCellY) ||
+            (_map.GetVersion() != _miniMapVersion))
         {
-            if (_map[a] == true)
-            {
-                // Find the block's X and Y
-                int mapBlockX = a % _mapWidth;
-                int mapBlockY = a / _mapWidth;
+            _miniMapFirstCellX = firstCellX;
+            _miniMapFirstCellY = firstCellY;
+            _miniMapVersion = _map.GetVersion();
 
+            _miniMapLayer.Invalidate();
+        };
+
+        _miniMapLayer.Update([&](ImageBuffer& layer)
+        {
+            // Draw the _map
+            layer.Fill({ 255, 255, 255, 1 });
 
-                for (std::uint64_t y = 0; y < miniMapHeightScale; y++)
+            // Draw _map blocks
+            for (int mapBlockY = 0; mapBlockY < miniMapHeight; mapBlockY++)
+            {
+                for (int mapBlockX = 0; mapBlockX < miniMapWidth; mapBlockX++)
                 {
-                    for (std::uint64_t x = 0; x < miniMapWidthScale; x++)
+                    if (_map.IsSolid(firstCellX + mapBlockX, firstCellY + mapBlockY) == false)
+                        continue;
+
+                    for (int y = 0; y < miniMapHeightScale; y++)
                     {
-                        _graphics.DrawPixel(x + (mapBlockX * miniMapWidthScale) + miniMapXOffset,
-                                            y + (mapBlockY * miniMapHeightScale) + miniMapYOffset,
-                                            Colours::Black, false);
+                        Colour* row = layer.GetRow(y + (mapBlockY * miniMapHeightScale)) + (mapBlockX * miniMapWidthScale);
 
+                        std::fill(row, row + miniMapWidthScale, Colours::Black);
                     };
                 };
             };
-        };
+        });
+
+        _miniMapLayer.Draw(_graphics, miniMapXOffset, miniMapYOffset);
 
 
         // Draw player
@@ -376,8 +1534,8 @@ public:
         {
             for (std::uint64_t y = 0; y < miniMapHeightScale; y++)
             {
-                _graphics.DrawPixel(miniMapXOffset + (_playerX * miniMapWidthScale) + x,
-                                    miniMapYOffset + (_playerY * miniMapHeightScale) + y,
+                _graphics.DrawPixel(miniMapXOffset + (playerX * miniMapWidthScale) + x,
+                                    miniMapYOffset + (playerY * miniMapHeightScale) + y,
                                     Colours::Red);
             };
         };
@@ -388,8 +1546,8 @@ public:
         float pointsToPlayerDistanceSpacing = 30.f;
 
         // Draw a line starting from the player's position to the view ray's angle
-        Vector2D p0(miniMapXOffset + ((_playerX * miniMapWidthScale) + miniMapWidthScale / 2),
-                    miniMapYOffset + ((_playerY * miniMapHeightScale) + miniMapWidthScale / 2));
+        Vector2D p0(miniMapXOffset + ((playerX * miniMapWidthScale) + miniMapWidthScale / 2),
+                    miniMapYOffset + ((playerY * miniMapHeightScale) + miniMapWidthScale / 2));
 
         Vector2D p1 = p0;
         p1.X += (std::cosf(_playerLookAtAngle + pointToPointDistanceSpacing) * pointsToPlayerDistanceSpacing);
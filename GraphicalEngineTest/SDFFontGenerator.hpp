@@ -0,0 +1,332 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include "Sprite.hpp"
+#include "Colour.hpp"
+
+
+/// <summary>
+/// A single channel signed distance field atlas.
+/// Every texel stores the distance to the nearest glyph edge,
+/// 128 sits exactly on the edge, higher values are inside the glyph
+/// </summary>
+struct SDFAtlas
+{
+    /// <summary>
+    /// The distance texels, one byte per texel
+    /// </summary>
+    std::vector<std::uint8_t> Distances;
+
+    int Width = 0;
+    int Height = 0;
+
+    /// <summary>
+    /// The width of a single character
+    /// </summary>
+    int GlyphWidth = 0;
+
+    /// <summary>
+    /// The height of a single character
+    /// </summary>
+    int GlyphHeight = 0;
+
+    /// <summary>
+    /// The distance (in atlas texels) that is mapped to the full byte range around the edge
+    /// </summary>
+    float Spread = 0.0f;
+};
+
+
+/// <summary>
+/// Converts FontSheet bitmaps into signed distance field atlases.
+/// This is an offline step, the result can be saved to a file and loaded by SDFFontSheet at runtime
+/// </summary>
+class SDFFontGenerator
+{
+
+private:
+
+    /// <summary>
+    /// File identifier written at the beggining of every .sdf file
+    /// </summary>
+    static constexpr char FILE_MAGIC[4] = { 'S', 'D', 'F', '1' };
+
+    /// <summary>
+    /// A large enough distance that will be used as "infinity"
+    /// </summary>
+    static constexpr int FAR_AWAY = 1 << 14;
+
+    /// <summary>
+    /// A single cell in the distance transform grid, stores the offset to the nearest seed
+    /// </summary>
+    struct GridOffset
+    {
+        int X;
+        int Y;
+
+        int LengthSquare() const
+        {
+            return (X * X) + (Y * Y);
+        };
+    };
+
+
+public:
+
+    /// <summary>
+    /// Generate a distance field atlas from a loaded font bitmap.
+    /// Each glyph cell is processed on it's own so distances never bleed into neighbouring characters
+    /// </summary>
+    /// <param name="fontSprite"> The loaded font bitmap </param>
+    /// <param name="glyphWidth"> The width of a single character </param>
+    /// <param name="glyphHeight"> The height of a single character </param>
+    /// <param name="spread"> How far (in texels) from the edge distances are still encoded </param>
+    /// <param name="darkGlyphs"> True if the glyphs are drawn dark on a bright background </param>
+    /// <returns></returns>
+    static SDFAtlas Generate(const Sprite& fontSprite,
+                             int glyphWidth, int glyphHeight,
+                             float spread = 4.0f,
+                             bool darkGlyphs = true)
+    {
+        SDFAtlas atlas;
+
+        atlas.Width = fontSprite.Width;
+        atlas.Height = fontSprite.Height;
+        atlas.GlyphWidth = glyphWidth;
+        atlas.GlyphHeight = glyphHeight;
+        atlas.Spread = spread;
+
+        atlas.Distances.resize(static_cast<std::size_t>(atlas.Width) * static_cast<std::size_t>(atlas.Height), 0);
+
+        const int numberOfColumns = atlas.Width / glyphWidth;
+        const int numberOfRows = atlas.Height / glyphHeight;
+
+        // Scratch grids are reused between glyphs
+        std::vector<bool> inside(static_cast<std::size_t>(glyphWidth) * static_cast<std::size_t>(glyphHeight));
+        std::vector<GridOffset> outsideGrid(inside.size());
+        std::vector<GridOffset> insideGrid(inside.size());
+
+        for (int glyphY = 0; glyphY < numberOfRows; glyphY++)
+        {
+            for (int glyphX = 0; glyphX < numberOfColumns; glyphX++)
+            {
+                const int cellX = glyphX * glyphWidth;
+                const int cellY = glyphY * glyphHeight;
+
+                // Classify every pixel in the cell as inside or outside the glyph
+                for (int y = 0; y < glyphHeight; y++)
+                {
+                    for (int x = 0; x < glyphWidth; x++)
+                    {
+                        const Colour& pixel = fontSprite.GetPixel(cellX + x, cellY + y);
+
+                        const int luminance = (pixel.Red + pixel.Green + pixel.Blue) / 3;
+
+                        inside[Maths::Convert2DTo1D(x, y, glyphWidth)] = darkGlyphs ? (luminance < 128) : (luminance >= 128);
+                    };
+                };
+
+                // Distance from outside pixels to the glyph, and from inside pixels to the background
+                DistanceTransform(inside, true, glyphWidth, glyphHeight, outsideGrid);
+                DistanceTransform(inside, false, glyphWidth, glyphHeight, insideGrid);
+
+                for (int y = 0; y < glyphHeight; y++)
+                {
+                    for (int x = 0; x < glyphWidth; x++)
+                    {
+                        const int index = Maths::Convert2DTo1D(x, y, glyphWidth);
+
+                        // Negative inside the glyph, positive outside
+                        const float signedDistance = std::sqrt(static_cast<float>(outsideGrid[index].LengthSquare())) -
+                                                     std::sqrt(static_cast<float>(insideGrid[index].LengthSquare()));
+
+                        const float encoded = 128.0f - (signedDistance * (127.0f / spread));
+
+                        atlas.Distances[Maths::Convert2DTo1D(cellX + x, cellY + y, atlas.Width)] = static_cast<std::uint8_t>(std::clamp(encoded, 0.0f, 255.0f));
+                    };
+                };
+            };
+        };
+
+        return atlas;
+    };
+
+
+    /// <summary>
+    /// Load a font bitmap and generate a distance field atlas from it
+    /// </summary>
+    /// <param name="graphics"></param>
+    /// <param name="fontFile"> Path to the font bitmap </param>
+    /// <param name="glyphWidth"></param>
+    /// <param name="glyphHeight"></param>
+    /// <param name="spread"></param>
+    /// <returns></returns>
+    static SDFAtlas GenerateFromFile(Graphics& graphics,
+                                     const std::wstring& fontFile,
+                                     int glyphWidth, int glyphHeight,
+                                     float spread = 4.0f)
+    {
+        Sprite fontSprite(graphics);
+        fontSprite.LoadFromFile(fontFile);
+
+        return Generate(fontSprite, glyphWidth, glyphHeight, spread);
+    };
+
+
+    /// <summary>
+    /// Write an atlas to a .sdf file
+    /// </summary>
+    /// <param name="atlas"></param>
+    /// <param name="atlasFile"></param>
+    static void SaveToFile(const SDFAtlas& atlas, const std::wstring& atlasFile)
+    {
+        std::ofstream file(atlasFile, std::ios::binary);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to create SDF atlas file");
+        };
+
+        const std::int32_t header[4] = { atlas.Width, atlas.Height, atlas.GlyphWidth, atlas.GlyphHeight };
+
+        file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&atlas.Spread), sizeof(atlas.Spread));
+        file.write(reinterpret_cast<const char*>(atlas.Distances.data()), atlas.Distances.size());
+        file.flush();
+
+        // A full disk or a dropped network share fails the writes and not the open
+        if (file.good() == false)
+        {
+            throw std::exception("Unable to write SDF atlas file");
+        };
+    };
+
+
+    /// <summary>
+    /// Read an atlas from a .sdf file
+    /// </summary>
+    /// <param name="atlasFile"></param>
+    /// <returns></returns>
+    static SDFAtlas LoadFromFile(const std::wstring& atlasFile)
+    {
+        std::ifstream file(atlasFile, std::ios::binary);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to open SDF atlas file");
+        };
+
+        char magic[sizeof(FILE_MAGIC)] = { 0 };
+        file.read(magic, sizeof(magic));
+
+        if (std::equal(std::begin(magic), std::end(magic), std::begin(FILE_MAGIC)) == false)
+            throw std::exception("Invalid SDF atlas file");
+
+        std::int32_t header[4] = { 0 };
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+        // The sizes are divided by and allocated from, a truncated header leaves them at 0
+        if ((header[0] <= 0) || (header[1] <= 0) || (header[2] <= 0) || (header[3] <= 0))
+            throw std::exception("Invalid SDF atlas file");
+
+        SDFAtlas atlas;
+        atlas.Width = header[0];
+        atlas.Height = header[1];
+        atlas.GlyphWidth = header[2];
+        atlas.GlyphHeight = header[3];
+
+        file.read(reinterpret_cast<char*>(&atlas.Spread), sizeof(atlas.Spread));
+
+        atlas.Distances.resize(static_cast<std::size_t>(atlas.Width) * static_cast<std::size_t>(atlas.Height));
+        file.read(reinterpret_cast<char*>(atlas.Distances.data()), atlas.Distances.size());
+
+        if (file.good() == false)
+            throw std::exception("SDF atlas file is truncated");
+
+        return atlas;
+    };
+
+
+private:
+
+    /// <summary>
+    /// 8-point sequential Euclidean distance transform (8SSEDT).
+    /// Fills the grid with the offset from every cell to the nearest cell whose 'inside' value equals seedValue
+    /// </summary>
+    /// <param name="inside"> The glyph coverage </param>
+    /// <param name="seedValue"> Which coverage value counts as a seed (zero distance) </param>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    /// <param name="grid"> The output offsets </param>
+    static void DistanceTransform(const std::vector<bool>& inside, bool seedValue,
+                                  int width, int height,
+                                  std::vector<GridOffset>& grid)
+    {
+        for (std::size_t index = 0; index < inside.size(); index++)
+        {
+            if (inside[index] == seedValue)
+                grid[index] = { 0, 0 };
+            else
+                grid[index] = { FAR_AWAY, FAR_AWAY };
+        };
+
+
+        // Compare a cell against a neighbour and keep the closer seed
+        auto compare = [&](int x, int y, int offsetX, int offsetY)
+        {
+            const int neighbourX = x + offsetX;
+            const int neighbourY = y + offsetY;
+
+            if (neighbourX < 0 || neighbourX >= width ||
+                neighbourY < 0 || neighbourY >= height)
+                return;
+
+            GridOffset& cell = grid[Maths::Convert2DTo1D(x, y, width)];
+
+            GridOffset candidate = grid[Maths::Convert2DTo1D(neighbourX, neighbourY, width)];
+            candidate.X += offsetX;
+            candidate.Y += offsetY;
+
+            if (candidate.LengthSquare() < cell.LengthSquare())
+                cell = candidate;
+        };
+
+
+        // First pass, top to bottom
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                compare(x, y, -1, 0);
+                compare(x, y, 0, -1);
+                compare(x, y, -1, -1);
+                compare(x, y, 1, -1);
+            };
+
+            for (int x = width - 1; x >= 0; x--)
+                compare(x, y, 1, 0);
+        };
+
+        // Second pass, bottom to top
+        for (int y = height - 1; y >= 0; y--)
+        {
+            for (int x = width - 1; x >= 0; x--)
+            {
+                compare(x, y, 1, 0);
+                compare(x, y, 0, 1);
+                compare(x, y, -1, 1);
+                compare(x, y, 1, 1);
+            };
+
+            for (int x = 0; x < width; x++)
+                compare(x, y, -1, 0);
+        };
+    };
+
+};
\ No newline at end of file
@@ -0,0 +1,261 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <xmmintrin.h>
+
+#include "SDFFontGenerator.hpp"
+#include "Vector2D.hpp"
+#include "Graphics.hpp"
+
+
+/// <summary>
+/// Draws strings from a signed distance field atlas.
+/// Unlike FontSheet a single atlas can be drawn at any scale and the glyph edges stay sharp
+/// </summary>
+class SDFFontSheet
+{
+
+private:
+
+    Graphics& _graphics;
+
+    /// <summary>
+    /// The distance field atlas
+    /// </summary>
+    SDFAtlas _atlas;
+
+    /// <summary>
+    /// The number of character coloumns in the atlas
+    /// </summary>
+    int _numberOfColumns = 0;
+
+    /// <summary>
+    /// The number of character rows in the atlas
+    /// </summary>
+    int _numberOfRows = 0;
+
+
+public:
+
+    SDFFontSheet(Graphics& graphics) :
+        _graphics(graphics)
+    {
+    };
+
+
+public:
+
+    /// <summary>
+    /// Load a pre-generated .sdf atlas
+    /// </summary>
+    /// <param name="atlasFile"></param>
+    void LoadFromFile(const std::wstring& atlasFile)
+    {
+        SetAtlas(SDFFontGenerator::LoadFromFile(atlasFile));
+    };
+
+    /// <summary>
+    /// Load a regular font bitmap and convert it to a distance field on load.
+    /// Prefer LoadFromFile with an offline generated atlas, this is mostly for convenience
+    /// </summary>
+    /// <param name="fontFile"></param>
+    /// <param name="glyphWidth"></param>
+    /// <param name="glyphHeight"></param>
+    void LoadFromBitmap(const std::wstring& fontFile, int glyphWidth, int glyphHeight)
+    {
+        SetAtlas(SDFFontGenerator::GenerateFromFile(_graphics, fontFile, glyphWidth, glyphHeight));
+    };
+
+    void SetAtlas(SDFAtlas atlas)
+    {
+        _atlas = std::move(atlas);
+
+        // Calculate the number of charater columns and rows
+        _numberOfColumns = _atlas.Width / _atlas.GlyphWidth;
+        _numberOfRows = _atlas.Height / _atlas.GlyphHeight;
+    };
+
+
+    void DrawString(const Vector2D& position, std::string_view text, float scale = 1.0f, const Colour& colour = Colours::White)
+    {
+        DrawString(position.X, position.Y, text, scale, colour);
+    };
+
+    /// <summary>
+    /// Draw a string somewhere on screen
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <param name="text"> The text to draw </param>
+    /// <param name="scale"> Any positive scale, the same atlas is used for every size </param>
+    /// <param name="colour"> The text colour </param>
+    void DrawString(float x, float y, std::string_view text, float scale = 1.0f, const Colour& colour = Colours::White)
+    {
+        // Nothing visible to draw
+        if (scale <= 0.0f)
+            return;
+
+        const float startingX = x;
+
+        const float advanceX = _atlas.GlyphWidth * scale;
+        const float advanceY = _atlas.GlyphHeight * scale;
+
+        for (size_t a = 0; a < text.size(); a++)
+        {
+            char currentChar = text[a];
+
+            if (currentChar == '\n')
+            {
+                x = startingX;
+                y += advanceY;
+
+                continue;
+            };
+
+            DrawChar(x, y, currentChar, scale, colour);
+
+            x += advanceX;
+        };
+    };
+
+
+    /// <summary>
+    /// Draw a single character
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <param name="character"></param>
+    /// <param name="scale"></param>
+    /// <param name="colour"></param>
+    void DrawChar(float x, float y, char character, float scale, const Colour& colour)
+    {
+        const int glyphIndex = character - ' ';
+
+        // Character isn't in the atlas
+        if (glyphIndex < 0 || glyphIndex >= _numberOfColumns * _numberOfRows)
+            return;
+
+        const int cellX = (glyphIndex % _numberOfColumns) * _atlas.GlyphWidth;
+        const int cellY = (glyphIndex / _numberOfColumns) * _atlas.GlyphHeight;
+
+        // Destination rectangle, clipped to the screen
+        const int beginX = (std::max)(static_cast<int>(x), 0);
+        const int beginY = (std::max)(static_cast<int>(y), 0);
+        const int endX = (std::min)(static_cast<int>(x + _atlas.GlyphWidth * scale), _graphics.GetWidth());
+        const int endY = (std::min)(static_cast<int>(y + _atlas.GlyphHeight * scale), _graphics.GetHeight());
+
+        if (beginX >= endX || beginY >= endY)
+            return;
+
+        const float inverseScale = 1.0f / scale;
+
+        // The edge is anti-aliased over a single screen pixel.
+        // One screen pixel covers 'inverseScale' atlas texels, so the smoothing band shrinks as the text gets larger
+        const float halfBand = 0.5f * (127.0f / _atlas.Spread) * inverseScale;
+
+        const __m128 edgeLow = _mm_set1_ps(127.5f - halfBand);
+        const __m128 inverseBand = _mm_set1_ps(1.0f / (2.0f * halfBand));
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+
+        Colour* pixels = _graphics.GetPixels();
+        const std::size_t pitch = _graphics.GetPitch();
+
+        for (int screenY = beginY; screenY < endY; screenY++)
+        {
+            // Position of the pixel's center in atlas cell space
+            const float v = (screenY - y + 0.5f) * inverseScale - 0.5f;
+
+            Colour* row = pixels + static_cast<std::size_t>(screenY) * pitch;
+
+            for (int screenX = beginX; screenX < endX; screenX += 4)
+            {
+                alignas(16) float distances[4] = { 0 };
+
+                const int count = (std::min)(4, endX - screenX);
+
+                for (int lane = 0; lane < count; lane++)
+                {
+                    const float u = (screenX + lane - x + 0.5f) * inverseScale - 0.5f;
+
+                    distances[lane] = SampleDistance(cellX, cellY, u, v);
+                };
+
+                // Smoothstep across the edge band, 4 pixels at a time
+                __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(distances), edgeLow), inverseBand);
+                t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+                const __m128 alpha = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+
+                alignas(16) float alphas[4];
+                _mm_store_ps(alphas, alpha);
+
+                for (int lane = 0; lane < count; lane++)
+                {
+                    // Texel is entirely outside the glyph
+                    if (alphas[lane] <= 0.0f)
+                        continue;
+
+                    Colour& screenPixel = row[screenX + lane];
+
+                    const int weight = static_cast<int>(alphas[lane] * 256.0f);
+
+                    screenPixel.Red = static_cast<std::uint8_t>(screenPixel.Red + (((colour.Red - screenPixel.Red) * weight) >> 8));
+                    screenPixel.Green = static_cast<std::uint8_t>(screenPixel.Green + (((colour.Green - screenPixel.Green) * weight) >> 8));
+                    screenPixel.Blue = static_cast<std::uint8_t>(screenPixel.Blue + (((colour.Blue - screenPixel.Blue) * weight) >> 8));
+                };
+            };
+        };
+    };
+
+
+    int GetGlyphWidth() const
+    {
+        return _atlas.GlyphWidth;
+    };
+
+    int GetGlyphHeight() const
+    {
+        return _atlas.GlyphHeight;
+    };
+
+
+private:
+
+    /// <summary>
+    /// Bilinearly sample the distance field inside a single glyph cell
+    /// </summary>
+    /// <param name="cellX"> The glyph cell's X position in the atlas </param>
+    /// <param name="cellY"> The glyph cell's Y position in the atlas </param>
+    /// <param name="u"> Cell relative X position </param>
+    /// <param name="v"> Cell relative Y position </param>
+    /// <returns></returns>
+    float SampleDistance(int cellX, int cellY, float u, float v) const
+    {
+        // Clamp to the cell so neighbouring glyphs don't bleed in
+        u = std::clamp(u, 0.0f, static_cast<float>(_atlas.GlyphWidth - 1));
+        v = std::clamp(v, 0.0f, static_cast<float>(_atlas.GlyphHeight - 1));
+
+        const int x0 = static_cast<int>(u);
+        const int y0 = static_cast<int>(v);
+
+        const int x1 = (std::min)(x0 + 1, _atlas.GlyphWidth - 1);
+        const int y1 = (std::min)(y0 + 1, _atlas.GlyphHeight - 1);
+
+        const float fractionX = u - x0;
+        const float fractionY = v - y0;
+
+        const std::uint8_t* row0 = _atlas.Distances.data() + static_cast<std::size_t>(cellY + y0) * _atlas.Width + cellX;
+        const std::uint8_t* row1 = _atlas.Distances.data() + static_cast<std::size_t>(cellY + y1) * _atlas.Width + cellX;
+
+        const float top = row0[x0] + (row0[x1] - row0[x0]) * fractionX;
+        const float bottom = row1[x0] + (row1[x1] - row1[x0]) * fractionX;
+
+        return top + (bottom - top) * fractionY;
+    };
+
+};
\ No newline at end of file
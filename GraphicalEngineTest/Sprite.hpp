@@ -1,9 +1,11 @@
 #pragma once
 #include <string>
+#include <initializer_list>
 
 #include "Graphics.hpp"
 #include "Colour.hpp"
 #include "ISpriteEffect.hpp"
+#include "ImageBuffer.hpp"
 
 
 /// <summary>
@@ -34,7 +36,7 @@ public:
     /// <summary>
     /// The sprite's pixels
     /// </summary>
-    Colour* Pixels = nullptr;
+    ImageBuffer Pixels;
 
     /// <summary>
     /// The number of pixels available
@@ -119,20 +121,17 @@ public:
 
         // Create the sprite pixels 
         PixelCount = static_cast<std::size_t>(Height) * static_cast<std::size_t>(Width);
-        Pixels = new Colour[PixelCount];
-
-        memset(Pixels, 0, PixelCount * sizeof(Colour));
+        Pixels = ImageBuffer(Width, Height);
 
 
         // Read bitmap 
         for (long long y = beginY; y != endY; y += deltaY)
         {
+            // Rows are read straight into the sprite's (padded) row
+            Colour* spriteRow = Pixels.GetRow(static_cast<int>(y));
+
             for (std::size_t x = 0; x < bitmapInfo.biWidth; x++)
             {
-                // Find pixel position 
-                std::size_t pixelPosition = x + bitmapInfo.biWidth * y;
-
-
                 Colour pixel = { 0 };
 
                 pixel.Blue = file.get();
@@ -145,7 +144,7 @@ public:
                     pixel.Alpha = file.get();
 
                 // Add pixel to sprite
-                Pixels[pixelPosition] = pixel;
+                spriteRow[x] = pixel;
             };
 
             // If the bitmap isn't 32 bit there should usually be row padding,
@@ -163,7 +162,7 @@ public:
     /// <param name="x"> X position to start drawing from </param>
     /// <param name="y"> Y position to start drawing from </param>
     /// <param name="effects"> effect(s) to apply to the sprite draw call </param>
-    void DrawSprite(int x, int y, std::vector<ISpriteEffect*> effects = { })
+    void DrawSprite(int x, int y, std::initializer_list<ISpriteEffect*> effects = { })
     {
         // Iterate through the entirety of the sprite's pixels
         for (int spriteX = 0; spriteX < Width; spriteX++)
@@ -199,7 +198,7 @@ public:
     void DrawSprite(int x, int y,
                     int x0, int y0,
                     int x1, int y1,
-                    const std::vector<ISpriteEffect*>& effects = {})
+                    std::initializer_list<ISpriteEffect*> effects = {})
     {
         // Iterate throught the sprite's pixels based on x0, y0, x1, y1 offsets
         for (int spriteX = 0; spriteX < static_cast<std::size_t>(x1) - static_cast<std::size_t>(x0); spriteX++)
@@ -237,7 +236,7 @@ public:
                     int x1, int y1,
                     float horizontalScale,
                     float verticalScale,
-                    const std::vector<ISpriteEffect*>& effects = { })
+                    std::initializer_list<ISpriteEffect*> effects = { })
     {
         // Scaling is hella expensive, don't draw if scale is tool small to be seen 
         if (horizontalScale < 0.f ||
@@ -310,7 +309,7 @@ public:
                     int xOffset, int yOffset,
                     int width, int height,
                     float scale,
-                    const std::vector<ISpriteEffect*>& effects = { })
+                    std::initializer_list<ISpriteEffect*> effects = { })
     {
         DrawSprite(x, y, xOffset, yOffset, width, height, scale, scale, effects);
     };
@@ -319,26 +318,32 @@ public:
 
 public:
 
-    Colour& GetPixel(int x, int y) const
+    const Colour& GetPixel(int x, int y) const
     {
-        int pixelDataIndexer = Maths::Convert2DTo1D(x, y, Width);
+        if (x < 0 || x >= Width ||
+            y < 0 || y >= Height)
+        {
+            throw std::exception("Index is out of range");
+        };
 
-        Colour& pixel = GetPixel(pixelDataIndexer);
+        const Colour& pixel = Pixels.GetPixel(x, y);
 
         return pixel;
     };
 
-    Colour& GetPixel(int index) const
+    /// <summary>
+    /// Get a pixel by it's index, as if the sprite was stored without row padding
+    /// </summary>
+    /// <param name="index"></param>
+    /// <returns></returns>
+    const Colour& GetPixel(int index) const
     {
-        if (index < 0 || index > Width * Height)
+        if (index < 0 || index >= Width * Height)
         {
-            DebugBreak();
             throw std::exception("Index is out of range");
         };
 
-        Colour& pixel = Pixels[index];
-
-        return pixel;
+        return GetPixel(index % Width, index / Width);
     };
 
 private:
@@ -351,11 +356,11 @@ private:
     /// <param name="spriteX"> Position of the sprite's pixel in the X axis</param>
     /// <param name="spriteY"> Position of the sprite's pixel in the Y axis</param>
     /// <param name="spritePixel"> The pixel to affect </param>
-    /// <param name="effects"> The list of effects </param>
+    /// <param name="effects"> The list of effects, an initializer_list so draw calls don't allocate </param>
     void ApplyEffects(int screenX, int screenY,
                       int spriteX, int spriteY,
                       Colour& spritePixel,
-                      const std::vector<ISpriteEffect*>& effects)
+                      std::initializer_list<ISpriteEffect*> effects)
     {
         // Check if effects available
         if (effects.size() != 0)
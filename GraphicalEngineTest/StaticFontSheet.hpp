@@ -6,10 +6,11 @@
 #include "Vector2D.hpp"
 
 #include "Graphics.hpp"
+#include "ImageBuffer.hpp"
 
 struct StaticBitmap
 {
-    Colour* PixelBuffer = nullptr;
+    ImageBuffer PixelBuffer;
 
     std::size_t PixelBufferLength = 0;
 
@@ -51,18 +52,26 @@ private:
 
     Graphics& _graphics;
 
+    /// <summary>
+    /// Optional pool the generated buffers are taken from, null to use the heap
+    /// </summary>
+    ImageBufferPool* _pool;
+
 public:
 
     StaticFontSheet(const std::wstring& spriteFile,
                     class Graphics& graphics,
                     int glyphWidh,
-                    int glyphHeight) :
+                    int glyphHeight,
+                    ImageBufferPool* pool = nullptr) :
         _glyphWidth(glyphWidh),
         _glyphHeight(glyphHeight),
 
         _sprite(graphics),
 
-        _graphics(graphics)
+        _graphics(graphics),
+
+        _pool(pool)
     {
         _sprite.LoadFromFile(spriteFile);
 
@@ -93,12 +102,15 @@ public:
             tempWidth++;
         };
 
+        // The last line isn't terminated by a newline
+        if (tempWidth > width)
+            width = tempWidth;
 
 
         const int bufferWidth = width * _glyphWidth;
         const int bufferHeight = rows * _glyphHeight;
 
-        Colour* pixelBuffer = new Colour[bufferWidth * bufferHeight] { 0 };
+        ImageBuffer pixelBuffer(bufferWidth, bufferHeight, _pool);
 
         int aTemp = 0;
         int line = 0;
@@ -119,22 +131,17 @@ public:
             {
                 for (int y = 0; y < _glyphHeight; y++)
                 {
-                    const int pixelBufferIndex = Maths::Convert2DTo1D(x + (_glyphWidth * aTemp),
-                                                                      y + (_glyphHeight * line), bufferWidth);
-
-                    const int spriteIndex = Maths::Convert2DTo1D(x + (_glyphWidth * characterPos.first),
-                                                                 y + (_glyphHeight * characterPos.second),
-                                                                 _sprite.Width);
-
-                    pixelBuffer[pixelBufferIndex] = _sprite.GetPixel(spriteIndex);
+                    pixelBuffer.GetPixel(x + (_glyphWidth * aTemp),
+                                         y + (_glyphHeight * line)) = _sprite.GetPixel(x + (_glyphWidth * characterPos.first),
+                                                                                       y + (_glyphHeight * characterPos.second));
                 };
             };
 
             aTemp++;
         };
 
-        StaticBitmap staticBitmap = { 0 };
-        staticBitmap.PixelBuffer = pixelBuffer;
+        StaticBitmap staticBitmap;
+        staticBitmap.PixelBuffer = std::move(pixelBuffer);
 
         staticBitmap.PixelBufferWidth = bufferWidth;
         staticBitmap.PixelBufferHeight = bufferHeight;
@@ -166,11 +173,15 @@ public:
                 tempWidth++;
             };
 
+            // The last line isn't terminated by a newline
+            if (tempWidth > width)
+                width = tempWidth;
+
 
             const int bufferWidth = width * _glyphWidth;
             const int bufferHeight = rows * _glyphHeight;
 
-            Colour* pixelBuffer = new Colour[bufferWidth * bufferHeight] { 0 };
+            ImageBuffer pixelBuffer(bufferWidth, bufferHeight, _pool);
 
             int aTemp = 0;
             int line = 0;
@@ -196,15 +207,9 @@ public:
                         {
                             for (float scaleY = 0; scaleY < scale; scaleY++)
                             {
-                                const int pixelBufferIndex = Maths::Convert2DTo1D(x + (_glyphWidth * aTemp),
-                                                                                  y + (_glyphHeight * line), 
-                                                                                  bufferWidth);
-
-                                const int spriteIndex = Maths::Convert2DTo1D(x + (_glyphWidth * characterPos.first),
-                                                                             y + (_glyphHeight * characterPos.second),
-                                                                             _sprite.Width);
-
-                                pixelBuffer[pixelBufferIndex] = _sprite.GetPixel(spriteIndex);
+                                pixelBuffer.GetPixel(x + (_glyphWidth * aTemp),
+                                                     y + (_glyphHeight * line)) = _sprite.GetPixel(x + (_glyphWidth * characterPos.first),
+                                                                                                   y + (_glyphHeight * characterPos.second));
 
                             };
                         };
@@ -214,8 +219,8 @@ public:
                 aTemp++;
             };
 
-            StaticBitmap staticBitmap = { 0 };
-            staticBitmap.PixelBuffer = pixelBuffer;
+            StaticBitmap staticBitmap;
+            staticBitmap.PixelBuffer = std::move(pixelBuffer);
 
             staticBitmap.PixelBufferWidth = bufferWidth;
             staticBitmap.PixelBufferHeight = bufferHeight;
@@ -229,9 +234,9 @@ public:
     };
 
 
-    Colour* GenerateChar(char character)
+    ImageBuffer GenerateChar(char character)
     {
-        Colour* pixelBuffer = new Colour[_glyphWidth * _glyphHeight] { 0 };
+        ImageBuffer pixelBuffer(_glyphWidth, _glyphHeight, _pool);
 
         const std::pair<int, int>& characterPos = GetCharacterPos(character);
 
@@ -240,13 +245,8 @@ public:
         {
             for (int y = 0; y < _glyphHeight; y++)
             {
-                const int pixelBufferIndex = Maths::Convert2DTo1D(x, y, _glyphWidth);
-
-                const int spriteIndex = Maths::Convert2DTo1D(x + (_glyphWidth * characterPos.first),
-                                                             y + (_glyphHeight * characterPos.second),
-                                                             _sprite.Width);
-
-                pixelBuffer[pixelBufferIndex] = _sprite.GetPixel(spriteIndex);
+                pixelBuffer.GetPixel(x, y) = _sprite.GetPixel(x + (_glyphWidth * characterPos.first),
+                                                              y + (_glyphHeight * characterPos.second));
             };
         };
 
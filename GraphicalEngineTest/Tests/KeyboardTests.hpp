@@ -0,0 +1,128 @@
+#pragma once
+#include "Keyboard.hpp"
+#include "TestReport.hpp"
+
+
+/// <summary>
+/// Tests the Keyboard's event driven states by feeding it key transitions by hand, without a window
+/// </summary>
+class KeyboardTests
+{
+
+private:
+
+    static constexpr int KEY_A = 'A';
+    static constexpr int KEY_B = 'B';
+    static constexpr int KEY_C = 'C';
+
+
+public:
+
+    static void Run(TestReport& report)
+    {
+        PressAndReleaseInOneFrame(report);
+        RepeatedKeyDown(report);
+        ReleaseAllKeys(report);
+    };
+
+
+private:
+
+    /// <summary>
+    /// A key that goes down and up between 2 updates is still seen as pressed for a frame
+    /// </summary>
+    /// <param name="report"></param>
+    static void PressAndReleaseInOneFrame(TestReport& report)
+    {
+        report.BeginTest("Keyboard: press and release in the same frame");
+
+        Keyboard keyboard;
+
+        keyboard.OnKeyDown(KEY_A);
+        keyboard.OnKeyUp(KEY_A);
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Pressed, "Pressed on the first update");
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Released, "Released on the next update");
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::None, "None after that");
+
+        report.Check(keyboard.GetKeyState(KEY_B) == KeyState::None, "Other keys are untouched");
+    };
+
+
+    /// <summary>
+    /// Auto-repeated key downs, in the same frame or later ones, don't press the key again
+    /// </summary>
+    /// <param name="report"></param>
+    static void RepeatedKeyDown(TestReport& report)
+    {
+        report.BeginTest("Keyboard: repeated key down");
+
+        Keyboard keyboard;
+
+        keyboard.OnKeyDown(KEY_A);
+        keyboard.OnKeyDown(KEY_A);
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Pressed, "Pressed on the first update");
+
+        keyboard.OnKeyDown(KEY_A);
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Held, "Held after a repeated key down");
+
+        keyboard.OnKeyDown(KEY_A);
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Held, "Still held after another repeated key down");
+        report.Check(keyboard.GetChangedKeys().empty() == true, "A held key isn't reported as changed");
+
+        keyboard.OnKeyUp(KEY_A);
+
+        keyboard.Update();
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Released, "Released by the key up");
+    };
+
+
+    /// <summary>
+    /// Losing focus releases every key that is down, and drops key downs that weren't applied yet
+    /// </summary>
+    /// <param name="report"></param>
+    static void ReleaseAllKeys(TestReport& report)
+    {
+        report.BeginTest("Keyboard: release all keys");
+
+        Keyboard keyboard;
+
+        keyboard.OnKeyDown(KEY_A);
+        keyboard.Update();
+
+        keyboard.OnKeyDown(KEY_B);
+        keyboard.Update();
+
+        // Down, but not applied before focus is lost
+        keyboard.OnKeyDown(KEY_C);
+
+        keyboard.ReleaseAllKeys();
+        keyboard.Update();
+
+        report.Check(keyboard.GetKeyState(KEY_A) == KeyState::Released, "A held key is released");
+        report.Check(keyboard.GetKeyState(KEY_B) == KeyState::Released, "A pressed key is released");
+        report.Check(keyboard.GetKeyState(KEY_C) == KeyState::None, "A queued key down is dropped");
+
+        keyboard.Update();
+
+        report.Check((keyboard.GetKeyState(KEY_A) == KeyState::None) &&
+                     (keyboard.GetKeyState(KEY_B) == KeyState::None), "Released keys become None");
+
+        keyboard.ReleaseAllKeys();
+        keyboard.Update();
+
+        report.Check(keyboard.GetChangedKeys().empty() == true, "Releasing with no keys down changes nothing");
+    };
+
+};
@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+#include "Matrix3x3.hpp"
+#include "Matrix4x4.hpp"
+#include "TestReport.hpp"
+
+
+/// <summary>
+/// Tests the 3D maths against values worked out by hand, and the SSE paths against the scalar ones they replace.
+/// Floats are compared with a tolerance, the SSE and scalar paths may round differently
+/// </summary>
+class MathsTests
+{
+
+private:
+
+    static constexpr float TOLERANCE = 1e-4f;
+
+    /// <summary>
+    /// Not a multiple of 4, so the stream transforms' scalar tail runs too
+    /// </summary>
+    static constexpr std::size_t STREAM_SIZE = 11;
+
+
+public:
+
+    static void Run(TestReport& report)
+    {
+        CheckInverses(report);
+        CheckLookAt(report);
+        CheckPerspective(report);
+        CheckStreamTransforms(report);
+    };
+
+
+private:
+
+    /// <summary>
+    /// A transform combined with it's inverse must do nothing, in either order
+    /// </summary>
+    /// <param name="report"></param>
+    static void CheckInverses(TestReport& report)
+    {
+        report.BeginTest("Maths: inverses");
+
+        const Matrix3x3 linear = Matrix3x3::Scale(2.0f, 3.0f, 0.5f) * Matrix3x3::Rotation({ 1.0f, 2.0f, 3.0f }, 0.7f);
+
+        report.Check(IsIdentity(linear.Inverse() * linear), "Matrix3x3 inverse * original is the identity");
+        report.Check(IsIdentity(linear * linear.Inverse()), "Matrix3x3 original * inverse is the identity");
+
+        const Matrix4x4 affine = Matrix4x4::Scale(2.0f, 3.0f, 0.5f) * Matrix4x4::Rotation({ 1.0f, 2.0f, 3.0f }, 0.7f) * Matrix4x4::Translation(5.0f, -3.0f, 7.0f);
+
+        report.Check(IsIdentity(affine.Inverse() * affine), "Matrix4x4 affine inverse * original is the identity");
+        report.Check(IsIdentity(affine * affine.Inverse()), "Matrix4x4 affine original * inverse is the identity");
+
+        // A projection has a zero M44 and a non-zero M34, so every block of the block-wise inverse is used
+        const Matrix4x4 projection = Matrix4x4::LookAt({ 3.0f, 4.0f, -5.0f }, { 0.0f, 1.0f, 2.0f }, { 0.0f, 1.0f, 0.0f }) *
+                                     Matrix4x4::Perspective(1.2f, 4.0f / 3.0f, 0.5f, 50.0f);
+
+        report.Check(IsIdentity(projection.Inverse() * projection), "Matrix4x4 projection inverse * original is the identity");
+        report.Check(IsIdentity(projection * projection.Inverse()), "Matrix4x4 projection original * inverse is the identity");
+
+        report.Check(IsSame(affine * projection, Matrix4x4::Multiply(affine, projection)), "Matrix4x4 operator * matches Multiply");
+    };
+
+    /// <summary>
+    /// LookAt must move the eye to the origin and the target onto the positive Z axis, with the up vector still up
+    /// </summary>
+    /// <param name="report"></param>
+    static void CheckLookAt(TestReport& report)
+    {
+        report.BeginTest("Maths: LookAt");
+
+        // Looking along Z from behind the origin, the view transform is only a translation
+        const Matrix4x4 straight = Matrix4x4::LookAt({ 1.0f, 2.0f, -5.0f }, { 1.0f, 2.0f, 5.0f }, { 0.0f, 1.0f, 0.0f });
+
+        report.Check(IsSame(straight, Matrix4x4::Translation(-1.0f, -2.0f, 5.0f)), "Looking along Z is a translation");
+
+        // Looking at the origin from X, so the world's Z axis is the view's right
+        const Matrix4x4 side = Matrix4x4::LookAt({ 10.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+
+        report.Check(IsSame(side.TransformPoint({ 10.0f, 0.0f, 0.0f }), { 0.0f, 0.0f, 0.0f, 1.0f }), "The eye is at the origin");
+        report.Check(IsSame(side.TransformPoint({ 0.0f, 0.0f, 0.0f }), { 0.0f, 0.0f, 10.0f, 1.0f }), "The target is on the Z axis");
+        report.Check(IsSame(side.TransformPoint({ 10.0f, 1.0f, 0.0f }), { 0.0f, 1.0f, 0.0f, 1.0f }), "Up stays up");
+        report.Check(IsSame(side.TransformPoint({ 10.0f, 0.0f, 1.0f }), { 1.0f, 0.0f, 0.0f, 1.0f }), "The right is Z");
+        report.Check(IsSame(side.TransformDirection({ 1.0f, 0.0f, 0.0f }), { 0.0f, 0.0f, -1.0f }), "Directions aren't translated, X is backwards");
+    };
+
+    /// <summary>
+    /// Perspective must put W at the view depth, Z at 0 and 1 on the near and far planes, and X and Y at +-1 on the field of view's edges
+    /// </summary>
+    /// <param name="report"></param>
+    static void CheckPerspective(TestReport& report)
+    {
+        report.BeginTest("Maths: Perspective");
+
+        // A 90 degree field of view, so the edges are where Y is the depth
+        const float nearW = 1.0f;
+        const float farW = 10.0f;
+        const float aspectRatio = 2.0f;
+
+        const Matrix4x4 projection = Matrix4x4::Perspective(2.0f * std::atan(1.0f), aspectRatio, nearW, farW);
+
+        const Vector4 nearPoint = projection.TransformPoint({ 0.0f, 0.0f, nearW });
+        const Vector4 farPoint = projection.TransformPoint({ 0.0f, 0.0f, farW });
+
+        report.Check(IsNear(nearPoint.W, nearW) && IsNear(farPoint.W, farW), "W is the view depth");
+        report.Check(IsNear(nearPoint.PerspectiveDivide().Z, 0.0f), "Z is 0 at the near plane");
+        report.Check(IsNear(farPoint.PerspectiveDivide().Z, 1.0f), "Z is 1 at the far plane");
+
+        const float depth = 4.0f;
+
+        const Vector3 top = projection.TransformPoint({ 0.0f, depth, depth }).PerspectiveDivide();
+        const Vector3 bottom = projection.TransformPoint({ 0.0f, -depth, depth }).PerspectiveDivide();
+        const Vector3 right = projection.TransformPoint({ aspectRatio * depth, 0.0f, depth }).PerspectiveDivide();
+        const Vector3 left = projection.TransformPoint({ -aspectRatio * depth, 0.0f, depth }).PerspectiveDivide();
+
+        report.Check(IsNear(top.X, 0.0f) && IsNear(top.Y, 1.0f) && IsNear(bottom.X, 0.0f) && IsNear(bottom.Y, -1.0f), "Y is +-1 on the top and bottom edges");
+        report.Check(IsNear(right.X, 1.0f) && IsNear(right.Y, 0.0f) && IsNear(left.X, -1.0f) && IsNear(left.Y, 0.0f), "X is +-1 on the left and right edges");
+    };
+
+    /// <summary>
+    /// The stream transforms must give the same results as transforming every point on it's own
+    /// </summary>
+    /// <param name="report"></param>
+    static void CheckStreamTransforms(TestReport& report)
+    {
+        report.BeginTest("Maths: stream transforms");
+
+        std::vector<float> x(STREAM_SIZE);
+        std::vector<float> y(STREAM_SIZE);
+        std::vector<float> z(STREAM_SIZE);
+
+        for (std::size_t index = 0; index < STREAM_SIZE; index++)
+        {
+            const float value = static_cast<float>(index);
+
+            x[index] = value * 1.5f - 7.0f;
+            y[index] = 3.0f - value * 0.25f;
+            z[index] = value * value * 0.1f + 1.0f;
+        };
+
+
+        const Matrix4x4 projection = Matrix4x4::LookAt({ 3.0f, 4.0f, -5.0f }, { 0.0f, 1.0f, 2.0f }, { 0.0f, 1.0f, 0.0f }) *
+                                     Matrix4x4::Perspective(1.2f, 4.0f / 3.0f, 0.5f, 50.0f);
+
+        std::vector<float> outputX(STREAM_SIZE);
+        std::vector<float> outputY(STREAM_SIZE);
+        std::vector<float> outputZ(STREAM_SIZE);
+        std::vector<float> outputW(STREAM_SIZE);
+
+        projection.TransformPoints(x.data(), y.data(), z.data(), outputX.data(), outputY.data(), outputZ.data(), outputW.data(), STREAM_SIZE);
+
+        int pointDifferences = 0;
+
+        for (std::size_t index = 0; index < STREAM_SIZE; index++)
+        {
+            const Vector4 expected = projection.TransformPoint({ x[index], y[index], z[index] });
+
+            if (IsSame({ outputX[index], outputY[index], outputZ[index], outputW[index] }, expected) == false)
+                pointDifferences++;
+        };
+
+        report.Check(pointDifferences == 0, "Matrix4x4::TransformPoints matches TransformPoint");
+
+
+        // Transformed in place, the output can be the input
+        const Matrix3x3 linear = Matrix3x3::Scale(2.0f, 3.0f, 0.5f) * Matrix3x3::Rotation({ 1.0f, 2.0f, 3.0f }, 0.7f);
+
+        std::vector<Vector3> expectedVectors(STREAM_SIZE);
+
+        for (std::size_t index = 0; index < STREAM_SIZE; index++)
+            expectedVectors[index] = linear.Transform({ x[index], y[index], z[index] });
+
+        linear.TransformVectors(x.data(), y.data(), z.data(), x.data(), y.data(), z.data(), STREAM_SIZE);
+
+        int vectorDifferences = 0;
+
+        for (std::size_t index = 0; index < STREAM_SIZE; index++)
+        {
+            if (IsSame({ x[index], y[index], z[index] }, expectedVectors[index]) == false)
+                vectorDifferences++;
+        };
+
+        report.Check(vectorDifferences == 0, "Matrix3x3::TransformVectors in place matches Transform");
+    };
+
+
+private:
+
+    static bool IsNear(float value, float expected)
+    {
+        return std::abs(value - expected) <= TOLERANCE * (std::max)(1.0f, std::abs(expected));
+    };
+
+    static bool IsSame(const Vector3& vector, const Vector3& expected)
+    {
+        return IsNear(vector.X, expected.X) && IsNear(vector.Y, expected.Y) && IsNear(vector.Z, expected.Z);
+    };
+
+    static bool IsSame(const Vector4& vector, const Vector4& expected)
+    {
+        return IsSame(vector.XYZ(), expected.XYZ()) && IsNear(vector.W, expected.W);
+    };
+
+    static bool IsSame(const Matrix4x4& matrix, const Matrix4x4& expected)
+    {
+        const float* elements = &matrix.M11;
+        const float* expectedElements = &expected.M11;
+
+        for (std::size_t index = 0; index < 16; index++)
+        {
+            if (IsNear(elements[index], expectedElements[index]) == false)
+                return false;
+        };
+
+        return true;
+    };
+
+    static bool IsIdentity(const Matrix4x4& matrix)
+    {
+        return IsSame(matrix, Matrix4x4::Identity());
+    };
+
+    static bool IsIdentity(const Matrix3x3& matrix)
+    {
+        return IsSame(matrix.Transform({ 1.0f, 0.0f, 0.0f }), { 1.0f, 0.0f, 0.0f }) &&
+               IsSame(matrix.Transform({ 0.0f, 1.0f, 0.0f }), { 0.0f, 1.0f, 0.0f }) &&
+               IsSame(matrix.Transform({ 0.0f, 0.0f, 1.0f }), { 0.0f, 0.0f, 1.0f });
+    };
+
+};
@@ -0,0 +1,455 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Graphics.hpp"
+#include "Mesh.hpp"
+#include "Matrix3x2.hpp"
+#include "TestReport.hpp"
+
+
+/// <summary>
+/// Tests the rasterizer's fill rule without a window, on meshes of triangles that share edges and cover the whole frame.
+/// Every pixel centre must belong to exactly 1 triangle, so the top-left rule and the 28.4 snapping can't leave a gap or draw a pixel twice
+/// </summary>
+class RasterizerTests
+{
+
+private:
+
+    static constexpr int FRAME_WIDTH = 160;
+    static constexpr int FRAME_HEIGHT = 120;
+
+    /// <summary>
+    /// The grid's outer vertices are this far outside the frame, so it covers all of it
+    /// </summary>
+    static constexpr int GRID_MARGIN = 16;
+
+    static constexpr int GRID_COLUMNS = 12;
+    static constexpr int GRID_ROWS = 8;
+
+    static constexpr int FAN_SPOKES = 48;
+    static constexpr float FAN_RADIUS = 200.0f;
+
+    /// <summary>
+    /// The number of vertices along each side of the large mesh, enough that it's draw tables don't fit in the draw arena's first megabyte
+    /// </summary>
+    static constexpr int LARGE_MESH_SIZE = 300;
+
+    /// <summary>
+    /// The receding triangle's far vertex W, and where it's horizon is on the screen
+    /// </summary>
+    static constexpr float RECEDING_FAR_W = 100.0f;
+    static constexpr float RECEDING_HORIZON_Y = 20.0f;
+
+
+public:
+
+    static void Run(TestReport& report)
+    {
+        Graphics graphics(FRAME_WIDTH, FRAME_HEIGHT);
+        graphics.SetupHeadless();
+
+        CheckSharedEdges(report, graphics, "Rasterizer: jittered grid of shared edges", BuildGrid());
+        CheckSharedEdges(report, graphics, "Rasterizer: fan of shared edges", BuildFan());
+
+        CheckLargeMesh(report, graphics);
+        CheckRecedingTriangle(report, graphics);
+    };
+
+
+private:
+
+    /// <summary>
+    /// Draw a mesh that covers the frame a triangle at a time, and check that every pixel was written by exactly 1 triangle.
+    /// Then check that drawing the triangles in distinct colours, and drawing the whole mesh, writes the same pixels
+    /// </summary>
+    /// <param name="report"></param>
+    /// <param name="graphics"></param>
+    /// <param name="name"></param>
+    /// <param name="mesh"></param>
+    static void CheckSharedEdges(TestReport& report, Graphics& graphics, const char* name, const Mesh& mesh)
+    {
+        report.BeginTest(name);
+
+        const std::size_t triangleCount = mesh.GetTriangleCount();
+
+        std::vector<int> writeCounts(static_cast<std::size_t>(FRAME_WIDTH) * FRAME_HEIGHT, 0);
+        std::vector<std::size_t> owners(writeCounts.size(), 0);
+
+        // Every triangle on it's own frame, so a pixel written by 2 triangles can be seen
+        for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+        {
+            graphics.ClearFrame();
+
+            FillMeshTriangle(graphics, mesh, triangle, Colours::White);
+
+            ForEachPixel(graphics, [&](const Colour& pixel, std::size_t index)
+            {
+                if (pixel.Alpha == 0)
+                    return;
+
+                writeCounts[index]++;
+                owners[index] = triangle;
+            });
+        };
+
+        int gaps = 0;
+        int overdrawn = 0;
+
+        for (const int writeCount : writeCounts)
+        {
+            if (writeCount == 0)
+                gaps++;
+            else if (writeCount > 1)
+                overdrawn++;
+        };
+
+        report.Check(gaps == 0, "Every pixel is written");
+        report.Check(overdrawn == 0, "No pixel is written by 2 triangles");
+
+
+        // All of the triangles on one frame, the last write to a pixel must be it's only one
+        graphics.ClearFrame();
+
+        for (std::size_t triangle = 0; triangle < triangleCount; triangle++)
+            FillMeshTriangle(graphics, mesh, triangle, GetTriangleColour(triangle));
+
+        int wrongColours = 0;
+
+        ForEachPixel(graphics, [&](const Colour& pixel, std::size_t index)
+        {
+            if ((writeCounts[index] == 1) && (IsSameColour(pixel, GetTriangleColour(owners[index])) == false))
+                wrongColours++;
+        });
+
+        report.Check(wrongColours == 0, "Every pixel has the colour of the triangle that covers it");
+
+
+        // The mesh paths transform and snap the vertices on their own, they must still draw the same pixels.
+        // Only every other triangle is drawn, so the edges between drawn and skipped triangles are compared and not just the whole frame
+        const Mesh evenTriangles = GetEvenTriangles(mesh);
+
+        graphics.ClearFrame();
+        graphics.DrawMesh(evenTriangles, Matrix3x2::Identity(), Colours::White, TriangleCulling::None);
+
+        int meshDifferences = 0;
+
+        ForEachPixel(graphics, [&](const Colour& pixel, std::size_t index)
+        {
+            const bool even = (writeCounts[index] == 1) && ((owners[index] % 2) == 0);
+
+            if ((pixel.Alpha != 0) != even)
+                meshDifferences++;
+        });
+
+        report.Check(meshDifferences == 0, "DrawMesh writes the same pixels as FillTriangle");
+
+        const std::uint64_t meshHash = graphics.GetFrameHash();
+
+        graphics.ClearFrame();
+        graphics.DrawMeshParallel(evenTriangles, Matrix3x2::Identity(), Colours::White, TriangleCulling::None);
+
+        report.Check(graphics.GetFrameHash() == meshHash, "DrawMeshParallel draws the same frame as DrawMesh");
+    };
+
+
+    /// <summary>
+    /// Draw a mesh that covers the frame and is too large for the draw arena's first capacity, the arena must grow instead of throwing
+    /// </summary>
+    /// <param name="report"></param>
+    /// <param name="graphics"></param>
+    static void CheckLargeMesh(TestReport& report, Graphics& graphics)
+    {
+        report.BeginTest("Rasterizer: large mesh");
+
+        const Mesh mesh = BuildLargeMesh();
+
+        graphics.ClearFrame();
+        graphics.DrawMesh(mesh, Matrix3x2::Identity(), Colours::White, TriangleCulling::None);
+
+        report.Check(CountWrittenPixels(graphics) == FRAME_WIDTH * FRAME_HEIGHT, "DrawMesh draws every triangle");
+
+        const std::uint64_t meshHash = graphics.GetFrameHash();
+
+        graphics.ClearFrame();
+        graphics.DrawMeshParallel(mesh, Matrix3x2::Identity(), Colours::White, TriangleCulling::None);
+
+        report.Check(graphics.GetFrameHash() == meshHash, "DrawMeshParallel draws the same frame as DrawMesh");
+
+        // White vertices at W 1, so the same frame as DrawMesh
+        graphics.ClearFrame();
+        graphics.DrawShadedMesh(mesh, Matrix3x2::Identity(), nullptr, TextureFilter::Nearest, TriangleCulling::None);
+
+        report.Check(graphics.GetFrameHash() == meshHash, "DrawShadedMesh draws the same frame as DrawMesh");
+    };
+
+
+    /// <summary>
+    /// Draw a floor triangle that recedes from W 1 to near the horizon, so the corners of the blocks around it's far vertex are past the horizon.
+    /// Every vertex has the same colour, so every pixel must have that colour too
+    /// </summary>
+    /// <param name="report"></param>
+    /// <param name="graphics"></param>
+    static void CheckRecedingTriangle(TestReport& report, Graphics& graphics)
+    {
+        report.BeginTest("Rasterizer: steeply receding triangle");
+
+        // Seen from 1 unit above the floor, the translation is scaled by W so the floor meets the horizon at RECEDING_HORIZON_Y
+        const float focalLength = 60.0f;
+        const Matrix3x2 transform = Matrix3x2::Translation(FRAME_WIDTH / 2.0f, RECEDING_HORIZON_Y);
+
+        const Colour colour = { 200, 100, 40, 255 };
+
+        Mesh mesh;
+        mesh.AddTriangle(mesh.AddVertex({ -2.0f * focalLength, focalLength }, colour, { 0.0f, 0.0f }, 1.0f),
+                         mesh.AddVertex({ 2.0f * focalLength, focalLength }, colour, { 1.0f, 0.0f }, 1.0f),
+                         mesh.AddVertex({ 0.0f, focalLength }, colour, { 0.5f, 1.0f }, RECEDING_FAR_W));
+
+        // Mark every pixel first, so pixels drawn with a wrong alpha of 0 are seen too
+        const Colour marker = { 1, 2, 3, 4 };
+
+        graphics.ClearFrame();
+        graphics.FillTriangle({ -1.0f, -1.0f }, { FRAME_WIDTH * 2.0f + 1.0f, -1.0f }, { -1.0f, FRAME_HEIGHT * 2.0f + 1.0f }, marker);
+
+        graphics.DrawShadedMesh(mesh, transform, nullptr, TextureFilter::Nearest, TriangleCulling::None);
+
+        int drawn = 0;
+        int wrongColours = 0;
+
+        ForEachPixel(graphics, [&](const Colour& pixel, std::size_t)
+        {
+            if (IsSameColour(pixel, marker) == true)
+                return;
+
+            drawn++;
+
+            // Give or take the rounding down to a byte
+            if ((std::abs(pixel.Red - colour.Red) > 1) ||
+                (std::abs(pixel.Green - colour.Green) > 1) ||
+                (std::abs(pixel.Blue - colour.Blue) > 1) ||
+                (std::abs(pixel.Alpha - colour.Alpha) > 1))
+            {
+                wrongColours++;
+            };
+        });
+
+        report.Check(drawn > 0, "The triangle is drawn");
+        report.Check(wrongColours == 0, "Every pixel has the vertices' colour");
+    };
+
+
+    /// <summary>
+    /// A grid of quads split into 2 triangles, with the diagonals and the winding order alternating between cells.
+    /// The vertices start at pixel centres, so unmoved neighbours make horizontal and vertical edges that pass through pixel centres.
+    /// Most of the inner vertices are moved by amounts that aren't multiples of 1/16 pixel, so they have to be snapped
+    /// </summary>
+    /// <returns></returns>
+    static Mesh BuildGrid()
+    {
+        Mesh mesh;
+        mesh.Reserve(static_cast<std::size_t>(GRID_COLUMNS + 1) * (GRID_ROWS + 1), static_cast<std::size_t>(GRID_COLUMNS) * GRID_ROWS * 2);
+
+        const float cellWidth = static_cast<float>(FRAME_WIDTH + GRID_MARGIN * 2) / GRID_COLUMNS;
+        const float cellHeight = static_cast<float>(FRAME_HEIGHT + GRID_MARGIN * 2) / GRID_ROWS;
+
+        for (int row = 0; row <= GRID_ROWS; row++)
+        {
+            for (int column = 0; column <= GRID_COLUMNS; column++)
+            {
+                float x = std::floor(column * cellWidth) - GRID_MARGIN + 0.5f;
+                float y = std::floor(row * cellHeight) - GRID_MARGIN + 0.5f;
+
+                const bool inner = (column > 0) && (column < GRID_COLUMNS) && (row > 0) && (row < GRID_ROWS);
+
+                if ((inner == true) && (((column + row * 2) % 3) != 0))
+                {
+                    x += ((column * 7 + row * 13) % 11 - 5) * 0.8125f + 0.04f;
+                    y += ((column * 5 + row * 3) % 9 - 4) * 0.9375f - 0.02f;
+                };
+
+                mesh.AddVertex({ x, y });
+            };
+        };
+
+        for (int row = 0; row < GRID_ROWS; row++)
+        {
+            for (int column = 0; column < GRID_COLUMNS; column++)
+            {
+                const std::uint32_t topLeft = static_cast<std::uint32_t>(row * (GRID_COLUMNS + 1) + column);
+                const std::uint32_t topRight = topLeft + 1;
+                const std::uint32_t bottomLeft = topLeft + GRID_COLUMNS + 1;
+                const std::uint32_t bottomRight = bottomLeft + 1;
+
+                if (((column + row) % 2) == 0)
+                {
+                    mesh.AddTriangle(topLeft, topRight, bottomRight);
+                    mesh.AddTriangle(topLeft, bottomLeft, bottomRight);
+                }
+                else
+                {
+                    mesh.AddTriangle(topRight, bottomLeft, topLeft);
+                    mesh.AddTriangle(topRight, bottomRight, bottomLeft);
+                };
+            };
+        };
+
+        return mesh;
+    };
+
+    /// <summary>
+    /// Triangles around a vertex at a pixel centre, the outer vertices are outside the frame and also at pixel centres.
+    /// So the horizontal, vertical and diagonal spokes pass exactly through pixel centres
+    /// </summary>
+    /// <returns></returns>
+    static Mesh BuildFan()
+    {
+        Mesh mesh;
+        mesh.Reserve(FAN_SPOKES + 1, FAN_SPOKES);
+
+        const float centreX = FRAME_WIDTH / 2 + 0.5f;
+        const float centreY = FRAME_HEIGHT / 2 + 0.5f;
+
+        const std::uint32_t centre = mesh.AddVertex({ centreX, centreY });
+
+        for (int spoke = 0; spoke < FAN_SPOKES; spoke++)
+        {
+            const float angle = spoke * (6.28318530718f / FAN_SPOKES);
+
+            mesh.AddVertex({ std::floor(centreX + std::cos(angle) * FAN_RADIUS) + 0.5f,
+                             std::floor(centreY + std::sin(angle) * FAN_RADIUS) + 0.5f });
+        };
+
+        for (int spoke = 0; spoke < FAN_SPOKES; spoke++)
+        {
+            const std::uint32_t first = centre + 1 + spoke;
+            const std::uint32_t second = centre + 1 + (spoke + 1) % FAN_SPOKES;
+
+            mesh.AddTriangle(centre, first, second);
+        };
+
+        return mesh;
+    };
+
+
+    /// <summary>
+    /// A regular grid of many small triangles, half a pixel past every side of the frame
+    /// </summary>
+    /// <returns></returns>
+    static Mesh BuildLargeMesh()
+    {
+        Mesh mesh;
+        mesh.Reserve(static_cast<std::size_t>(LARGE_MESH_SIZE) * LARGE_MESH_SIZE,
+                     static_cast<std::size_t>(LARGE_MESH_SIZE - 1) * (LARGE_MESH_SIZE - 1) * 2);
+
+        const float spacingX = (FRAME_WIDTH + 1.0f) / (LARGE_MESH_SIZE - 1);
+        const float spacingY = (FRAME_HEIGHT + 1.0f) / (LARGE_MESH_SIZE - 1);
+
+        for (int row = 0; row < LARGE_MESH_SIZE; row++)
+            for (int column = 0; column < LARGE_MESH_SIZE; column++)
+                mesh.AddVertex({ column * spacingX - 0.5f, row * spacingY - 0.5f });
+
+        for (int row = 0; row < LARGE_MESH_SIZE - 1; row++)
+        {
+            for (int column = 0; column < LARGE_MESH_SIZE - 1; column++)
+            {
+                const std::uint32_t topLeft = static_cast<std::uint32_t>(row * LARGE_MESH_SIZE + column);
+
+                mesh.AddTriangle(topLeft, topLeft + 1, topLeft + LARGE_MESH_SIZE + 1);
+                mesh.AddTriangle(topLeft, topLeft + LARGE_MESH_SIZE + 1, topLeft + LARGE_MESH_SIZE);
+            };
+        };
+
+        return mesh;
+    };
+
+
+    /// <summary>
+    /// Copy a mesh's vertices and only the triangles with an even index
+    /// </summary>
+    /// <param name="mesh"></param>
+    /// <returns></returns>
+    static Mesh GetEvenTriangles(const Mesh& mesh)
+    {
+        Mesh evenTriangles;
+        evenTriangles.Reserve(mesh.GetVertexCount(), (mesh.GetTriangleCount() + 1) / 2);
+
+        for (std::size_t vertex = 0; vertex < mesh.GetVertexCount(); vertex++)
+            evenTriangles.AddVertex({ mesh.GetPositionsX()[vertex], mesh.GetPositionsY()[vertex] });
+
+        const std::uint32_t* indices = mesh.GetIndices();
+
+        for (std::size_t triangle = 0; triangle < mesh.GetTriangleCount(); triangle += 2)
+            evenTriangles.AddTriangle(indices[triangle * 3], indices[triangle * 3 + 1], indices[triangle * 3 + 2]);
+
+        return evenTriangles;
+    };
+
+
+    static void FillMeshTriangle(Graphics& graphics, const Mesh& mesh, std::size_t triangle, const Colour& colour)
+    {
+        const float* x = mesh.GetPositionsX();
+        const float* y = mesh.GetPositionsY();
+
+        const std::uint32_t* indices = mesh.GetIndices() + triangle * 3;
+
+        graphics.FillTriangle({ x[indices[0]], y[indices[0]] },
+                              { x[indices[1]], y[indices[1]] },
+                              { x[indices[2]], y[indices[2]] },
+                              colour);
+    };
+
+
+    template<typename TPixelFunction>
+    static void ForEachPixel(Graphics& graphics, TPixelFunction&& pixelFunction)
+    {
+        for (int y = 0; y < FRAME_HEIGHT; y++)
+        {
+            for (int x = 0; x < FRAME_WIDTH; x++)
+                pixelFunction(graphics.GetPixel(x, y), static_cast<std::size_t>(y) * FRAME_WIDTH + x);
+        };
+    };
+
+
+    static int CountWrittenPixels(Graphics& graphics)
+    {
+        int count = 0;
+
+        ForEachPixel(graphics, [&](const Colour& pixel, std::size_t)
+        {
+            if (pixel.Alpha != 0)
+                count++;
+        });
+
+        return count;
+    };
+
+
+    /// <summary>
+    /// A colour that is different for every triangle, and never the cleared colour
+    /// </summary>
+    /// <param name="triangle"></param>
+    /// <returns></returns>
+    static Colour GetTriangleColour(std::size_t triangle)
+    {
+        return
+        {
+            static_cast<std::uint8_t>(triangle & 0xFF),
+            static_cast<std::uint8_t>((triangle >> 8) & 0xFF),
+            128,
+            255,
+        };
+    };
+
+    static bool IsSameColour(const Colour& left, const Colour& right)
+    {
+        return (left.Red == right.Red) &&
+               (left.Green == right.Green) &&
+               (left.Blue == right.Blue) &&
+               (left.Alpha == right.Alpha);
+    };
+
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <ostream>
+
+
+/// <summary>
+/// Collects the results of headless tests, every check is written as a line and failures are counted.
+/// Doesn't depend on Win32, so tests that only need it can be built on their own
+/// </summary>
+class TestReport
+{
+
+private:
+
+    std::ostream& _output;
+
+    int _checkCount = 0;
+    int _failureCount = 0;
+
+
+public:
+
+    TestReport(std::ostream& output) :
+        _output(output)
+    {
+    };
+
+
+public:
+
+    /// <summary>
+    /// Record a check
+    /// </summary>
+    /// <param name="passed"></param>
+    /// <param name="description"> What was expected </param>
+    /// <returns> passed </returns>
+    bool Check(bool passed, const char* description)
+    {
+        _checkCount++;
+
+        if (passed == false)
+            _failureCount++;
+
+        _output << (passed ? "  passed: " : "  FAILED: ") << description << '\n';
+
+        return passed;
+    };
+
+    /// <summary>
+    /// Start a group of checks
+    /// </summary>
+    /// <param name="name"></param>
+    void BeginTest(const char* name)
+    {
+        _output << name << '\n';
+    };
+
+    /// <summary>
+    /// Write how many checks ran and failed
+    /// </summary>
+    void WriteSummary()
+    {
+        _output << _checkCount << " checks, " << _failureCount << " failed\n";
+    };
+
+
+public:
+
+    int GetFailureCount() const
+    {
+        return _failureCount;
+    };
+
+};
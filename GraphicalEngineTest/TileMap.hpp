@@ -0,0 +1,526 @@
+#pragma once
+#include <Windows.h>
+#include <cstdint>
+#include <climits>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+
+/// <summary>
+/// Header of a binary tile map file, followed by the map's chunks in row-major order
+/// </summary>
+struct TileMapHeader
+{
+    char Magic[4] = { 'T', 'M', 'P', '1' };
+
+    std::uint32_t Width = 0;
+    std::uint32_t Height = 0;
+
+    /// <summary>
+    /// Width and height of a chunk in cells, must match TileMap::CHUNK_SIZE
+    /// </summary>
+    std::uint32_t ChunkSize = 0;
+};
+
+
+/// <summary>
+/// A grid of solid or empty cells, stored as bit-packed square chunks.
+/// A cell query is a couple of shifts and a single 64 bit load, and neighbouring cells share cache lines.
+/// Small maps are kept in memory, large ones can be memory-mapped straight from a binary map file
+/// so only the parts of the world that are actually looked at are paged in
+/// </summary>
+class TileMap
+{
+
+public:
+
+    /// <summary>
+    /// Log2 of CHUNK_SIZE
+    /// </summary>
+    static constexpr int CHUNK_SHIFT = 6;
+
+    /// <summary>
+    /// Width and height of a chunk in cells, a chunk row is exactly one 64 bit word
+    /// </summary>
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+
+    /// <summary>
+    /// The largest width or height, rounding it up to whole chunks must still fit in an int
+    /// </summary>
+    static constexpr int MAX_SIZE = INT_MAX - (CHUNK_SIZE - 1);
+
+    /// <summary>
+    /// A CHUNK_SIZE x CHUNK_SIZE block of cells, bit 'x' of row 'y' is set if cell (x, y) is solid
+    /// </summary>
+    struct Chunk
+    {
+        std::uint64_t Rows[CHUNK_SIZE];
+    };
+
+private:
+
+    int _width = 0;
+    int _height = 0;
+
+    /// <summary>
+    /// Number of chunks in a row and in a column of the map, the last ones can be partially outside the map
+    /// </summary>
+    int _chunksX = 0;
+    int _chunksY = 0;
+
+    /// <summary>
+    /// The chunks of a map that lives in memory
+    /// </summary>
+    std::vector<Chunk> _ownedChunks;
+
+    /// <summary>
+    /// Either _ownedChunks' data or the chunks inside a mapped file
+    /// </summary>
+    const Chunk* _chunks = nullptr;
+
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _fileMapping = NULL;
+    const void* _fileView = nullptr;
+
+    /// <summary>
+    /// Incremented every time the map's content changes
+    /// </summary>
+    std::uint64_t _version = 0;
+
+
+public:
+
+    TileMap() = default;
+
+    /// <summary>
+    /// Create an empty, in memory, map
+    /// </summary>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    TileMap(int width, int height)
+    {
+        Allocate(width, height);
+    };
+
+    TileMap(const TileMap&) = delete;
+    TileMap& operator = (const TileMap&) = delete;
+
+    TileMap(TileMap&& other) noexcept
+    {
+        *this = std::move(other);
+    };
+
+    TileMap& operator = (TileMap&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+
+            _width = other._width;
+            _height = other._height;
+            _chunksX = other._chunksX;
+            _chunksY = other._chunksY;
+            _ownedChunks = std::move(other._ownedChunks);
+            _chunks = other._chunks;
+            _file = other._file;
+            _fileMapping = other._fileMapping;
+            _fileView = other._fileView;
+
+            // The content was replaced, it's a change for anything that cached this map's or the other map's version
+            _version = (std::max)(_version, other._version) + 1;
+            other._version++;
+
+            other._width = 0;
+            other._height = 0;
+            other._chunksX = 0;
+            other._chunksY = 0;
+            other._chunks = nullptr;
+            other._file = INVALID_HANDLE_VALUE;
+            other._fileMapping = NULL;
+            other._fileView = nullptr;
+        };
+
+        return *this;
+    };
+
+    ~TileMap()
+    {
+        Close();
+    };
+
+
+public:
+
+    /// <summary>
+    /// Load a map from a text file, every line is a row of cells.
+    /// '#' or '1' is a solid cell, '.', '0' or a space is an empty one, short lines are padded with empty cells
+    /// </summary>
+    /// <param name="mapFile"></param>
+    void LoadFromTextFile(const std::wstring& mapFile)
+    {
+        std::ifstream file(mapFile);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to open tile map file");
+        };
+
+        std::vector<std::string> lines;
+        std::size_t width = 0;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if ((line.empty() == false) && (line.back() == '\r'))
+                line.pop_back();
+
+            width = (std::max)(width, line.size());
+            lines.push_back(std::move(line));
+        };
+
+        // Trailing empty lines aren't rows
+        while ((lines.empty() == false) && (lines.back().empty() == true))
+            lines.pop_back();
+
+        if ((width == 0) || (lines.empty() == true))
+        {
+            throw std::exception("Tile map file is empty");
+        };
+
+        Allocate(static_cast<int>(width), static_cast<int>(lines.size()));
+
+        for (int y = 0; y < _height; y++)
+        {
+            const std::string& row = lines[y];
+
+            for (int x = 0; x < static_cast<int>(row.size()); x++)
+            {
+                switch (row[x])
+                {
+                    case '#':
+                    case '1':
+                        SetSolid(x, y, true);
+                        break;
+
+                    case '.':
+                    case '0':
+                    case ' ':
+                        break;
+
+                    default:
+                        throw std::exception("Invalid cell in tile map file");
+                };
+            };
+        };
+    };
+
+
+    /// <summary>
+    /// Load a binary map file (see SaveToFile) into memory
+    /// </summary>
+    /// <param name="mapFile"></param>
+    void LoadFromFile(const std::wstring& mapFile)
+    {
+        std::ifstream file(mapFile, std::ios::binary | std::ios::ate);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to open tile map file");
+        };
+
+        const std::uint64_t fileSize = static_cast<std::uint64_t>(file.tellg());
+        file.seekg(0);
+
+        TileMapHeader header;
+
+        if (fileSize < sizeof(header))
+        {
+            throw std::exception("Invalid tile map file");
+        };
+
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        ValidateHeader(header, fileSize);
+
+        Allocate(static_cast<int>(header.Width), static_cast<int>(header.Height));
+
+        file.read(reinterpret_cast<char*>(_ownedChunks.data()), static_cast<std::streamsize>(_ownedChunks.size() * sizeof(Chunk)));
+    };
+
+
+    /// <summary>
+    /// Memory-map a binary map file (see SaveToFile).
+    /// Nothing is read up front, chunks are paged in by the OS the first time they are queried.
+    /// A mapped map is read only
+    /// </summary>
+    /// <param name="mapFile"></param>
+    void MapFile(const std::wstring& mapFile)
+    {
+        Close();
+
+        _file = CreateFileW(mapFile.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+
+        if (_file == INVALID_HANDLE_VALUE)
+        {
+            throw std::exception("Unable to open tile map file");
+        };
+
+        LARGE_INTEGER fileSize = { 0 };
+
+        if ((GetFileSizeEx(_file, &fileSize) == FALSE) ||
+            (static_cast<std::uint64_t>(fileSize.QuadPart) < sizeof(TileMapHeader)))
+        {
+            Close();
+            throw std::exception("Invalid tile map file");
+        };
+
+        _fileMapping = CreateFileMappingW(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if (_fileMapping == NULL)
+        {
+            Close();
+            throw std::exception("Unable to create a tile map file mapping");
+        };
+
+        _fileView = MapViewOfFile(_fileMapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (_fileView == nullptr)
+        {
+            Close();
+            throw std::exception("Unable to map tile map file");
+        };
+
+        const TileMapHeader& header = *static_cast<const TileMapHeader*>(_fileView);
+
+        try
+        {
+            ValidateHeader(header, static_cast<std::uint64_t>(fileSize.QuadPart));
+        }
+        catch (...)
+        {
+            Close();
+            throw;
+        };
+
+        SetSize(static_cast<int>(header.Width), static_cast<int>(header.Height));
+
+        // The header is 16 bytes, so the chunks are 8 byte aligned
+        _chunks = reinterpret_cast<const Chunk*>(static_cast<const char*>(_fileView) + sizeof(TileMapHeader));
+    };
+
+
+    /// <summary>
+    /// Write the map to a binary map file that can be loaded with LoadFromFile or MapFile
+    /// </summary>
+    /// <param name="mapFile"></param>
+    void SaveToFile(const std::wstring& mapFile) const
+    {
+        std::ofstream file(mapFile, std::ios::binary);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to create tile map file");
+        };
+
+        TileMapHeader header;
+        header.Width = static_cast<std::uint32_t>(_width);
+        header.Height = static_cast<std::uint32_t>(_height);
+        header.ChunkSize = CHUNK_SIZE;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(_chunks), static_cast<std::streamsize>(GetChunkCount() * sizeof(Chunk)));
+    };
+
+
+    /// <summary>
+    /// Unload the map, unmapping it's file if it was mapped
+    /// </summary>
+    void Close()
+    {
+        if (_fileView != nullptr)
+            UnmapViewOfFile(_fileView);
+
+        if (_fileMapping != NULL)
+            CloseHandle(_fileMapping);
+
+        if (_file != INVALID_HANDLE_VALUE)
+            CloseHandle(_file);
+
+        _fileView = nullptr;
+        _fileMapping = NULL;
+        _file = INVALID_HANDLE_VALUE;
+
+        _ownedChunks.clear();
+        _ownedChunks.shrink_to_fit();
+        _chunks = nullptr;
+
+        SetSize(0, 0);
+
+        _version++;
+    };
+
+
+public:
+
+    /// <summary>
+    /// Check if a cell is solid.
+    /// The cell must be inside the map, see IsInside
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <returns></returns>
+    bool IsSolid(int x, int y) const
+    {
+        const Chunk& chunk = _chunks[static_cast<std::size_t>(y >> CHUNK_SHIFT) * _chunksX + (x >> CHUNK_SHIFT)];
+
+        return ((chunk.Rows[y & (CHUNK_SIZE - 1)] >> (x & (CHUNK_SIZE - 1))) & 1) != 0;
+    };
+
+    bool IsInside(int x, int y) const
+    {
+        return (x >= 0) && (x < _width) &&
+               (y >= 0) && (y < _height);
+    };
+
+
+    /// <summary>
+    /// Make a cell solid or empty, only in memory maps can be changed
+    /// </summary>
+    /// <param name="x"></param>
+    /// <param name="y"></param>
+    /// <param name="solid"></param>
+    void SetSolid(int x, int y, bool solid)
+    {
+        if (IsReadOnly() == true)
+        {
+            throw std::exception("Tile map is read only");
+        };
+
+        if (IsInside(x, y) == false)
+        {
+            throw std::exception("Tile map cell is outside the map");
+        };
+
+        Chunk& chunk = _ownedChunks[static_cast<std::size_t>(y >> CHUNK_SHIFT) * _chunksX + (x >> CHUNK_SHIFT)];
+
+        const std::uint64_t bit = std::uint64_t(1) << (x & (CHUNK_SIZE - 1));
+
+        if (solid == true)
+            chunk.Rows[y & (CHUNK_SIZE - 1)] |= bit;
+        else
+            chunk.Rows[y & (CHUNK_SIZE - 1)] &= ~bit;
+
+        _version++;
+    };
+
+
+    /// <summary>
+    /// Make every cell empty
+    /// </summary>
+    void Clear()
+    {
+        if (IsReadOnly() == true)
+        {
+            throw std::exception("Tile map is read only");
+        };
+
+        std::fill(_ownedChunks.begin(), _ownedChunks.end(), Chunk { });
+
+        _version++;
+    };
+
+
+    int GetWidth() const
+    {
+        return _width;
+    };
+
+    int GetHeight() const
+    {
+        return _height;
+    };
+
+    /// <summary>
+    /// Get a number that changes every time the map's content changes, so caches built from the map can tell when they are outdated
+    /// </summary>
+    /// <returns></returns>
+    std::uint64_t GetVersion() const
+    {
+        return _version;
+    };
+
+    /// <summary>
+    /// Returns true if the map is memory-mapped from a file
+    /// </summary>
+    /// <returns></returns>
+    bool IsReadOnly() const
+    {
+        return _fileView != nullptr;
+    };
+
+
+private:
+
+    std::size_t GetChunkCount() const
+    {
+        return static_cast<std::size_t>(_chunksX) * static_cast<std::size_t>(_chunksY);
+    };
+
+    void SetSize(int width, int height)
+    {
+        _width = width;
+        _height = height;
+
+        _chunksX = (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+        _chunksY = (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    };
+
+    /// <summary>
+    /// Replace the map with an empty, in memory, one
+    /// </summary>
+    /// <param name="width"></param>
+    /// <param name="height"></param>
+    void Allocate(int width, int height)
+    {
+        if ((width <= 0) || (height <= 0) || (width > MAX_SIZE) || (height > MAX_SIZE))
+        {
+            throw std::exception("Invalid tile map size");
+        };
+
+        Close();
+        SetSize(width, height);
+
+        _ownedChunks.resize(GetChunkCount(), Chunk { });
+        _chunks = _ownedChunks.data();
+    };
+
+
+    /// <summary>
+    /// Make sure a binary map's header is valid and that the file holds all of it's chunks
+    /// </summary>
+    /// <param name="header"></param>
+    /// <param name="fileSize"></param>
+    static void ValidateHeader(const TileMapHeader& header, std::uint64_t fileSize)
+    {
+        const TileMapHeader expected;
+
+        if ((std::equal(std::begin(header.Magic), std::end(header.Magic), std::begin(expected.Magic)) == false) ||
+            (header.ChunkSize != CHUNK_SIZE) ||
+            (header.Width == 0) || (header.Height == 0) ||
+            (header.Width > MAX_SIZE) || (header.Height > MAX_SIZE))
+        {
+            throw std::exception("Invalid tile map file");
+        };
+
+        const std::uint64_t chunksX = (static_cast<std::uint64_t>(header.Width) + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+        const std::uint64_t chunksY = (static_cast<std::uint64_t>(header.Height) + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+
+        if (fileSize < sizeof(TileMapHeader) + chunksX * chunksY * sizeof(Chunk))
+        {
+            throw std::exception("Tile map file is truncated");
+        };
+    };
+
+};
@@ -0,0 +1,174 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Sprite.hpp"
+#include "Colour.hpp"
+
+
+/// <summary>
+/// A square wall texture for column renderers.
+/// Texels are stored column-major, so drawing a wall column reads the texture sequentially,
+/// and a full mip chain is kept so far (small) walls sample a small level that stays in cache.
+/// Floors and ceilings use the same textures, sampled a row at a time through GetMipLevel
+/// </summary>
+class WallTexture
+{
+
+public:
+
+    /// <summary>
+    /// The width and height of the largest mip level, must be a power of 2
+    /// </summary>
+    static constexpr int SIZE = 64;
+
+    /// <summary>
+    /// Log2 of SIZE, level 'a' is (SIZE_SHIFT - a) bits wide on each axis
+    /// </summary>
+    static constexpr int SIZE_SHIFT = 6;
+
+    static_assert((1 << SIZE_SHIFT) == SIZE, "SIZE_SHIFT must match SIZE");
+
+    /// <summary>
+    /// Number of mip levels, from SIZE down to 1x1
+    /// </summary>
+    static constexpr int MIP_LEVEL_COUNT = 7;
+
+private:
+
+    /// <summary>
+    /// Every mip level, level 'a' is (SIZE >> a) texels wide and high
+    /// </summary>
+    std::vector<Colour> _mipLevels[MIP_LEVEL_COUNT];
+
+
+public:
+
+    /// <summary>
+    /// Create a texture from a rectangle of a sprite (an atlas), the rectangle is resampled to SIZE x SIZE
+    /// </summary>
+    /// <param name="sprite"></param>
+    /// <param name="sourceX"></param>
+    /// <param name="sourceY"></param>
+    /// <param name="sourceWidth"></param>
+    /// <param name="sourceHeight"></param>
+    WallTexture(const Sprite& sprite,
+                int sourceX, int sourceY,
+                int sourceWidth, int sourceHeight)
+    {
+        if ((sourceX < 0) || (sourceY < 0) ||
+            (sourceWidth <= 0) || (sourceHeight <= 0) ||
+            (sourceX + sourceWidth > sprite.Width) ||
+            (sourceY + sourceHeight > sprite.Height))
+        {
+            throw std::exception("Wall texture rectangle is outside the sprite");
+        };
+
+        std::vector<Colour>& baseLevel = _mipLevels[0];
+        baseLevel.resize(static_cast<std::size_t>(SIZE) * SIZE);
+
+        for (int x = 0; x < SIZE; x++)
+        {
+            for (int y = 0; y < SIZE; y++)
+            {
+                baseLevel[static_cast<std::size_t>(x) * SIZE + y] = sprite.GetPixel(sourceX + (x * sourceWidth) / SIZE,
+                                                                                    sourceY + (y * sourceHeight) / SIZE);
+            };
+        };
+
+        GenerateMipLevels();
+    };
+
+
+public:
+
+    /// <summary>
+    /// Get a single column of a mip level, the column is (SIZE >> mipLevel) texels long
+    /// </summary>
+    /// <param name="mipLevel"></param>
+    /// <param name="u"> Horizontal texture coordinate in the range [0, 1) </param>
+    /// <returns></returns>
+    const Colour* GetColumn(int mipLevel, float u) const
+    {
+        const int levelSize = SIZE >> mipLevel;
+
+        // Wrap, the level size is a power of 2
+        const int column = static_cast<int>(u * levelSize) & (levelSize - 1);
+
+        return _mipLevels[mipLevel].data() + static_cast<std::size_t>(column) * levelSize;
+    };
+
+
+    /// <summary>
+    /// Get every texel of a mip level, texel (u, v) is at index (u << (SIZE_SHIFT - mipLevel)) | v
+    /// </summary>
+    /// <param name="mipLevel"></param>
+    /// <returns></returns>
+    const Colour* GetMipLevel(int mipLevel) const
+    {
+        return _mipLevels[mipLevel].data();
+    };
+
+
+    /// <summary>
+    /// Pick the mip level for a wall that is projected 'projectedHeight' pixels high on screen.
+    /// Chooses the smallest level that still has at least one texel per screen pixel
+    /// </summary>
+    /// <param name="projectedHeight"></param>
+    /// <returns></returns>
+    static int SelectMipLevel(float projectedHeight)
+    {
+        int mipLevel = 0;
+
+        while ((mipLevel < MIP_LEVEL_COUNT - 1) &&
+               static_cast<float>(SIZE >> (mipLevel + 1)) >= projectedHeight)
+            mipLevel++;
+
+        return mipLevel;
+    };
+
+    static int GetMipLevelSize(int mipLevel)
+    {
+        return SIZE >> mipLevel;
+    };
+
+
+private:
+
+    /// <summary>
+    /// Build every level after the first with a 2x2 box filter
+    /// </summary>
+    void GenerateMipLevels()
+    {
+        for (int level = 1; level < MIP_LEVEL_COUNT; level++)
+        {
+            const std::vector<Colour>& source = _mipLevels[level - 1];
+            std::vector<Colour>& destination = _mipLevels[level];
+
+            const int sourceSize = SIZE >> (level - 1);
+            const int size = SIZE >> level;
+
+            destination.resize(static_cast<std::size_t>(size) * size);
+
+            for (int x = 0; x < size; x++)
+            {
+                for (int y = 0; y < size; y++)
+                {
+                    // The 4 source texels, column-major
+                    const Colour& texel0 = source[static_cast<std::size_t>(x * 2) * sourceSize + (y * 2)];
+                    const Colour& texel1 = source[static_cast<std::size_t>(x * 2) * sourceSize + (y * 2 + 1)];
+                    const Colour& texel2 = source[static_cast<std::size_t>(x * 2 + 1) * sourceSize + (y * 2)];
+                    const Colour& texel3 = source[static_cast<std::size_t>(x * 2 + 1) * sourceSize + (y * 2 + 1)];
+
+                    Colour& texel = destination[static_cast<std::size_t>(x) * size + y];
+
+                    texel.Red = static_cast<std::uint8_t>((texel0.Red + texel1.Red + texel2.Red + texel3.Red + 2) / 4);
+                    texel.Green = static_cast<std::uint8_t>((texel0.Green + texel1.Green + texel2.Green + texel3.Green + 2) / 4);
+                    texel.Blue = static_cast<std::uint8_t>((texel0.Blue + texel1.Blue + texel2.Blue + texel3.Blue + 2) / 4);
+                    texel.Alpha = static_cast<std::uint8_t>((texel0.Alpha + texel1.Alpha + texel2.Alpha + texel3.Alpha + 2) / 4);
+                };
+            };
+        };
+    };
+
+};
\ No newline at end of file
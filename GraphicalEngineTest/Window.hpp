@@ -9,6 +9,7 @@
 #include "Vector2D.hpp"
 #include "WindowsUtilities.hpp"
 #include "Keyboard.hpp"
+#include "InputRecording.hpp"
 
 
 /// <summary>
@@ -65,6 +66,16 @@ private:
     /// </summary>
     bool _mouseHidden = false;
 
+    /// <summary>
+    /// If set, every input the window receives is also written to this recorder
+    /// </summary>
+    InputRecorder* _inputRecorder = nullptr;
+
+    /// <summary>
+    /// If set, input comes from this player and real keyboard/mouse input is ignored
+    /// </summary>
+    InputPlayer* _inputPlayer = nullptr;
+
 public:
 
     Window(int windowWidth, int windowHeight,
@@ -110,6 +121,9 @@ public:
         // Windows message loop
         MSG message;
 
+        if (_inputRecorder != nullptr)
+            _inputRecorder->BeginFrame();
+
         // Process available messages
         while (PeekMessageW(&message, NULL, 0, 0, PM_REMOVE))
         {
@@ -127,9 +141,16 @@ public:
         };
 
         // Handle mouse and keybaord *key* events independently from window events
-        HandleMouseEvents();
+        if (_inputPlayer != nullptr)
+            _inputPlayer->PlayFrame(_keyboard, _mouse);
+        else
+            HandleMouseEvents();
+
         HandleKeyboardEvents();
 
+        if (_inputRecorder != nullptr)
+            _inputRecorder->RecordMouseState(_mouse);
+
 
         // Confine the mouse is requested
         if (_mouseConfined == true)
@@ -193,6 +214,27 @@ public:
     };
 
 
+    /// <summary>
+    /// Start recording input, pass null to stop.
+    /// The recorder must outlive the recording
+    /// </summary>
+    /// <param name="inputRecorder"></param>
+    void SetInputRecorder(InputRecorder* inputRecorder)
+    {
+        _inputRecorder = inputRecorder;
+    };
+
+    /// <summary>
+    /// Replace real input with a recorded input log, pass null to go back to real input.
+    /// The player must outlive the replay
+    /// </summary>
+    /// <param name="inputPlayer"></param>
+    void SetInputPlayer(InputPlayer* inputPlayer)
+    {
+        _inputPlayer = inputPlayer;
+    };
+
+
 public:
 
     HWND GetHWND()
@@ -274,6 +316,16 @@ private:
     /// <returns></returns>
     LRESULT CALLBACK WindowProcedure(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
     {
+        // While replaying, real input is dropped so it can't interfere with the recording
+        if ((_inputPlayer != nullptr) &&
+            (IsInputMessage(msg) == true))
+        {
+            if (msg == WM_SYSKEYDOWN || msg == WM_SYSKEYUP)
+                return DefWindowProcW(hwnd, msg, wParam, lParam);
+
+            return 0;
+        };
+
         switch (msg)
         {
             case WM_MOUSEMOVE:
@@ -318,6 +370,9 @@ private:
                 {
                     RAWMOUSE rawMouse = rawInput.data.mouse;
 
+                    if (_inputRecorder != nullptr)
+                        _inputRecorder->RecordRawMouseMoved(rawMouse.lLastX, rawMouse.lLastY);
+
                     // Invoke raw mouse moved event
                     _mouse.OnMouseRawMoved(rawMouse.lLastX, rawMouse.lLastY);
                 };
@@ -332,32 +387,65 @@ private:
             };
 
 
-            // Even though we handle keyboard inputs in HandleKeyboardEvents function 
-            // I'm handling WM_KEYDOWN just for the Text auto repeat
+            // Key transitions are queued here and applied once per frame in HandleKeyboardEvents
             case WM_KEYDOWN:
+            case WM_SYSKEYDOWN:
             {
                 // Check if key is requesting auto repeat, by getting the value of the 30th bit
                 bool isKeyHeld = std::bitset<sizeof(LPARAM) * 8>(lParam).test(30);
 
                 int keycode = static_cast<int>(wParam);
 
+                // Auto repeat isn't a new transition, the key is already down
                 if (isKeyHeld == true)
-                    _keyboard._keys[keycode].TextAutoRepeat = true;
+                {
+                    if (keycode < Keyboard::NUMBER_OF_KEYS)
+                        _keyboard._keys[keycode].TextAutoRepeat = true;
+                }
+                else
+                {
+                    if (_inputRecorder != nullptr)
+                        _inputRecorder->RecordKeyDown(keycode);
+
+                    _keyboard.OnKeyDown(keycode);
+                };
+
+                // Let Windows handle system keys (Alt+F4 and such)
+                if (msg == WM_SYSKEYDOWN)
+                    break;
 
                 return 0;
             };
 
 
             case WM_KEYUP:
+            case WM_SYSKEYUP:
             {
                 int keycode = static_cast<int>(wParam);
 
-                _keyboard._keys[keycode].TextAutoRepeat = false;
+                if (_inputRecorder != nullptr)
+                    _inputRecorder->RecordKeyUp(keycode);
+
+                _keyboard.OnKeyUp(keycode);
+
+                if (msg == WM_SYSKEYUP)
+                    break;
 
                 return 0;
             };
 
 
+            // Key up messages won't arrive while the window isn't focused
+            case WM_KILLFOCUS:
+            {
+                if (_inputRecorder != nullptr)
+                    _inputRecorder->RecordReleaseAllKeys();
+
+                _keyboard.ReleaseAllKeys();
+                return 0;
+            };
+
+
             case WM_CLOSE:
             {
                 PostQuitMessage(0);
@@ -409,6 +497,9 @@ private:
             {
                 const int mouseWheelDelta = GET_WHEEL_DELTA_WPARAM(wParam);
 
+                if (_inputRecorder != nullptr)
+                    _inputRecorder->RecordMouseWheel(mouseWheelDelta);
+
                 _mouse._mouseWheenEvent(mouseWheelDelta);
                 return 0;
             };
@@ -494,31 +585,12 @@ private:
 
 
     /// <summary>
-    /// Handles user keyboard input 
+    /// Handles user keyboard input.
+    /// Applies the key transitions that were queued by the window procedure since the last frame
     /// </summary>
     void HandleKeyboardEvents()
     {
-        // Check if window is in focus
-        bool windowInFocus = GetFocus() == _hwnd;
-
-        // Don't update keys if window isn't currently focused
-        if (windowInFocus == false)
-        {
-            for (int a = 0; a < Keyboard::NUMBER_OF_KEYS; a++)
-                _keyboard._keys[a].KeyState = KeyState::None;
-
-            return;
-        };
-
-
-        // Update keys 
-        for (int a = 0; a < Keyboard::NUMBER_OF_KEYS; a++)
-        {
-            Key& key = _keyboard._keys[a];
-
-            key.KeyState = GetNewKeyState(key.Key, key.KeyState);
-        };
-
+        _keyboard.Update();
     };
 
 
@@ -567,6 +639,31 @@ private:
     };
 
 
+    /// <summary>
+    /// Returns true if a window message carries keyboard or mouse input
+    /// </summary>
+    /// <param name="msg"></param>
+    /// <returns></returns>
+    static bool IsInputMessage(UINT msg)
+    {
+        switch (msg)
+        {
+            case WM_MOUSEMOVE:
+            case WM_MOUSELEAVE:
+            case WM_MOUSEWHEEL:
+            case WM_INPUT:
+            case WM_KEYDOWN:
+            case WM_KEYUP:
+            case WM_SYSKEYDOWN:
+            case WM_SYSKEYUP:
+            case WM_KILLFOCUS:
+                return true;
+        };
+
+        return false;
+    };
+
+
     void RegisterDevices()
     {
         RegisterRawMouse();
@@ -0,0 +1,217 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <type_traits>
+
+
+/// <summary>
+/// A fixed set of worker threads that split index ranges between them.
+/// The calling thread takes part in the work, so a pool of N threads starts N - 1 workers.
+/// Every participant has a stable thread index in the range [0, GetThreadCount()), index 0 is the calling thread,
+/// which makes it easy to pair each thread with it's own scratch memory (see FrameArena::GetThreadArena)
+/// </summary>
+class WorkerPool
+{
+
+private:
+
+    /// <summary>
+    /// Type erased job, invoked as (context, begin, end, threadIndex)
+    /// </summary>
+    using JobFunction = void(*)(void*, int, int, std::size_t);
+
+private:
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+
+    /// <summary>
+    /// Signaled when a new job is posted, or when the pool is shutting down
+    /// </summary>
+    std::condition_variable _workAvailable;
+
+    /// <summary>
+    /// Signaled when the last worker finished the current job
+    /// </summary>
+    std::condition_variable _workDone;
+
+    JobFunction _jobFunction = nullptr;
+    void* _jobContext = nullptr;
+
+    int _jobEnd = 0;
+    int _chunkSize = 1;
+
+    /// <summary>
+    /// The next index of the current job that wasn't claimed yet
+    /// </summary>
+    std::atomic<int> _nextIndex = 0;
+
+    /// <summary>
+    /// Incremented for every posted job, workers use it to tell a new job from a spurious wake up
+    /// </summary>
+    std::size_t _jobGeneration = 0;
+
+    /// <summary>
+    /// Number of workers that didn't finish the current job yet
+    /// </summary>
+    std::size_t _busyWorkers = 0;
+
+    bool _stopping = false;
+
+
+public:
+
+    /// <summary>
+    /// </summary>
+    /// <param name="threadCount"> Total number of threads including the caller </param>
+    WorkerPool(std::size_t threadCount)
+    {
+        const std::size_t workerCount = (threadCount > 1) ? (threadCount - 1) : 0;
+
+        _workers.reserve(workerCount);
+
+        for (std::size_t a = 0; a < workerCount; a++)
+            _workers.emplace_back(&WorkerPool::WorkerLoop, this, a + 1);
+    };
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator = (const WorkerPool&) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+
+        _workAvailable.notify_all();
+
+        for (std::thread& worker : _workers)
+            worker.join();
+    };
+
+
+public:
+
+    /// <summary>
+    /// Split [begin, end) into chunks and run them on every thread of the pool, returns once all chunks are done.
+    /// The function is called as function(chunkBegin, chunkEnd, threadIndex) and must not throw
+    /// </summary>
+    /// <typeparam name="TFunction"></typeparam>
+    /// <param name="begin"></param>
+    /// <param name="end"></param>
+    /// <param name="chunkSize"> Number of indices a thread claims at a time </param>
+    /// <param name="function"></param>
+    template<class TFunction>
+    void ParallelFor(int begin, int end, int chunkSize, TFunction&& function)
+    {
+        if (begin >= end)
+            return;
+
+        chunkSize = (std::max)(chunkSize, 1);
+
+        // Not worth waking anyone up
+        if ((_workers.empty() == true) ||
+            (end - begin <= chunkSize))
+        {
+            function(begin, end, 0);
+            return;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // The function lives on the caller's stack, which outlives the job because we wait for it below
+            _jobFunction = [](void* context, int chunkBegin, int chunkEnd, std::size_t threadIndex)
+            {
+                (*static_cast<std::remove_reference_t<TFunction>*>(context))(chunkBegin, chunkEnd, threadIndex);
+            };
+
+            _jobContext = const_cast<void*>(static_cast<const void*>(&function));
+            _jobEnd = end;
+            _chunkSize = chunkSize;
+            _nextIndex.store(begin, std::memory_order_relaxed);
+
+            _busyWorkers = _workers.size();
+            _jobGeneration++;
+        }
+
+        _workAvailable.notify_all();
+
+        RunChunks(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _workDone.wait(lock, [this]()
+        {
+            return _busyWorkers == 0;
+        });
+    };
+
+
+    /// <summary>
+    /// Get the number of threads that take part in a job, including the caller
+    /// </summary>
+    /// <returns></returns>
+    std::size_t GetThreadCount() const
+    {
+        return _workers.size() + 1;
+    };
+
+
+private:
+
+    /// <summary>
+    /// Claim and run chunks of the current job until there are none left
+    /// </summary>
+    /// <param name="threadIndex"></param>
+    void RunChunks(std::size_t threadIndex)
+    {
+        while (true)
+        {
+            const int chunkBegin = _nextIndex.fetch_add(_chunkSize, std::memory_order_relaxed);
+
+            if (chunkBegin >= _jobEnd)
+                return;
+
+            _jobFunction(_jobContext, chunkBegin, (std::min)(chunkBegin + _chunkSize, _jobEnd), threadIndex);
+        };
+    };
+
+    void WorkerLoop(std::size_t threadIndex)
+    {
+        std::size_t lastGeneration = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                _workAvailable.wait(lock, [&]()
+                {
+                    return (_stopping == true) || (_jobGeneration != lastGeneration);
+                });
+
+                if (_stopping == true)
+                    return;
+
+                lastGeneration = _jobGeneration;
+            }
+
+            RunChunks(threadIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                if (--_busyWorkers == 0)
+                    _workDone.notify_one();
+            }
+        };
+    };
+
+};
\ No newline at end of file
@@ -1,9 +1,17 @@
 #include <Windows.h>
+#include <shellapi.h>
 #include <chrono>
 #include <cmath>
 #include <vector>
 #include <string>
 #include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <cstdio>
+#include <new>
+#include <memory>
+#include <fstream>
+#include <algorithm>
 
 #include "Window.hpp"
 #include "Graphics.hpp"
@@ -16,9 +24,23 @@
 #include "LightTestScene.hpp"
 #include "RasterScene.hpp"
 
+#include "SDFFontGenerator.hpp"
+#include "FrameArena.hpp"
+#include "InputRecording.hpp"
+#include "RasterBenchmark.hpp"
+#include "TestReport.hpp"
+#include "KeyboardTests.hpp"
+#include "MathsTests.hpp"
+#include "RasterizerTests.hpp"
+
 int windowWidth = 800;
 int windowHeight = 600;
 
+/// <summary>
+/// The delta time scenes are updated with while input is recorded or replayed, so both runs step the scenes identically
+/// </summary>
+constexpr float FIXED_DELTA_TIME = 1.0f / 60.0f;
+
 Window* window = nullptr;
 
 
@@ -27,6 +49,34 @@ std::vector<IScene*> scenes;
 std::vector<IScene*>::iterator currentScene;
 
 
+#ifdef _DEBUG
+
+// Replace the global operator new so we can count heap allocations,
+// anything transient should come from the frame arena instead and the per-frame count should stay at 0
+
+void* operator new(std::size_t size)
+{
+    HeapAllocationCounter::Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+};
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+};
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+};
+
+#endif
+
+
 
 /// <summary>
 /// Cycle between available scenes
@@ -79,7 +129,7 @@ void DrawFrame(float deltaTime)
 };
 
 
-void ShowFPS(float& elapsedFramesSeconds, int& elapsedFrames)
+void ShowFPS(float& elapsedFramesSeconds, int& elapsedFrames, std::size_t frameHeapAllocations)
 {
     // If enough time has elapsed...
     if (elapsedFramesSeconds > 0.7f)
@@ -89,7 +139,12 @@ void ShowFPS(float& elapsedFramesSeconds, int& elapsedFrames)
 
         // Format the FPS into a string
         wchar_t str[127];
+
+        #ifdef _DEBUG
+        std::swprintf(str, 127, L"FPS: %.2f | Heap allocations per frame: %zu", fps, frameHeapAllocations);
+        #else
         std::swprintf(str, 127, L"FPS: %.2f", fps);
+        #endif
 
         // Show the fps
         SetWindowTextW(window->GetHWND(), str);
@@ -100,8 +155,263 @@ void ShowFPS(float& elapsedFramesSeconds, int& elapsedFrames)
 };
 
 
+/// <summary>
+/// Parse a command line argument that must be a positive whole number
+/// </summary>
+/// <param name="argument"></param>
+/// <param name="value"></param>
+/// <returns> False if the argument isn't a number, has anything after the number, or isn't positive </returns>
+bool TryParsePositiveInteger(const wchar_t* argument, int& value)
+{
+    wchar_t* end = nullptr;
+    const long parsed = std::wcstol(argument, &end, 10);
+
+    if ((end == argument) || (*end != L'\0') || (parsed <= 0) || (parsed > INT_MAX))
+        return false;
+
+    value = static_cast<int>(parsed);
+
+    return true;
+};
+
+
+/// <summary>
+/// Runs offline tools requested from the command line.
+/// Returns true if a tool was run, in which case the application should exit without creating a window
+/// </summary>
+/// <param name="commandLine"></param>
+/// <param name="exitCode"> The code the application should exit with, set if a tool was run </param>
+/// <returns></returns>
+bool RunCommandLineTools(LPWSTR commandLine, int& exitCode)
+{
+    int argumentCount = 0;
+    LPWSTR* arguments = CommandLineToArgvW(commandLine, &argumentCount);
+
+    if (arguments == nullptr)
+        return false;
+
+    bool toolRan = false;
+
+    exitCode = 0;
+
+    // Convert a font bitmap into a distance field atlas:
+    // --generate-sdf <font.bmp> <glyph width> <glyph height> <output.sdf>
+    if (argumentCount == 5 &&
+        std::wcscmp(arguments[0], L"--generate-sdf") == 0)
+    {
+        int glyphWidth = 0;
+        int glyphHeight = 0;
+
+        if ((TryParsePositiveInteger(arguments[2], glyphWidth) == false) ||
+            (TryParsePositiveInteger(arguments[3], glyphHeight) == false))
+        {
+            MessageBoxW(NULL,
+                        L"Usage: --generate-sdf <font.bmp> <glyph width> <glyph height> <output.sdf>\n"
+                        L"The glyph width and height must be positive whole numbers",
+                        L"Invalid arguments", MB_ICONERROR);
+
+            exitCode = 1;
+        }
+        else
+        {
+            // Loading, generating and saving all throw on failure, there's no window to catch them so they're reported here
+            try
+            {
+                // The sprite loader doesn't touch the device, so an un-initialized Graphics is enough here
+                Graphics graphics(0, 0);
+
+                SDFAtlas atlas = SDFFontGenerator::GenerateFromFile(graphics, arguments[1], glyphWidth, glyphHeight);
+
+                SDFFontGenerator::SaveToFile(atlas, arguments[4]);
+            }
+            catch (const std::exception& exception)
+            {
+                // The messages are plain ASCII, so widening every character is enough
+                const std::string message = exception.what();
+
+                MessageBoxW(NULL, std::wstring(message.begin(), message.end()).c_str(), L"SDF generation failed", MB_ICONERROR);
+
+                exitCode = 1;
+            };
+        };
+
+        toolRan = true;
+    };
+
+    // Measure how the parallel mesh rasterizer scales with the number of threads:
+    // --benchmark-raster <results.txt>
+    if (argumentCount == 2 &&
+        std::wcscmp(arguments[0], L"--benchmark-raster") == 0)
+    {
+        RasterBenchmark::Run(arguments[1]);
+
+        toolRan = true;
+    };
+
+    // Run the headless tests, the exit code is the number of failed checks:
+    // --run-tests <results.txt>
+    if (argumentCount == 2 &&
+        std::wcscmp(arguments[0], L"--run-tests") == 0)
+    {
+        std::ofstream file(arguments[1]);
+
+        if (file.is_open() == false)
+        {
+            throw std::exception("Unable to create test results file");
+        };
+
+        TestReport report(file);
+
+        KeyboardTests::Run(report);
+        MathsTests::Run(report);
+        RasterizerTests::Run(report);
+
+        report.WriteSummary();
+
+        exitCode = report.GetFailureCount();
+
+        toolRan = true;
+    };
+
+    LocalFree(arguments);
+
+    return toolRan;
+};
+
+
+/// <summary>
+/// Options that change how the main loop runs
+/// </summary>
+struct LaunchOptions
+{
+    /// <summary>
+    /// If not empty, input is recorded to this file
+    /// </summary>
+    std::wstring RecordFile;
+
+    /// <summary>
+    /// If not empty, input is replayed from this file
+    /// </summary>
+    std::wstring ReplayFile;
+
+    /// <summary>
+    /// Where the frame times and hashes of a replay are written
+    /// </summary>
+    std::wstring ResultsFile;
+};
+
+
+/// <summary>
+/// Parse the launch options from the command line:
+/// --record <input.log>
+/// --replay <input.log> [results.txt]
+/// </summary>
+/// <param name="commandLine"></param>
+/// <returns></returns>
+LaunchOptions ParseLaunchOptions(LPWSTR commandLine)
+{
+    LaunchOptions options;
+
+    if ((commandLine == nullptr) ||
+        (*commandLine == L'\0'))
+        return options;
+
+    int argumentCount = 0;
+    LPWSTR* arguments = CommandLineToArgvW(commandLine, &argumentCount);
+
+    if (arguments == nullptr)
+        return options;
+
+    if (argumentCount >= 2 &&
+        std::wcscmp(arguments[0], L"--record") == 0)
+    {
+        options.RecordFile = arguments[1];
+    }
+    else if (argumentCount >= 2 &&
+             std::wcscmp(arguments[0], L"--replay") == 0)
+    {
+        options.ReplayFile = arguments[1];
+
+        if (argumentCount >= 3)
+            options.ResultsFile = arguments[2];
+        else
+            options.ResultsFile = options.ReplayFile + L".results.txt";
+    };
+
+    LocalFree(arguments);
+
+    return options;
+};
+
+
+/// <summary>
+/// Write the per-frame times and hashes of a replay, followed by a summary.
+/// 2 runs of the same log rendered the same frames if their final hashes match
+/// </summary>
+/// <param name="resultsFile"></param>
+/// <param name="frameTimes"> The time each frame took, in seconds </param>
+/// <param name="frameHashes"></param>
+void WriteReplayResults(const std::wstring& resultsFile, const std::vector<float>& frameTimes, const std::vector<std::uint64_t>& frameHashes)
+{
+    std::ofstream file(resultsFile);
+
+    if (file.is_open() == false)
+    {
+        throw std::exception("Unable to create replay results file");
+    };
+
+    if (frameTimes.empty() == true)
+        return;
+
+    char line[128];
+
+    float totalTime = 0.0f;
+
+    // Combine every frame's hash into a single value
+    std::uint64_t replayHash = 14695981039346656037ull;
+
+    for (std::size_t a = 0; a < frameTimes.size(); a++)
+    {
+        totalTime += frameTimes[a];
+
+        replayHash ^= frameHashes[a];
+        replayHash *= 1099511628211ull;
+
+        std::snprintf(line, sizeof(line), "frame %zu: %.3f ms, hash %016llx\n", a, frameTimes[a] * 1000.0f, frameHashes[a]);
+        file << line;
+    };
+
+    std::vector<float> sortedFrameTimes = frameTimes;
+    std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+
+    const float medianTime = sortedFrameTimes[sortedFrameTimes.size() / 2];
+    const float worstTime = sortedFrameTimes.back();
+
+    std::snprintf(line, sizeof(line), "frames: %zu, average: %.3f ms, median: %.3f ms, worst: %.3f ms, hash: %016llx\n",
+                  frameTimes.size(),
+                  (totalTime / frameTimes.size()) * 1000.0f,
+                  medianTime * 1000.0f,
+                  worstTime * 1000.0f,
+                  replayHash);
+
+    file << line;
+
+    OutputDebugStringA(line);
+};
+
+
 int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPWSTR lpCmdLine, _In_ int nShowCmd)
 {
+    // Offline tools don't need a window
+    int toolExitCode = 0;
+
+    if ((lpCmdLine != nullptr) &&
+        (*lpCmdLine != L'\0') &&
+        (RunCommandLineTools(lpCmdLine, toolExitCode) == true))
+        return toolExitCode;
+
+    const LaunchOptions launchOptions = ParseLaunchOptions(lpCmdLine);
+
     // Registered name of this window
     const wchar_t* windowClassName = L"DirectXWindow";
 
@@ -129,6 +439,35 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     currentScene = scenes.end() - 1;
 
 
+    // Input recording and replay
+    std::unique_ptr<InputRecorder> inputRecorder;
+    std::unique_ptr<InputPlayer> inputPlayer;
+
+    // Per-frame results of a replay, allocated up front so the measurement doesn't allocate
+    std::vector<float> replayFrameTimes;
+    std::vector<std::uint64_t> replayFrameHashes;
+
+    if (launchOptions.RecordFile.empty() == false)
+    {
+        inputRecorder = std::make_unique<InputRecorder>(static_cast<std::uint32_t>(currentScene - scenes.begin()), FIXED_DELTA_TIME);
+        window->SetInputRecorder(inputRecorder.get());
+    }
+    else if (launchOptions.ReplayFile.empty() == false)
+    {
+        inputPlayer = std::make_unique<InputPlayer>(launchOptions.ReplayFile);
+
+        if (inputPlayer->GetStartingScene() >= scenes.size())
+            throw std::exception("Input log starts in a scene that doesn't exist");
+
+        currentScene = scenes.begin() + inputPlayer->GetStartingScene();
+
+        replayFrameTimes.reserve(inputPlayer->GetFrameCount());
+        replayFrameHashes.reserve(inputPlayer->GetFrameCount());
+
+        window->SetInputPlayer(inputPlayer.get());
+    };
+
+
     // Show the window
     window->ShowWindow();
 
@@ -150,6 +489,9 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     // Counter for elapsed seconds, used to check if enough time has passed to show FPS
     float elapsedFramesSeconds = 0;
 
+    // Number of global heap allocations made during the previous frame
+    std::size_t frameHeapAllocations = 0;
+
     while (window->ProcessMessageBuffer())
     {
         // Set up elpased time and frames
@@ -160,20 +502,55 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         // Restart the clock
         beginning = std::chrono::system_clock::now();
 
+        HeapAllocationCounter::BeginFrame();
+
         // Clear the frame before drawing again
         graphics->ClearFrame();
 
         // Display frames per second
-        ShowFPS(elapsedFramesSeconds, elapsedFrames);
+        ShowFPS(elapsedFramesSeconds, elapsedFrames, frameHeapAllocations);
 
-        // Draw frame function, should be only responsible for drawing, and simple branching logic
-        DrawFrame(elapedTime.count());
+        // Recorded and replayed runs are stepped with a fixed delta time so they stay in sync
+        if (inputRecorder != nullptr)
+            DrawFrame(inputRecorder->GetFixedDeltaTime());
+        else if (inputPlayer != nullptr)
+            DrawFrame(inputPlayer->GetFixedDeltaTime());
+        else
+            // Draw frame function, should be only responsible for drawing, and simple branching logic
+            DrawFrame(elapedTime.count());
+
+        if (inputPlayer != nullptr)
+            replayFrameHashes.push_back(graphics->GetFrameHash());
 
         // Draw frame onto the screen and prepare for next frame
         graphics->EndFrame();
 
+        frameHeapAllocations = HeapAllocationCounter::GetFrameAllocations();
+
         // Get time that has passed since the beggining of the loop
         end = std::chrono::system_clock::now();
+
+        if (inputPlayer != nullptr)
+        {
+            replayFrameTimes.push_back(std::chrono::duration<float>(end - beginning).count());
+
+            // Every recorded frame was played
+            if (inputPlayer->IsFinished() == true)
+                break;
+        };
+    };
+
+
+    if (inputRecorder != nullptr)
+    {
+        window->SetInputRecorder(nullptr);
+        inputRecorder->SaveToFile(launchOptions.RecordFile);
+    };
+
+    if (inputPlayer != nullptr)
+    {
+        window->SetInputPlayer(nullptr);
+        WriteReplayResults(launchOptions.ResultsFile, replayFrameTimes, replayFrameHashes);
     };
 
 